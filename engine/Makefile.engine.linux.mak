@@ -8,7 +8,7 @@ COMPILER_FLAGS := -g -fdeclspec -fPIC
 STB := engine/vendor/stb_image
 
 INCLUDE_FLAGS := -Iengine/src -I$(STB)
-LINKER_FLAGS := -g -shared -lxcb -lX11 -lX11-xcb -lxkbcommon -L/usr/X11R6/lib -lGL -lGLEW -lm
+LINKER_FLAGS := -g -shared -lxcb -lX11 -lX11-xcb -lxkbcommon -L/usr/X11R6/lib -lGL -lGLEW -lm -lpthread
 DEFINES := -D_DEBUG -DHEXPORT
 
 SRC_FILES := $(shell find $(ASSEMBLY) -name *.c)
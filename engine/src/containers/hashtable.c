@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
 #include "hashtable.h"
 
 #include "memory/hmemory.h"
@@ -20,25 +22,38 @@ u64 hash_name(const char* name, u32 element_count)
     return hash;
 }
 
-void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable)
+static b8 setup_table(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable)
 {
     if (!memory || !out_hashtable)
     {
         HERROR("hashtable_create failed! Pointer to memory and out_hashtable are required.");
-        return;
+        return FALSE;
     }
 
     if (!element_count || !element_size)
     {
         HERROR("element_size and element_count must be a positive non-zero value.");
-        return;
+        return FALSE;
     }
 
     out_hashtable->memory = memory;
     out_hashtable->element_count = element_count;
     out_hashtable->element_size = element_size;
     out_hashtable->is_pointer_type = is_pointer_type;
-    hzero_memory(out_hashtable->memory, element_count * element_size);
+    return TRUE;
+}
+
+void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable)
+{
+    if (setup_table(element_size, element_count, memory, is_pointer_type, out_hashtable))
+    {
+        hzero_memory(out_hashtable->memory, element_count * element_size);
+    }
+}
+
+void hashtable_create_zeroed(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable)
+{
+    setup_table(element_size, element_count, memory, is_pointer_type, out_hashtable);
 }
 
 void hashtable_destroy(hashtable* table)
@@ -12,6 +12,10 @@ typedef struct hashtable
 
 HAPI void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable);
 
+// Same as hashtable_create for memory the caller knows is already zeroed, such as a fresh hallocate block.
+// Skips clearing it, so large tables do not touch every page up front.
+HAPI void hashtable_create_zeroed(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable);
+
 HAPI void hashtable_destroy(hashtable* hashtable);
 
 HAPI b8 hashtable_set(hashtable* hashtable, const char* name, void* value);
@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
 #include "containers/list.h"
 
 #include "memory/hmemory.h"
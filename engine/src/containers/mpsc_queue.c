@@ -0,0 +1,113 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "mpsc_queue.h"
+
+#include "core/atomic.h"
+#include "core/logger.h"
+
+#include "memory/hmemory.h"
+
+HINLINE u64 cell_size_for(u64 element_size)
+{
+    return sizeof(u64) + ((element_size + 7) & ~7ull);
+}
+
+HINLINE u8* cell_at(mpsc_queue* queue, u64 position)
+{
+    return (u8*)queue->memory + (position & queue->mask) * queue->cell_size;
+}
+
+u64 mpsc_queue_memory_requirement(u64 element_size, u32 capacity)
+{
+    return cell_size_for(element_size) * capacity;
+}
+
+b8 mpsc_queue_create(u64 element_size, u32 capacity, void* memory, mpsc_queue* out_queue)
+{
+    if (!memory || !out_queue)
+    {
+        HERROR("mpsc_queue_create failed! Pointer to memory and out_queue are required.");
+        return FALSE;
+    }
+
+    if (!element_size || capacity < 2 || (capacity & (capacity - 1)) != 0)
+    {
+        HERROR("mpsc_queue_create requires a non-zero element_size and a power of two capacity.");
+        return FALSE;
+    }
+
+    hzero_memory(out_queue, sizeof(mpsc_queue));
+    out_queue->element_size = element_size;
+    out_queue->cell_size = cell_size_for(element_size);
+    out_queue->mask = capacity - 1;
+    out_queue->memory = memory;
+
+    for (u64 i = 0; i < capacity; ++i)
+    {
+        *(u64*)cell_at(out_queue, i) = i;
+    }
+
+    return TRUE;
+}
+
+void mpsc_queue_destroy(mpsc_queue* queue)
+{
+    if (queue)
+    {
+        hzero_memory(queue, sizeof(mpsc_queue));
+    }
+}
+
+b8 mpsc_queue_push(mpsc_queue* queue, const void* value)
+{
+    u64 position = atomic_load_u64(&queue->enqueue_position);
+    u8* cell;
+
+    for (;;)
+    {
+        cell = cell_at(queue, position);
+        i64 difference = (i64)atomic_load_u64((volatile u64*)cell) - (i64)position;
+
+        if (difference == 0)
+        {
+            // The cell is free for this position, claim it.
+            if (atomic_compare_exchange_u64(&queue->enqueue_position, &position, position + 1))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The consumer has not caught up with this cell yet.
+            return FALSE;
+        }
+        else
+        {
+            position = atomic_load_u64(&queue->enqueue_position);
+        }
+    }
+
+    hcopy_memory(cell + sizeof(u64), value, queue->element_size);
+    atomic_store_u64((volatile u64*)cell, position + 1);
+
+    return TRUE;
+}
+
+b8 mpsc_queue_pop(mpsc_queue* queue, void* out_value)
+{
+    u64 position = queue->dequeue_position;
+    u8* cell = cell_at(queue, position);
+
+    if ((i64)atomic_load_u64((volatile u64*)cell) - (i64)(position + 1) < 0)
+    {
+        return FALSE;
+    }
+
+    hcopy_memory(out_value, cell + sizeof(u64), queue->element_size);
+
+    // Hand the cell back to producers one lap ahead.
+    atomic_store_u64((volatile u64*)cell, position + queue->mask + 1);
+    queue->dequeue_position = position + 1;
+
+    return TRUE;
+}
\ No newline at end of file
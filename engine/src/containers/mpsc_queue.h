@@ -0,0 +1,54 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Bounded lock-free queue, any number of producer threads and a single consumer thread.
+Each cell carries a sequence number telling producers and the consumer whose turn it is,
+so pushing never blocks and a full queue is reported instead of growing.
+
+Cell layout
+u64 sequence
+u8 element[element_size], padded to 8 bytes
+*/
+
+typedef struct mpsc_queue
+{
+    u64 element_size;
+    u64 cell_size;
+    u64 mask;
+    void* memory;
+
+    // Producers and the consumer live on separate cache lines.
+    u8 padding0[64];
+    volatile u64 enqueue_position;
+    u8 padding1[64];
+    u64 dequeue_position;
+} mpsc_queue;
+
+/**
+ * @brief Gets the size of the memory a queue needs.
+ * 
+ * @param element_size the size of each element in bytes.
+ * @param capacity the maximum number of queued elements, must be a power of two.
+ * @return u64 the required memory size in bytes.
+*/
+HAPI u64 mpsc_queue_memory_requirement(u64 element_size, u32 capacity);
+
+HAPI b8 mpsc_queue_create(u64 element_size, u32 capacity, void* memory, mpsc_queue* out_queue);
+
+HAPI void mpsc_queue_destroy(mpsc_queue* queue);
+
+/**
+ * @brief Copies an element into the queue. Safe to call from any thread.
+ * 
+ * @return b8 FALSE if the queue is full.
+*/
+HAPI b8 mpsc_queue_push(mpsc_queue* queue, const void* value);
+
+/**
+ * @brief Copies the oldest element out of the queue. Only one thread may pop.
+ * 
+ * @return b8 FALSE if the queue is empty.
+*/
+HAPI b8 mpsc_queue_pop(mpsc_queue* queue, void* out_value);
\ No newline at end of file
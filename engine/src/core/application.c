@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
 #include "application.h"
 #include "program_types.h"
 
@@ -5,8 +7,13 @@
 
 #include "core/logger.h"
 #include "core/event.h"
+#include "core/event_trace.h"
 #include "core/input.h"
 #include "core/clock.h"
+#include "core/frame_pacer.h"
+#include "core/profiler.h"
+#include "core/frame_stats.h"
+#include "core/task_graph.h"
 #include "core/hstring.h"
 
 #include "memory/hmemory.h"
@@ -18,19 +25,46 @@
 #include "systems/material_system.h"
 #include "systems/geometry_system.h"
 #include "systems/resource_system.h"
+#include "systems/job_system.h"
 
 #include "math/hmath.h"
 
+// Subsystems timed during startup.
+#define STARTUP_MAX_STEPS 32
+
+typedef struct startup_step
+{
+    const char* name;
+    u64 start_ns;
+    u64 end_ns;
+} startup_step;
+
+// Configurations of the subsystems initialized by the startup task graph.
+typedef struct startup_configs
+{
+    frame_stats_config frame_stats;
+    resource_system_config resource_system;
+    texture_system_config texture_system;
+    material_system_config material_system;
+    geometry_system_config geometry_system;
+} startup_configs;
+
 typedef struct application_state
 {
     b8 is_running;
     b8 is_suspended;
+    b8 is_focused;
 
     i16 width;
     i16 height;
 
     clock clock;
-    f64 last_time;
+    u64 last_time_ns;
+
+    frame_pacer pacer;
+
+    // Simulation time not yet consumed by fixed updates.
+    f64 update_accumulator;
 
     program* program_inst;
 
@@ -45,12 +79,20 @@ typedef struct application_state
     //u64 event_subsystem_memory_requirement;
     void* event_subsystem_state;
 
+    void* event_trace_state;
+
+    void* profiler_state;
+
+    void* frame_stats_state;
+
     //u64 memory_subsystem_memory_requirement;
     void* memory_subsystem_state;
 
     //u64 platform_subsystem_memory_requirement;
     void* platform_subsystem_state;
 
+    void* job_system_state;
+
     //u64 resource_system_memory_requirement;
     void* resource_system_state;
 
@@ -67,13 +109,50 @@ typedef struct application_state
     void* geometry_system_state;
 
     geometry* test_geometry;
+
+    task_graph frame_graph;
+    // Inputs and outputs of the frame tasks.
+    f64 frame_delta;
+    f64 frame_interpolation_alpha;
+
+    u64 startup_start_ns;
+    u32 startup_step_count;
+    startup_step startup_steps[STARTUP_MAX_STEPS];
+    b8 first_frame_reported;
 } application_state;
 
+// Upper bound on a blocking wait while minimized.
+#define SUSPENDED_WAIT_SECONDS 0.1
+
 static application_state* app_state;
 
 b8 application_on_quit(u16 code, void* sender, void* listener_inst, event_context context);
 b8 application_on_key(u16 code, void* sender, void* listener_inst, event_context context);
 b8 application_on_resized(u16 code, void* sender, void* listener_inst, event_context context);
+b8 application_on_focus_changed(u16 code, void* sender, void* listener_inst, event_context context);
+
+static b8 application_update_task(void* data);
+static b8 application_render_task(void* data);
+static b8 application_draw_task(void* data);
+
+static b8 startup_event_trace_task(void* data);
+static b8 startup_frame_stats_task(void* data);
+static b8 startup_resource_system_task(void* data);
+static b8 startup_renderer_task(void* data);
+static b8 startup_texture_system_task(void* data);
+static b8 startup_material_system_task(void* data);
+static b8 startup_geometry_system_task(void* data);
+
+static void startup_record(const char* name, u64 start_ns, u64 end_ns)
+{
+    if (app_state->startup_step_count < STARTUP_MAX_STEPS)
+    {
+        startup_step* step = &app_state->startup_steps[app_state->startup_step_count++];
+        step->name = name;
+        step->start_ns = start_ns;
+        step->end_ns = end_ns;
+    }
+}
 
 // TODO: Temporary.
 b8 event_on_debug_event(u16 code, void* sender, void* listener_inst, event_context data)
@@ -116,8 +195,11 @@ b8 application_initialize(program* program_inst)
         return FALSE;
     }
 
+    u64 startup_start_ns = platform_get_ticks_ns();
+
     program_inst->application_state = hallocate(sizeof(application_state), MEMORY_TAG_APPLICATION);
     app_state = program_inst->application_state;
+    app_state->startup_start_ns = startup_start_ns;
     app_state->program_inst = program_inst;
     app_state->is_running = FALSE;
     app_state->is_suspended = FALSE;
@@ -127,6 +209,7 @@ b8 application_initialize(program* program_inst)
     linear_allocator_create(systems_allocator_total_size, 0, &app_state->systems_allocator);
 
     // Initialize memory.
+    u64 step_start_ns = platform_get_ticks_ns();
     u64 memory_memory_requirement;
     memory_initialize(&memory_memory_requirement, 0);
     app_state->memory_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, memory_memory_requirement);
@@ -135,8 +218,10 @@ b8 application_initialize(program* program_inst)
         HERROR("Failed to initialize memory subsystem. Shutting down.");
         return FALSE;
     }
+    startup_record("memory", step_start_ns, platform_get_ticks_ns());
 
     // Initialize logger.
+    step_start_ns = platform_get_ticks_ns();
     u64 logger_memory_requirement;
     logger_initialize(&logger_memory_requirement, 0);
     app_state->logger_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, logger_memory_requirement);
@@ -146,7 +231,14 @@ b8 application_initialize(program* program_inst)
         return FALSE;
     }
 
+    if (program_inst->app_config.binary_logging)
+    {
+        logger_set_binary_mode(TRUE);
+    }
+    startup_record("logger", step_start_ns, platform_get_ticks_ns());
+
     // Initialize input.
+    step_start_ns = platform_get_ticks_ns();
     u64 input_memory_requirement;
     input_initialize(&input_memory_requirement, 0);
     app_state->input_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, input_memory_requirement);
@@ -155,8 +247,10 @@ b8 application_initialize(program* program_inst)
         HERROR("Failed to initialize input subsystem. Shutting down.");
         return FALSE;
     }
+    startup_record("input", step_start_ns, platform_get_ticks_ns());
 
     // Initialize event.
+    step_start_ns = platform_get_ticks_ns();
     u64 event_memory_requirement;
     event_initialize(&event_memory_requirement, 0);
     app_state->event_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, event_memory_requirement);
@@ -165,10 +259,24 @@ b8 application_initialize(program* program_inst)
         HERROR("Failed to initialize event subsystem. Shutting down.");
         return FALSE;
     }
+    startup_record("event", step_start_ns, platform_get_ticks_ns());
+
+    // Initialize profiler.
+    step_start_ns = platform_get_ticks_ns();
+    u64 profiler_memory_requirement;
+    profiler_initialize(&profiler_memory_requirement, 0);
+    app_state->profiler_state = linear_allocator_allocate(&app_state->systems_allocator, profiler_memory_requirement);
+    if (!profiler_initialize(&profiler_memory_requirement, app_state->profiler_state))
+    {
+        HERROR("Failed to initialize profiler. Shutting down.");
+        return FALSE;
+    }
+    startup_record("profiler", step_start_ns, platform_get_ticks_ns());
 
     // Initialize platform.
+    step_start_ns = platform_get_ticks_ns();
     u64 platform_memory_requirement;
-    platform_initialize(&platform_memory_requirement, 0, 0, 0, 0, 0, 0);
+    platform_initialize(&platform_memory_requirement, 0, 0, 0, 0, 0, 0, FALSE);
     app_state->platform_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, platform_memory_requirement);
     if (!platform_initialize(
         &platform_memory_requirement,
@@ -177,71 +285,103 @@ b8 application_initialize(program* program_inst)
         program_inst->app_config.start_x,
         program_inst->app_config.start_y,
         program_inst->app_config.start_width,
-        program_inst->app_config.start_height))
+        program_inst->app_config.start_height,
+        program_inst->app_config.headless))
     {
         HERROR("Failed to initialize platform. Shutting down.");
         return FALSE;
     }
-
-    // Initialize resource system.
-    u64 resource_system_memory_requirement;
-    resource_system_config resource_system_config;
-    resource_system_config.asset_base_path = "../assets";
-    resource_system_config.max_loader_count = 32;
-    resource_system_initialize(&resource_system_memory_requirement, 0, resource_system_config);
-    app_state->resource_system_state = linear_allocator_allocate(&app_state->systems_allocator, resource_system_memory_requirement);
-    if (!resource_system_initialize(&resource_system_memory_requirement, app_state->resource_system_state, resource_system_config))
+    startup_record("platform", step_start_ns, platform_get_ticks_ns());
+
+    // Initialize job system.
+    step_start_ns = platform_get_ticks_ns();
+    u64 job_system_memory_requirement;
+    job_system_config job_config;
+    job_config.worker_count = program_inst->app_config.job_worker_count;
+    job_system_initialize(&job_system_memory_requirement, 0, job_config);
+    app_state->job_system_state = linear_allocator_allocate(&app_state->systems_allocator, job_system_memory_requirement);
+    if (!job_system_initialize(&job_system_memory_requirement, app_state->job_system_state, job_config))
     {
-        HFATAL("Failed to initialize resource system. Shutting down.");
+        HERROR("Failed to initialize job system. Shutting down.");
         return FALSE;
     }
 
-    // Initialize renderer.
-    u64 renderer_memory_requirement;
-    renderer_initialize(&renderer_memory_requirement, 0, 0);
-    app_state->renderer_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, renderer_memory_requirement);
-    if (!renderer_initialize(&renderer_memory_requirement, app_state->renderer_subsystem_state, app_state->program_inst->app_config.name))
+    startup_record("job_system", step_start_ns, platform_get_ticks_ns());
+
+    // The remaining subsystems run as a task graph. Event trace and frame stats initialize on workers
+    // alongside the resource system's pack and manifest mounting. From the renderer on it is a main
+    // thread chain: shaders load through the resource system and the defaults upload through the
+    // renderer. Memory is reserved up front since the allocator is not thread safe, and comes zeroed
+    // from the systems allocator, which the texture and material tables rely on.
+    startup_configs configs = {};
+    configs.frame_stats.log_interval = program_inst->app_config.frame_stats_log_interval;
+    configs.frame_stats.csv_path = program_inst->app_config.frame_stats_csv_path;
+    configs.resource_system.asset_base_path = "../assets";
+    configs.resource_system.max_loader_count = 32;
+    configs.resource_system.max_async_request_count = 256;
+    configs.resource_system.pack_path = "../assets.hpak";
+    configs.resource_system.io_queue_depth = 64;
+    configs.resource_system.cook_manifest_path = "../cooked/manifest.hcm";
+    configs.texture_system.max_texture_count = 65536;
+    configs.material_system.max_material_count = 4096;
+    configs.geometry_system.max_geometry_count = 4096;
+
+    u64 memory_requirement;
+    event_trace_initialize(&memory_requirement, 0);
+    app_state->event_trace_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    frame_stats_initialize(&memory_requirement, 0, &configs.frame_stats);
+    app_state->frame_stats_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    resource_system_initialize(&memory_requirement, 0, configs.resource_system);
+    app_state->resource_system_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    renderer_initialize(&memory_requirement, 0, 0, 0, FALSE);
+    app_state->renderer_subsystem_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    texture_system_initialize(&memory_requirement, 0, configs.texture_system);
+    app_state->texture_system_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    material_system_initialize(&memory_requirement, 0, configs.material_system);
+    app_state->material_system_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+    geometry_system_initialize(&memory_requirement, 0, configs.geometry_system);
+    app_state->geometry_system_state = linear_allocator_allocate(&app_state->systems_allocator, memory_requirement);
+
+    task_graph startup_graph;
+    if (!task_graph_create(&startup_graph))
     {
-        HFATAL("Failed to initialize renderer. Shutting down.");
+        HFATAL("Failed to create the startup task graph. Shutting down.");
         return FALSE;
     }
 
-    // Initialize texture system.
-    u64 texture_system_memory_requirement;
-    texture_system_config texture_system_config;
-    texture_system_config.max_texture_count = 65536;
-    texture_system_initialize(&texture_system_memory_requirement, 0, texture_system_config);
-    app_state->texture_system_state = linear_allocator_allocate(&app_state->systems_allocator, texture_system_memory_requirement);
-    if (!texture_system_initialize(&texture_system_memory_requirement, app_state->texture_system_state, texture_system_config))
+    task_desc startup_tasks[] =
     {
-        HFATAL("Failed to initialize texture system. Shutting down.");
-        return FALSE;
+        {"event_trace", startup_event_trace_task, &configs, 0, 0, FALSE},
+        {"frame_stats", startup_frame_stats_task, &configs, 0, 0, FALSE},
+        {"resource_system", startup_resource_system_task, &configs, 0, TASK_RESOURCE_ASSETS, FALSE},
+        // Creates the graphics context, which starts out bound to the creating thread.
+        {"renderer", startup_renderer_task, &configs, TASK_RESOURCE_ASSETS, TASK_RESOURCE_RENDERER, TRUE},
+        // The default texture, material and geometry are uploaded through the renderer.
+        {"texture_system", startup_texture_system_task, &configs, TASK_RESOURCE_ASSETS | TASK_RESOURCE_RENDERER, TASK_RESOURCE_TEXTURES, TRUE},
+        {"material_system", startup_material_system_task, &configs, TASK_RESOURCE_ASSETS | TASK_RESOURCE_RENDERER | TASK_RESOURCE_TEXTURES, TASK_RESOURCE_MATERIALS, TRUE},
+        {"geometry_system", startup_geometry_system_task, &configs, TASK_RESOURCE_RENDERER | TASK_RESOURCE_MATERIALS, TASK_RESOURCE_GEOMETRY, TRUE}
+    };
+    for (u32 i = 0; i < sizeof(startup_tasks) / sizeof(startup_tasks[0]); ++i)
+    {
+        task_graph_add(&startup_graph, &startup_tasks[i]);
     }
 
-    // Initialize material system.
-    u64 material_system_memory_requirement;
-    material_system_config material_system_config;
-    material_system_config.max_material_count = 4096;
-    material_system_initialize(&material_system_memory_requirement, 0, material_system_config);
-    app_state->material_system_state = linear_allocator_allocate(&app_state->systems_allocator, material_system_memory_requirement);
-    if (!material_system_initialize(&material_system_memory_requirement, app_state->material_system_state, material_system_config))
+    // The failing task has already logged why.
+    b8 started = task_graph_execute(&startup_graph);
+    for (u32 i = 0; i < startup_graph.task_count; ++i)
     {
-        HFATAL("Failed to initialize material system. Shutting down.");
-        return FALSE;
+        const task_node* node = &startup_graph.tasks[i];
+        startup_record(node->desc.name, node->last_start_ns, node->last_end_ns);
     }
+    task_graph_destroy(&startup_graph);
 
-    // Initialize geometry system
-    u64 geometry_system_memory_requirement;
-    geometry_system_config geometry_system_config;
-    geometry_system_config.max_geometry_count = 4096;
-    geometry_system_initialize(&geometry_system_memory_requirement, 0, geometry_system_config);
-    app_state->geometry_system_state = linear_allocator_allocate(&app_state->systems_allocator, geometry_system_memory_requirement);
-    if (!geometry_system_initialize(&geometry_system_memory_requirement, app_state->geometry_system_state, geometry_system_config))
+    if (!started)
     {
-        HFATAL("Failed to initialize geometry system. Shutting down.");
         return FALSE;
     }
 
+    u64 program_start_ns = platform_get_ticks_ns();
+
     // TODO: Temporary.
 
     geometry_config g_config = geometry_system_generate_plane_config(10.0f, 10.0f, 5, 5, 2.0f, 2.0f, "test geometry", "test_material");
@@ -253,6 +393,29 @@ b8 application_initialize(program* program_inst)
     //app_state->test_geometry = geometry_system_get_default();
     // TODO: End temporary.
 
+    if (!task_graph_create(&app_state->frame_graph))
+    {
+        HFATAL("Failed to create the frame task graph. Shutting down.");
+        return FALSE;
+    }
+
+    task_desc update_task = {};
+    update_task.name = "update";
+    update_task.entry = application_update_task;
+    update_task.reads = TASK_RESOURCE_EVENTS;
+    update_task.writes = TASK_RESOURCE_PROGRAM | TASK_RESOURCE_INPUT;
+    // Program callbacks assume the main thread.
+    update_task.main_thread = TRUE;
+    task_graph_add(&app_state->frame_graph, &update_task);
+
+    task_desc render_task = {};
+    render_task.name = "program_render";
+    render_task.entry = application_render_task;
+    render_task.reads = TASK_RESOURCE_PROGRAM;
+    render_task.writes = TASK_RESOURCE_RENDER_PACKET;
+    render_task.main_thread = TRUE;
+    task_graph_add(&app_state->frame_graph, &render_task);
+
     // Initialize client program.
     if (!app_state->program_inst->initialize(app_state->program_inst))
     {
@@ -260,102 +423,404 @@ b8 application_initialize(program* program_inst)
         return FALSE;
     }
 
+    // After the program's tasks, so that anything they write for the frame is drawn.
+    task_desc draw_task = {};
+    draw_task.name = "draw_frame";
+    draw_task.entry = application_draw_task;
+    draw_task.reads = TASK_RESOURCE_RENDER_PACKET | TASK_RESOURCE_GEOMETRY | TASK_RESOURCE_MATERIALS | TASK_RESOURCE_TEXTURES;
+    draw_task.writes = TASK_RESOURCE_RENDERER | TASK_RESOURCE_INPUT;
+    // Owns the GL context.
+    draw_task.main_thread = TRUE;
+    task_graph_add(&app_state->frame_graph, &draw_task);
+
     event_register(EVENT_APPLICATION_QUIT, 0, application_on_quit);
     event_register(EVENT_KEY_PRESSED, 0, application_on_key);
     event_register(EVENT_RESIZED, 0, application_on_resized);
+    event_register(EVENT_FOCUS_CHANGED, 0, application_on_focus_changed);
     // TODO: Temporary.
     event_register(EVENT_DEBUG0, 0, event_on_debug_event);
     // TODO: End temporary.
 
     app_state->program_inst->on_resize(app_state->program_inst, app_state->width, app_state->height);
 
+    startup_record("program", program_start_ns, platform_get_ticks_ns());
+
+    u64 startup_end_ns = platform_get_ticks_ns();
+    HINFO("Startup took %.3fms:", (startup_end_ns - app_state->startup_start_ns) * 0.000001);
+    for (u32 i = 0; i < app_state->startup_step_count; ++i)
+    {
+        const startup_step* step = &app_state->startup_steps[i];
+        HINFO("  %-16s start %8.3fms  duration %8.3fms", step->name,
+            (step->start_ns - app_state->startup_start_ns) * 0.000001, (step->end_ns - step->start_ns) * 0.000001);
+    }
+
     return TRUE;
 }
 
+static b8 startup_event_trace_task(void* data)
+{
+    u64 memory_requirement;
+    if (!event_trace_initialize(&memory_requirement, app_state->event_trace_state))
+    {
+        HERROR("Failed to initialize event trace. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_frame_stats_task(void* data)
+{
+    startup_configs* configs = data;
+    u64 memory_requirement;
+    if (!frame_stats_initialize(&memory_requirement, app_state->frame_stats_state, &configs->frame_stats))
+    {
+        HERROR("Failed to initialize frame statistics. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_resource_system_task(void* data)
+{
+    startup_configs* configs = data;
+    u64 memory_requirement;
+    if (!resource_system_initialize(&memory_requirement, app_state->resource_system_state, configs->resource_system))
+    {
+        HFATAL("Failed to initialize resource system. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_renderer_task(void* data)
+{
+    application_config* config = &app_state->program_inst->app_config;
+    renderer_backend_type backend_type = config->headless ? RENDERER_BACKEND_NULL : RENDERER_BACKEND_OPENGL;
+    u64 memory_requirement;
+    if (!renderer_initialize(&memory_requirement, app_state->renderer_subsystem_state, config->name, backend_type, config->render_thread))
+    {
+        HFATAL("Failed to initialize renderer. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_texture_system_task(void* data)
+{
+    startup_configs* configs = data;
+    u64 memory_requirement;
+    if (!texture_system_initialize(&memory_requirement, app_state->texture_system_state, configs->texture_system))
+    {
+        HFATAL("Failed to initialize texture system. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_material_system_task(void* data)
+{
+    startup_configs* configs = data;
+    u64 memory_requirement;
+    if (!material_system_initialize(&memory_requirement, app_state->material_system_state, configs->material_system))
+    {
+        HFATAL("Failed to initialize material system. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static b8 startup_geometry_system_task(void* data)
+{
+    startup_configs* configs = data;
+    u64 memory_requirement;
+    if (!geometry_system_initialize(&memory_requirement, app_state->geometry_system_state, configs->geometry_system))
+    {
+        HFATAL("Failed to initialize geometry system. Shutting down.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Runs the program's update for this frame. Input edges are consumed by the first update that sees them.
+static b8 application_update(f64 delta, f64* out_interpolation_alpha)
+{
+    PROFILE_FUNCTION();
+
+    program* program_inst = app_state->program_inst;
+    u32 update_rate = program_inst->app_config.fixed_update_rate;
+
+    if (update_rate == 0)
+    {
+        *out_interpolation_alpha = 1.0;
+
+        if (!program_inst->update(program_inst, (f32)delta))
+        {
+            return FALSE;
+        }
+
+        input_update(delta);
+        return TRUE;
+    }
+
+    f64 step = 1.0 / update_rate;
+    u32 max_updates = program_inst->app_config.max_updates_per_frame ? program_inst->app_config.max_updates_per_frame : 5;
+
+    app_state->update_accumulator += delta;
+
+    u32 update_count = 0;
+    while (app_state->update_accumulator >= step)
+    {
+        if (update_count == max_updates)
+        {
+            // Catching up would only make the next frame slower. Drop whole steps, keep the remainder for interpolation.
+            u32 dropped_steps = (u32)(app_state->update_accumulator / step);
+            HDEBUG_LIMITED("Simulation fell behind, dropping %u fixed updates.", dropped_steps);
+            app_state->update_accumulator -= dropped_steps * step;
+            break;
+        }
+
+        if (!program_inst->update(program_inst, (f32)step))
+        {
+            return FALSE;
+        }
+
+        input_update(step);
+
+        app_state->update_accumulator -= step;
+        update_count++;
+    }
+
+    *out_interpolation_alpha = app_state->update_accumulator / step;
+
+    return TRUE;
+}
+
+static b8 application_update_task(void* data)
+{
+    u64 update_start_ns = platform_get_ticks_ns();
+    b8 result = application_update(app_state->frame_delta, &app_state->frame_interpolation_alpha);
+    frame_stats_add_phase_time(FRAME_PHASE_UPDATE, (platform_get_ticks_ns() - update_start_ns) * 0.000000001);
+
+    if (!result)
+    {
+        HFATAL("Program update failed, shutting down.");
+    }
+    return result;
+}
+
+static b8 application_render_task(void* data)
+{
+    u64 render_start_ns = platform_get_ticks_ns();
+    b8 result = app_state->program_inst->render(app_state->program_inst, (f32)app_state->frame_delta, (f32)app_state->frame_interpolation_alpha);
+    frame_stats_add_phase_time(FRAME_PHASE_RENDER, (platform_get_ticks_ns() - render_start_ns) * 0.000000001);
+
+    if (!result)
+    {
+        HFATAL("Program render failed, shutting down.");
+    }
+    return result;
+}
+
+static b8 application_draw_task(void* data)
+{
+    render_packet packet;
+    packet.delta_time = app_state->frame_delta;
+
+    geometry_render_data test_render;
+    test_render.geometry = app_state->test_geometry;
+    test_render.model = mat4_identity();
+
+    packet.geometry_count = 1;
+    packet.geometries = &test_render;
+
+    renderer_draw_frame(&packet);
+    input_frame_submitted(platform_get_ticks_ns());
+
+    return TRUE;
+}
+
+u32 application_add_frame_task(const task_desc* desc)
+{
+    return task_graph_add(&app_state->frame_graph, desc);
+}
+
+const task_graph* application_get_frame_graph()
+{
+    return &app_state->frame_graph;
+}
+
 b8 application_run()
 {
     app_state->is_running = TRUE;
     app_state->is_suspended = FALSE;
+    app_state->is_focused = TRUE;
 
     HINFO(get_memory_usage_str());
 
     clock_start(&app_state->clock);
     clock_update(&app_state->clock);
 
-    app_state->last_time = app_state->clock.elapsed;
+    app_state->last_time_ns = app_state->clock.elapsed_ns;
 
-    f64 running_time = 0;
-    f64 frame_count = 0;
-    f64 target_frame_seconds = 1.0f / 60;
+    frame_pacer_create(app_state->program_inst->app_config.target_frame_rate, &app_state->pacer);
+
+    // Recording starts here so that a replay begins from the same initialized state.
+    if (app_state->program_inst->app_config.event_trace_replay_path)
+    {
+        event_trace_start_replay(app_state->program_inst->app_config.event_trace_replay_path);
+    }
+    else if (app_state->program_inst->app_config.event_trace_record_path)
+    {
+        event_trace_start_recording(app_state->program_inst->app_config.event_trace_record_path, app_state->program_inst);
+    }
+
+    u64 frame_number = 0;
+    u32 benchmark_frames = app_state->program_inst->app_config.benchmark_frames;
+    u64 run_start_ns = platform_get_ticks_ns();
 
     while (app_state->is_running)
     {
-        if (!platform_pump_messages(&app_state->platform_subsystem_state))
+        f64 replay_delta = 0;
+        if (event_trace_is_replaying())
         {
-            app_state->is_running = FALSE;
+            if (!event_trace_replay_frame(&replay_delta))
+            {
+                HINFO("Event trace replay finished.");
+                app_state->is_running = FALSE;
+                break;
+            }
         }
-
-        if (!app_state->is_suspended)
+        else
         {
-            clock_update(&app_state->clock);
-            f64 current_time = app_state->clock.elapsed;
-            f64 delta = current_time - app_state->last_time;
-            f64 frame_start_time = platform_get_absolute_time();
+            PROFILE_SCOPE("platform_events");
 
-            if (!app_state->program_inst->update(app_state->program_inst, (f32)delta))
+            if (app_state->is_suspended)
             {
-                HFATAL("Program update failed, shutting down.");
-                app_state->is_running = FALSE;
-                break;
+                // Nothing is drawn while minimized, so sleep until the window system has something for us.
+                // The timeout keeps events posted from other threads flowing.
+                platform_wait_for_events(SUSPENDED_WAIT_SECONDS);
             }
 
-            if (!app_state->program_inst->render(app_state->program_inst, (f32)delta))
+            if (!platform_pump_messages(&app_state->platform_subsystem_state))
             {
-                HFATAL("Program render failed, shutting down.");
                 app_state->is_running = FALSE;
-                break;
             }
+        }
 
-            render_packet packet;
-            packet.delta_time = delta;
+        PROFILE_BEGIN(dispatch_zone, "event_dispatch");
+        event_dispatch();
+        PROFILE_END(dispatch_zone);
 
-            geometry_render_data test_render;
-            test_render.geometry = app_state->test_geometry;
-            test_render.model = mat4_identity();
+        // Resources loaded in the background are handed over before the frame's tasks see them.
+        resource_system_dispatch_completed();
 
-            packet.geometry_count = 1;
-            packet.geometries = &test_render;
+        f64 recorded_delta = 0;
 
-            renderer_draw_frame(&packet);
+        if (!app_state->is_suspended)
+        {
+            clock_update(&app_state->clock);
+            u64 current_time_ns = app_state->clock.elapsed_ns;
+            f64 delta = event_trace_is_replaying() ? replay_delta : (current_time_ns - app_state->last_time_ns) * 0.000000001;
+            u64 frame_start_ns = platform_get_ticks_ns();
+            recorded_delta = delta;
 
-            f64 frame_end_time = platform_get_absolute_time();
-            f64 frame_elapsed_time = frame_end_time - frame_start_time;
-            running_time += frame_elapsed_time;
-            f64 remaining_seconds = target_frame_seconds - frame_elapsed_time;
+            app_state->frame_delta = delta;
+            app_state->frame_interpolation_alpha = 1.0;
 
-            if (remaining_seconds > 0)
+            // The failing task has already logged why.
+            if (!task_graph_execute(&app_state->frame_graph))
             {
-                u64 remaining_ms = remaining_seconds * 1000;
+                app_state->is_running = FALSE;
+                break;
+            }
 
-                b8 limit_frames = FALSE;
-                if (remaining_ms > 0 && limit_frames)
+            f64 frame_elapsed_time = (platform_get_ticks_ns() - frame_start_ns) * 0.000000001;
+
+            if (!app_state->first_frame_reported)
+            {
+                app_state->first_frame_reported = TRUE;
+                HINFO("First frame finished %.3fms after startup began.", (platform_get_ticks_ns() - app_state->startup_start_ns) * 0.000001);
+            }
+            event_trace_replay_add_frame_time(frame_elapsed_time);
+            frame_stats_end_frame(frame_elapsed_time);
+
+            // Replays run as fast as possible, their deltas come from the trace.
+            if (!event_trace_is_replaying())
+            {
+                PROFILE_SCOPE("frame_wait");
+
+                u32 background_rate = app_state->program_inst->app_config.background_frame_rate;
+                if (!app_state->is_focused && background_rate)
                 {
-                    platform_sleep(remaining_ms - 1);
+                    // Wakes early only for focus, visibility or quit, pointer motion over the window waits for the next frame.
+                    f64 remaining = 1.0 / background_rate - (platform_get_ticks_ns() - frame_start_ns) * 0.000000001;
+                    if (remaining > 0)
+                    {
+                        platform_wait_for_focus_change(remaining);
+                    }
+                }
+                else
+                {
+                    frame_pacer_wait(&app_state->pacer);
                 }
-
-                frame_count++;
             }
 
-            input_update(delta);
+            app_state->last_time_ns = current_time_ns;
+        }
+
+        event_trace_record_frame(frame_number++, recorded_delta);
 
-            app_state->last_time = current_time;
+        if (benchmark_frames && frame_number >= benchmark_frames)
+        {
+            app_state->is_running = FALSE;
         }
+
+        PROFILE_FRAME_MARK();
     }
 
     app_state->is_running = FALSE;
 
+    if (benchmark_frames)
+    {
+        f64 run_seconds = (platform_get_ticks_ns() - run_start_ns) * 0.000000001;
+        HINFO("Benchmark: %llu frames in %.3fs, %.1f frames per second.", frame_number, run_seconds, run_seconds > 0 ? frame_number / run_seconds : 0.0);
+        frame_stats_log_summaries();
+    }
+
+    if (app_state->program_inst->app_config.target_frame_rate)
+    {
+        frame_pacer_stats pacer_stats;
+        frame_pacer_get_stats(&app_state->pacer, &pacer_stats);
+        HINFO("Frame pacing: %llu frames, %llu missed deadlines, jitter mean %.3fms p99 %.3fms max %.3fms.",
+            pacer_stats.frame_count, pacer_stats.missed_deadlines,
+            pacer_stats.mean_jitter * 1000.0, pacer_stats.p99_jitter * 1000.0, pacer_stats.max_jitter * 1000.0);
+    }
+
+    if (app_state->program_inst->app_config.task_graph_export_path)
+    {
+        task_graph_export_dot(&app_state->frame_graph, app_state->program_inst->app_config.task_graph_export_path);
+    }
+    task_graph_destroy(&app_state->frame_graph);
+
+    // Workers and the render thread may still log or profile, so stop them first. Pending loads are
+    // cancelled before that, their jobs would be dropped with the queue.
+    renderer_flush();
+    resource_system_cancel_all();
+    job_system_shutdown(app_state->job_system_state);
+
+    event_trace_shutdown(app_state->event_trace_state);
+
+    if (app_state->program_inst->app_config.profile_export_path)
+    {
+        profiler_export_chrome_trace(app_state->program_inst->app_config.profile_export_path);
+    }
+    profiler_shutdown(app_state->profiler_state);
+    frame_stats_shutdown(app_state->frame_stats_state);
+
     event_unregister(EVENT_APPLICATION_QUIT, 0, application_on_quit);
     event_unregister(EVENT_KEY_PRESSED, 0, application_on_key);
+    event_unregister(EVENT_RESIZED, 0, application_on_resized);
+    event_unregister(EVENT_FOCUS_CHANGED, 0, application_on_focus_changed);
     // TODO: Temporary.
     event_unregister(EVENT_DEBUG0, 0, event_on_debug_event);
     // TODO: End Temporary.
@@ -431,11 +896,28 @@ b8 application_on_resized(u16 code, void* sender, void* listener_inst, event_con
         else
         {
             // Window is not minimized, resize program and renderer.
+            if (app_state->is_suspended)
+            {
+                // Time spent suspended should not reach the simulation as one huge step.
+                clock_update(&app_state->clock);
+                app_state->last_time_ns = app_state->clock.elapsed_ns;
+                HDEBUG("Window restored, resuming.");
+            }
             app_state->is_suspended = FALSE;
             app_state->program_inst->on_resize(app_state->program_inst, width, height);
             renderer_on_resized(width, height);
         }
     }
 
+    return FALSE;
+}
+
+b8 application_on_focus_changed(u16 code, void* sender, void* listener_inst, event_context context)
+{
+    if (code != EVENT_FOCUS_CHANGED) return FALSE;
+
+    app_state->is_focused = context.data.u8[0] != 0;
+    HDEBUG("Window %s focus.", app_state->is_focused ? "gained" : "lost");
+
     return FALSE;
 }
\ No newline at end of file
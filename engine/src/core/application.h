@@ -4,6 +4,8 @@
 
 // forward declared to avoid circular dependecy
 struct program;
+struct task_desc;
+struct task_graph;
 
 typedef struct application_config
 {
@@ -14,8 +16,60 @@ typedef struct application_config
     i16 start_height;
 
     char* name;
+
+    // Run without a window, using the null renderer backend. For machines without a display or GPU.
+    b8 headless;
+    // Stop after this many frames and report timings, 0 runs until quit.
+    u32 benchmark_frames;
+
+    // Replay recorded frames on a thread that owns the graphics context, one frame behind the main loop.
+    b8 render_thread;
+
+    // Job worker threads, 0 uses one per processor besides the main thread.
+    u32 job_worker_count;
+
+    // Record log messages as binary records (console.hlog) instead of formatting them.
+    b8 binary_logging;
+
+    // Simulation ticks per second for a fixed timestep, 0 updates once per frame with the frame's delta.
+    u32 fixed_update_rate;
+    // Most fixed updates run in one frame before simulation time is dropped, 0 uses a default.
+    u32 max_updates_per_frame;
+
+    // Frames per second the main loop is paced to, 0 runs uncapped.
+    u32 target_frame_rate;
+    // Frames per second while the window is unfocused, 0 keeps running at the target rate.
+    u32 background_frame_rate;
+
+    // Record every posted event and frame to this file, if set.
+    char* event_trace_record_path;
+    // Replay the platform input of a recorded trace instead of pumping messages, if set.
+    char* event_trace_replay_path;
+
+    // Write the most recent profiled frames as a Chrome trace to this file at shutdown, if set.
+    char* profile_export_path;
+
+    // Write the frame task graph with the last frame's timings as a Graphviz file at shutdown, if set.
+    char* task_graph_export_path;
+
+    // Log frame time statistics every this many seconds, 0 disables the log.
+    f64 frame_stats_log_interval;
+    // Write every frame's phase times to this CSV file, if set.
+    char* frame_stats_csv_path;
 } application_config;
 
 HAPI b8 application_initialize(struct program* program_inst);
 
-HAPI b8 application_run();
\ No newline at end of file
+HAPI b8 application_run();
+
+/**
+ * @brief Adds a task to the per-frame task graph. Tasks added from the program's initialize run
+ * after the program update and render and before the renderer draws the frame, unless their
+ * dependencies order them otherwise.
+ *
+ * @return the task index, or INVALID_ID if the graph is full.
+ */
+HAPI u32 application_add_frame_task(const struct task_desc* desc);
+
+// The frame task graph, with the timings of the last frame.
+HAPI const struct task_graph* application_get_frame_graph();
\ No newline at end of file
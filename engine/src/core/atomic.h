@@ -0,0 +1,87 @@
+#pragma once
+
+#include "defines.h"
+
+// Loads acquire and stores release; read-modify-write operations are sequentially consistent.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+HINLINE u32 atomic_load_u32(volatile u32* value) { u32 result = *value; _ReadWriteBarrier(); return result; }
+HINLINE u64 atomic_load_u64(volatile u64* value) { u64 result = *value; _ReadWriteBarrier(); return result; }
+
+HINLINE void atomic_store_u32(volatile u32* value, u32 desired) { _ReadWriteBarrier(); *value = desired; }
+HINLINE void atomic_store_u64(volatile u64* value, u64 desired) { _ReadWriteBarrier(); *value = desired; }
+
+HINLINE u32 atomic_fetch_add_u32(volatile u32* value, u32 amount) { return (u32)_InterlockedExchangeAdd((volatile long*)value, (long)amount); }
+HINLINE u64 atomic_fetch_add_u64(volatile u64* value, u64 amount) { return (u64)_InterlockedExchangeAdd64((volatile __int64*)value, (__int64)amount); }
+
+HINLINE u32 atomic_exchange_u32(volatile u32* value, u32 desired) { return (u32)_InterlockedExchange((volatile long*)value, (long)desired); }
+
+HINLINE b8 atomic_compare_exchange_u32(volatile u32* value, u32* expected, u32 desired)
+{
+    u32 previous = (u32)_InterlockedCompareExchange((volatile long*)value, (long)desired, (long)*expected);
+    if (previous == *expected) return TRUE;
+    *expected = previous;
+    return FALSE;
+}
+
+HINLINE b8 atomic_compare_exchange_u64(volatile u64* value, u64* expected, u64 desired)
+{
+    u64 previous = (u64)_InterlockedCompareExchange64((volatile __int64*)value, (__int64)desired, (__int64)*expected);
+    if (previous == *expected) return TRUE;
+    *expected = previous;
+    return FALSE;
+}
+
+HINLINE void* atomic_load_ptr(void* volatile* value) { void* result = *value; _ReadWriteBarrier(); return result; }
+HINLINE void atomic_store_ptr(void* volatile* value, void* desired) { _ReadWriteBarrier(); *value = desired; }
+
+HINLINE b8 atomic_compare_exchange_ptr(void* volatile* value, void** expected, void* desired)
+{
+    void* previous = _InterlockedCompareExchangePointer(value, desired, *expected);
+    if (previous == *expected) return TRUE;
+    *expected = previous;
+    return FALSE;
+}
+
+HINLINE void atomic_thread_fence_seq_cst() { _ReadWriteBarrier(); _mm_mfence(); }
+HINLINE void atomic_cpu_relax() { _mm_pause(); }
+#else
+HINLINE u32 atomic_load_u32(volatile u32* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+HINLINE u64 atomic_load_u64(volatile u64* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+
+HINLINE void atomic_store_u32(volatile u32* value, u32 desired) { __atomic_store_n(value, desired, __ATOMIC_RELEASE); }
+HINLINE void atomic_store_u64(volatile u64* value, u64 desired) { __atomic_store_n(value, desired, __ATOMIC_RELEASE); }
+
+HINLINE u32 atomic_fetch_add_u32(volatile u32* value, u32 amount) { return __atomic_fetch_add(value, amount, __ATOMIC_SEQ_CST); }
+HINLINE u64 atomic_fetch_add_u64(volatile u64* value, u64 amount) { return __atomic_fetch_add(value, amount, __ATOMIC_SEQ_CST); }
+
+HINLINE u32 atomic_exchange_u32(volatile u32* value, u32 desired) { return __atomic_exchange_n(value, desired, __ATOMIC_SEQ_CST); }
+
+HINLINE b8 atomic_compare_exchange_u32(volatile u32* value, u32* expected, u32 desired)
+{
+    return __atomic_compare_exchange_n(value, expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+HINLINE b8 atomic_compare_exchange_u64(volatile u64* value, u64* expected, u64 desired)
+{
+    return __atomic_compare_exchange_n(value, expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+HINLINE void* atomic_load_ptr(void* volatile* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+HINLINE void atomic_store_ptr(void* volatile* value, void* desired) { __atomic_store_n(value, desired, __ATOMIC_RELEASE); }
+
+HINLINE b8 atomic_compare_exchange_ptr(void* volatile* value, void** expected, void* desired)
+{
+    return __atomic_compare_exchange_n(value, expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+HINLINE void atomic_thread_fence_seq_cst() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+#if defined(__x86_64__) || defined(__i386__)
+HINLINE void atomic_cpu_relax() { __builtin_ia32_pause(); }
+#else
+HINLINE void atomic_cpu_relax() {}
+#endif
+#endif
\ No newline at end of file
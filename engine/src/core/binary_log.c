@@ -0,0 +1,439 @@
+#include "binary_log.h"
+
+#include "core/hstring.h"
+#include "core/atomic.h"
+
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BINARY_LOG_MAX_TEXT_LENGTH 4096
+#define BINARY_LOG_MAX_RECORD_SIZE 8192
+
+typedef struct format_entry
+{
+    // Published last, so readers that see it also see the rest of the entry.
+    const char* volatile format;
+    u32 id;
+    i32 arg_count;
+    u8 arg_kinds[BINARY_LOG_MAX_ARGS];
+} format_entry;
+
+typedef struct binary_log_buffer
+{
+    struct binary_log_buffer* next;
+    u64 used;
+    u8 data[BINARY_LOG_BUFFER_SIZE];
+} binary_log_buffer;
+
+typedef struct binary_log_state
+{
+    file_handle file;
+    b8 is_open;
+    // Guards format insertion and the buffer list; lookups of known formats stay lock free.
+    platform_mutex lock;
+    u32 format_count;
+    // Open addressing, keyed on the format string pointer.
+    format_entry formats[BINARY_LOG_MAX_FORMATS];
+    binary_log_buffer* buffers;
+} binary_log_state;
+
+static binary_log_state* state_ptr;
+
+static HTHREADLOCAL binary_log_buffer* thread_buffer;
+
+HINLINE void write_u16(u8** cursor, u16 value)
+{
+    memcpy(*cursor, &value, sizeof(u16));
+    *cursor += sizeof(u16);
+}
+
+HINLINE void write_u32(u8** cursor, u32 value)
+{
+    memcpy(*cursor, &value, sizeof(u32));
+    *cursor += sizeof(u32);
+}
+
+HINLINE void write_u64(u8** cursor, u64 value)
+{
+    memcpy(*cursor, &value, sizeof(u64));
+    *cursor += sizeof(u64);
+}
+
+i32 binary_log_parse_format(const char* format, u8* out_kinds)
+{
+    i32 count = 0;
+    const char* c = format;
+    while (*c)
+    {
+        if (*c++ != '%') continue;
+
+        if (*c == '%')
+        {
+            c++;
+            continue;
+        }
+
+        // Flags.
+        while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') c++;
+
+        // Width.
+        if (*c == '*')
+        {
+            if (count >= BINARY_LOG_MAX_ARGS) return -1;
+            out_kinds[count++] = BINARY_LOG_ARG_INT;
+            c++;
+        }
+        while (*c >= '0' && *c <= '9') c++;
+
+        // Precision.
+        if (*c == '.')
+        {
+            c++;
+            if (*c == '*')
+            {
+                if (count >= BINARY_LOG_MAX_ARGS) return -1;
+                out_kinds[count++] = BINARY_LOG_ARG_INT;
+                c++;
+            }
+            while (*c >= '0' && *c <= '9') c++;
+        }
+
+        // Length.
+        u8 int_kind = BINARY_LOG_ARG_INT;
+        b8 is_long_double = FALSE;
+        switch (*c)
+        {
+            case 'h':
+                c += c[1] == 'h' ? 2 : 1;
+                break;
+            case 'l':
+                int_kind = c[1] == 'l' ? BINARY_LOG_ARG_LONG_LONG : BINARY_LOG_ARG_LONG;
+                c += c[1] == 'l' ? 2 : 1;
+                break;
+            case 'j':
+                int_kind = BINARY_LOG_ARG_LONG_LONG;
+                c++;
+                break;
+            case 'z':
+            case 't':
+                int_kind = BINARY_LOG_ARG_SIZE;
+                c++;
+                break;
+            case 'L':
+                is_long_double = TRUE;
+                c++;
+                break;
+        }
+
+        u8 kind = BINARY_LOG_ARG_UNSUPPORTED;
+        switch (*c)
+        {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+                kind = int_kind;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                kind = is_long_double ? BINARY_LOG_ARG_UNSUPPORTED : BINARY_LOG_ARG_DOUBLE;
+                break;
+            case 's':
+                kind = int_kind == BINARY_LOG_ARG_INT ? BINARY_LOG_ARG_STRING : BINARY_LOG_ARG_UNSUPPORTED;
+                break;
+            case 'p':
+                kind = BINARY_LOG_ARG_POINTER;
+                break;
+        }
+
+        if (kind == BINARY_LOG_ARG_UNSUPPORTED || count >= BINARY_LOG_MAX_ARGS)
+        {
+            return -1;
+        }
+
+        out_kinds[count++] = kind;
+        c++;
+    }
+
+    return count;
+}
+
+b8 binary_log_initialize(u64* memory_requirement, void* state)
+{
+    *memory_requirement = sizeof(binary_log_state);
+
+    if (!state) return FALSE;
+
+    state_ptr = state;
+    hzero_memory(state_ptr, sizeof(binary_log_state));
+
+    return platform_mutex_create(&state_ptr->lock);
+}
+
+void binary_log_shutdown(void* state)
+{
+    if (!state_ptr) return;
+
+    binary_log_close();
+
+    // Buffers come straight from the platform so that logging never recurses into hallocate.
+    binary_log_buffer* buffer = state_ptr->buffers;
+    while (buffer)
+    {
+        binary_log_buffer* next = buffer->next;
+        platform_free(buffer, FALSE);
+        buffer = next;
+    }
+
+    platform_mutex_destroy(&state_ptr->lock);
+
+    thread_buffer = 0;
+    state_ptr = 0;
+}
+
+b8 binary_log_open(const char* path)
+{
+    if (!state_ptr) return FALSE;
+
+    if (state_ptr->is_open)
+    {
+        binary_log_close();
+    }
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &state_ptr->file))
+    {
+        return FALSE;
+    }
+
+    binary_log_file_header header;
+    header.magic = BINARY_LOG_MAGIC;
+    header.version = BINARY_LOG_VERSION;
+    header.reserved = 0;
+
+    u64 written = 0;
+    if (!filesystem_write(&state_ptr->file, sizeof(binary_log_file_header), &header, &written))
+    {
+        filesystem_close(&state_ptr->file);
+        return FALSE;
+    }
+
+    // Format ids are only meaningful within one file.
+    hzero_memory(state_ptr->formats, sizeof(state_ptr->formats));
+    state_ptr->format_count = 0;
+    state_ptr->is_open = TRUE;
+
+    return TRUE;
+}
+
+static void flush_buffer(binary_log_buffer* buffer)
+{
+    if (buffer->used == 0) return;
+
+    u64 written = 0;
+    filesystem_write(&state_ptr->file, buffer->used, buffer->data, &written);
+    buffer->used = 0;
+}
+
+void binary_log_close()
+{
+    if (!state_ptr || !state_ptr->is_open) return;
+
+    for (binary_log_buffer* buffer = state_ptr->buffers; buffer; buffer = buffer->next)
+    {
+        flush_buffer(buffer);
+    }
+
+    filesystem_close(&state_ptr->file);
+    state_ptr->is_open = FALSE;
+}
+
+void binary_log_flush()
+{
+    if (state_ptr && state_ptr->is_open && thread_buffer)
+    {
+        flush_buffer(thread_buffer);
+    }
+}
+
+static binary_log_buffer* acquire_thread_buffer()
+{
+    if (!thread_buffer)
+    {
+        thread_buffer = platform_allocate(sizeof(binary_log_buffer), FALSE);
+        thread_buffer->used = 0;
+
+        platform_mutex_lock(&state_ptr->lock);
+        thread_buffer->next = state_ptr->buffers;
+        state_ptr->buffers = thread_buffer;
+        platform_mutex_unlock(&state_ptr->lock);
+    }
+
+    return thread_buffer;
+}
+
+HINLINE u8* reserve(binary_log_buffer* buffer, u64 size)
+{
+    if (buffer->used + size > BINARY_LOG_BUFFER_SIZE)
+    {
+        flush_buffer(buffer);
+    }
+
+    return buffer->data + buffer->used;
+}
+
+static format_entry* add_format(binary_log_buffer* buffer, const char* format, u32 index)
+{
+    u32 mask = BINARY_LOG_MAX_FORMATS - 1;
+
+    for (u32 probe = 0; probe < BINARY_LOG_MAX_FORMATS; ++probe)
+    {
+        format_entry* entry = &state_ptr->formats[(index + probe) & mask];
+        const char* existing = atomic_load_ptr((void* volatile*)&entry->format);
+        if (existing == format)
+        {
+            // Another thread added it first.
+            return entry;
+        }
+
+        if (existing == 0)
+        {
+            // Keep the table sparse enough for short probes; overflow is logged as plain text.
+            u64 length = string_length(format) + 1;
+            if (state_ptr->format_count >= (BINARY_LOG_MAX_FORMATS / 4) * 3 || length > BINARY_LOG_MAX_TEXT_LENGTH)
+            {
+                return 0;
+            }
+
+            entry->id = state_ptr->format_count++;
+            entry->arg_count = binary_log_parse_format(format, entry->arg_kinds);
+            atomic_store_ptr((void* volatile*)&entry->format, (void*)format);
+
+            u8* cursor = reserve(buffer, 1 + sizeof(u32) + sizeof(u16) + length);
+            *cursor++ = BINARY_LOG_RECORD_FORMAT;
+            write_u32(&cursor, entry->id);
+            write_u16(&cursor, (u16)length);
+            memcpy(cursor, format, length);
+            cursor += length;
+            buffer->used = cursor - buffer->data;
+
+            return entry;
+        }
+    }
+
+    return 0;
+}
+
+static format_entry* find_or_add_format(binary_log_buffer* buffer, const char* format)
+{
+    u32 mask = BINARY_LOG_MAX_FORMATS - 1;
+    u32 index = (u32)(((u64)format >> 3) * 2654435761u) & mask;
+
+    for (u32 probe = 0; probe < BINARY_LOG_MAX_FORMATS; ++probe)
+    {
+        format_entry* entry = &state_ptr->formats[(index + probe) & mask];
+        const char* existing = atomic_load_ptr((void* volatile*)&entry->format);
+        if (existing == format)
+        {
+            return entry;
+        }
+
+        if (existing == 0)
+        {
+            break;
+        }
+    }
+
+    platform_mutex_lock(&state_ptr->lock);
+    format_entry* entry = add_format(buffer, format, index);
+    platform_mutex_unlock(&state_ptr->lock);
+
+    return entry;
+}
+
+static void write_text_record(binary_log_buffer* buffer, log_level level, u64 timestamp, const char* format, va_list* args)
+{
+    char text[BINARY_LOG_MAX_TEXT_LENGTH];
+    i32 length = vsnprintf(text, BINARY_LOG_MAX_TEXT_LENGTH, format, *args);
+    if (length < 0) return;
+    if (length >= BINARY_LOG_MAX_TEXT_LENGTH) length = BINARY_LOG_MAX_TEXT_LENGTH - 1;
+
+    u8* cursor = reserve(buffer, 1 + 1 + sizeof(u64) + sizeof(u16) + length + 1);
+    *cursor++ = BINARY_LOG_RECORD_TEXT;
+    *cursor++ = (u8)level;
+    write_u64(&cursor, timestamp);
+    write_u16(&cursor, (u16)(length + 1));
+    memcpy(cursor, text, length);
+    cursor += length;
+    *cursor++ = 0;
+    buffer->used = cursor - buffer->data;
+}
+
+void binary_log_write(log_level level, const char* format, va_list* args)
+{
+    if (!state_ptr || !state_ptr->is_open) return;
+
+    binary_log_buffer* buffer = acquire_thread_buffer();
+    u64 timestamp = platform_get_ticks_ns();
+
+    format_entry* entry = find_or_add_format(buffer, format);
+    if (!entry || entry->arg_count < 0)
+    {
+        write_text_record(buffer, level, timestamp, format, args);
+        return;
+    }
+
+    u8* cursor = reserve(buffer, BINARY_LOG_MAX_RECORD_SIZE);
+    *cursor++ = BINARY_LOG_RECORD_MESSAGE;
+    write_u32(&cursor, entry->id);
+    *cursor++ = (u8)level;
+    write_u64(&cursor, timestamp);
+
+    u8* arg_size_cursor = cursor;
+    cursor += sizeof(u16);
+    u8* args_start = cursor;
+
+    for (i32 i = 0; i < entry->arg_count; ++i)
+    {
+        switch (entry->arg_kinds[i])
+        {
+            case BINARY_LOG_ARG_INT:
+                write_u32(&cursor, (u32)va_arg(*args, int));
+                break;
+            case BINARY_LOG_ARG_LONG:
+                write_u64(&cursor, (u64)va_arg(*args, long));
+                break;
+            case BINARY_LOG_ARG_LONG_LONG:
+                write_u64(&cursor, (u64)va_arg(*args, long long));
+                break;
+            case BINARY_LOG_ARG_SIZE:
+                write_u64(&cursor, (u64)va_arg(*args, size_t));
+                break;
+            case BINARY_LOG_ARG_DOUBLE:
+            {
+                f64 value = va_arg(*args, double);
+                memcpy(cursor, &value, sizeof(f64));
+                cursor += sizeof(f64);
+            } break;
+            case BINARY_LOG_ARG_POINTER:
+                write_u64(&cursor, (u64)va_arg(*args, void*));
+                break;
+            case BINARY_LOG_ARG_STRING:
+            {
+                const char* str = va_arg(*args, const char*);
+                if (!str) str = "(null)";
+                u64 length = string_length(str);
+                if (length > BINARY_LOG_MAX_STRING_LENGTH) length = BINARY_LOG_MAX_STRING_LENGTH;
+                write_u16(&cursor, (u16)length);
+                memcpy(cursor, str, length);
+                cursor += length;
+            } break;
+        }
+    }
+
+    u16 arg_size = (u16)(cursor - args_start);
+    write_u16(&arg_size_cursor, arg_size);
+
+    buffer->used = cursor - buffer->data;
+}
\ No newline at end of file
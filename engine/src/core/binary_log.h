@@ -0,0 +1,81 @@
+#pragma once
+
+#include "defines.h"
+
+#include "core/logger.h"
+
+#include <stdarg.h>
+
+/*
+File layout
+binary_log_file_header
+records...
+
+Every record starts with a u8 record type. All values are little endian and unaligned.
+
+BINARY_LOG_RECORD_FORMAT    u32 format_id, u16 length (including terminator), char format[length]
+BINARY_LOG_RECORD_MESSAGE   u32 format_id, u8 level, u64 timestamp_ns, u16 arg_size, u8 args[arg_size]
+BINARY_LOG_RECORD_TEXT      u8 level, u64 timestamp_ns, u16 length (including terminator), char text[length]
+
+Message arguments are stored in format string order:
+int             4 bytes
+long/long long  8 bytes (widened)
+double          8 bytes
+pointer         8 bytes
+string          u16 length followed by the characters, no terminator
+*/
+
+#define BINARY_LOG_MAGIC 0x474F4C48 // 'HLOG'
+#define BINARY_LOG_VERSION 1
+
+#define BINARY_LOG_MAX_FORMATS 4096
+#define BINARY_LOG_MAX_ARGS 16
+#define BINARY_LOG_MAX_STRING_LENGTH 256
+#define BINARY_LOG_BUFFER_SIZE (64 * 1024)
+
+typedef struct binary_log_file_header
+{
+    u32 magic;
+    u16 version;
+    u16 reserved;
+} binary_log_file_header;
+
+typedef enum binary_log_record_type
+{
+    BINARY_LOG_RECORD_FORMAT = 1,
+    BINARY_LOG_RECORD_MESSAGE = 2,
+    BINARY_LOG_RECORD_TEXT = 3
+} binary_log_record_type;
+
+typedef enum binary_log_arg_kind
+{
+    BINARY_LOG_ARG_INT,
+    BINARY_LOG_ARG_LONG,
+    BINARY_LOG_ARG_LONG_LONG,
+    BINARY_LOG_ARG_SIZE,
+    BINARY_LOG_ARG_DOUBLE,
+    BINARY_LOG_ARG_POINTER,
+    BINARY_LOG_ARG_STRING,
+
+    BINARY_LOG_ARG_UNSUPPORTED
+} binary_log_arg_kind;
+
+/**
+ * @brief Parses a printf style format string into the argument kinds it consumes.
+ * Shared by the logger and the decoder so both agree on the record layout.
+ *
+ * @param format the format string.
+ * @param out_kinds an array of at least BINARY_LOG_MAX_ARGS entries.
+ * @return the argument count, or -1 if the format uses a conversion that cannot be recorded.
+*/
+HAPI i32 binary_log_parse_format(const char* format, u8* out_kinds);
+
+b8 binary_log_initialize(u64* memory_requirement, void* state);
+void binary_log_shutdown(void* state);
+
+b8 binary_log_open(const char* path);
+void binary_log_close();
+
+void binary_log_write(log_level level, const char* format, va_list* args);
+
+void binary_log_flush();
\ No newline at end of file
@@ -4,19 +4,21 @@
 
 void clock_start(clock* clock)
 {
-    clock->start_time = platform_get_absolute_time();
+    clock->start_ns = platform_get_ticks_ns();
+    clock->elapsed_ns = 0;
     clock->elapsed = 0;
 }
 
 void clock_update(clock* clock)
 {
-    if (clock->start_time != 0)
+    if (clock->start_ns != 0)
     {
-        clock->elapsed = platform_get_absolute_time() - clock->start_time;
+        clock->elapsed_ns = platform_get_ticks_ns() - clock->start_ns;
+        clock->elapsed = clock->elapsed_ns * 0.000000001;
     }
 }
 
 void clock_stop(clock* clock)
 {
-    clock->start_time = 0;
+    clock->start_ns = 0;
 }
\ No newline at end of file
@@ -4,7 +4,10 @@
 
 typedef struct clock
 {
-    f64 start_time;
+    // Platform ticks at clock_start, 0 while stopped.
+    u64 start_ns;
+    u64 elapsed_ns;
+    // elapsed_ns in seconds, for callers that want a duration.
     f64 elapsed;
 } clock;
 
@@ -1,9 +1,13 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
 #include "memory/hmemory.h"
 
 #include "core/event.h"
+#include "core/event_trace.h"
 #include "core/logger.h"
 
 #include "containers/list.h"
+#include "containers/mpsc_queue.h"
 
 typedef struct registered_event
 {
@@ -18,21 +22,77 @@ typedef struct event_code_entry
 
 #define MAX_MESSAGE_CODES 16384
 
+// Events posted from other threads that can be waiting for the next dispatch.
+#define MAX_ASYNC_EVENTS 4096
+
+typedef struct queued_event
+{
+    void* sender;
+    event_context data;
+    u16 code;
+    b8 handled;
+    // Index + 1 of the next queued event with the same code, 0 terminates the chain.
+    u32 next_same_code;
+} queued_event;
+
+typedef struct pending_registration
+{
+    u16 code;
+    b8 is_register;
+    registered_event event;
+} pending_registration;
+
 typedef struct event_system_state
 {
     event_code_entry registered[MAX_MESSAGE_CODES];
     b8 is_initialized;
+
+    // Enqueued events are written to one queue while the other is being dispatched.
+    queued_event* queues[2];
+    u32 write_queue;
+
+    // Per batch grouping by code, as index + 1 into the dispatching queue.
+    u32 code_heads[MAX_MESSAGE_CODES];
+    u32 code_tails[MAX_MESSAGE_CODES];
+    u16* batch_codes;
+
+    u8 coalesce_policies[MAX_MESSAGE_CODES];
+    event_frame_stats frame_stats;
+
+    mpsc_queue async_queue;
+
+    // Listener lists are not modified while they are being walked. Changes made by
+    // listeners are applied when the outermost dispatch finishes.
+    u32 dispatch_depth;
+    pending_registration* pending_registrations;
 } event_system_state;
 
 static event_system_state* state_ptr;
 
 b8 event_initialize(u64* memory_requirement, void* state)
 {
-    *memory_requirement = sizeof(event_system_state);
+    u64 async_queue_requirement = mpsc_queue_memory_requirement(sizeof(queued_event), MAX_ASYNC_EVENTS);
+    *memory_requirement = sizeof(event_system_state) + async_queue_requirement;
 
     if (!state) return FALSE;
 
     state_ptr = state;
+    hzero_memory(state_ptr, sizeof(event_system_state));
+
+    if (!mpsc_queue_create(sizeof(queued_event), MAX_ASYNC_EVENTS, state + sizeof(event_system_state), &state_ptr->async_queue))
+    {
+        return FALSE;
+    }
+
+    state_ptr->queues[0] = list_create(queued_event);
+    state_ptr->queues[1] = list_create(queued_event);
+    state_ptr->batch_codes = list_create(u16);
+    state_ptr->pending_registrations = list_create(pending_registration);
+
+    // High frequency input is merged by default.
+    state_ptr->coalesce_policies[EVENT_MOUSE_MOVED] = EVENT_COALESCE_LAST;
+    state_ptr->coalesce_policies[EVENT_MOUSE_WHEEL] = EVENT_COALESCE_ACCUMULATE;
+
     state_ptr->is_initialized = TRUE;
 
     HINFO("Event subsystem initialized successfully.");
@@ -51,18 +111,19 @@ void event_shutdown(void* state)
         }
     }
 
+    list_destroy(state_ptr->queues[0]);
+    list_destroy(state_ptr->queues[1]);
+    list_destroy(state_ptr->batch_codes);
+    list_destroy(state_ptr->pending_registrations);
+    mpsc_queue_destroy(&state_ptr->async_queue);
+
     state_ptr = 0;
 
     HINFO("Event subsystem shut down successfully.");
 }
 
-b8 event_register(u16 code, void* listener, PFN_on_event on_event)
+static b8 apply_register(u16 code, registered_event event)
 {
-    if (state_ptr->is_initialized == FALSE)
-    {
-        return FALSE;
-    }
-
     if (state_ptr->registered[code].events == 0)
     {
         state_ptr->registered[code].events = list_create(registered_event);
@@ -71,27 +132,19 @@ b8 event_register(u16 code, void* listener, PFN_on_event on_event)
     u64 registered_count = list_count(state_ptr->registered[code].events);
     for (u64 i = 0; i < registered_count; ++i)
     {
-        if (state_ptr->registered[code].events[i].listener == listener)
+        if (state_ptr->registered[code].events[i].listener == event.listener)
         {
             return FALSE;
         }
     }
 
-    registered_event event;
-    event.listener = listener;
-    event.callback = on_event;
     list_push(state_ptr->registered[code].events, event);
 
     return TRUE;
 }
 
-b8 event_unregister(u16 code, void* listener, PFN_on_event on_event)
+static b8 apply_unregister(u16 code, registered_event event)
 {
-    if (state_ptr->is_initialized == FALSE)
-    {
-        return FALSE;
-    }
-
     if (state_ptr->registered[code].events == 0)
     {
         return FALSE;
@@ -101,7 +154,7 @@ b8 event_unregister(u16 code, void* listener, PFN_on_event on_event)
     for (u64 i = 0; i < registered_count; ++i)
     {
         registered_event e = state_ptr->registered[code].events[i];
-        if (e.listener == listener && e.callback == on_event)
+        if (e.listener == event.listener && e.callback == event.callback)
         {
             registered_event popped_event;
             list_pop_at(state_ptr->registered[code].events, i, &popped_event);
@@ -112,6 +165,92 @@ b8 event_unregister(u16 code, void* listener, PFN_on_event on_event)
     return FALSE;
 }
 
+static void begin_dispatch()
+{
+    state_ptr->dispatch_depth++;
+}
+
+static void end_dispatch()
+{
+    if (--state_ptr->dispatch_depth > 0) return;
+
+    u64 pending_count = list_count(state_ptr->pending_registrations);
+    for (u64 i = 0; i < pending_count; ++i)
+    {
+        pending_registration* pending = &state_ptr->pending_registrations[i];
+        if (pending->is_register)
+        {
+            apply_register(pending->code, pending->event);
+        }
+        else
+        {
+            apply_unregister(pending->code, pending->event);
+        }
+    }
+
+    list_clear(state_ptr->pending_registrations);
+}
+
+b8 event_register(u16 code, void* listener, PFN_on_event on_event)
+{
+    if (state_ptr->is_initialized == FALSE)
+    {
+        return FALSE;
+    }
+
+    registered_event event;
+    event.listener = listener;
+    event.callback = on_event;
+
+    if (state_ptr->dispatch_depth > 0)
+    {
+        pending_registration pending;
+        pending.code = code;
+        pending.is_register = TRUE;
+        pending.event = event;
+        list_push(state_ptr->pending_registrations, pending);
+        return TRUE;
+    }
+
+    return apply_register(code, event);
+}
+
+b8 event_register_coalesced(u16 code, void* listener, PFN_on_event on_event, event_coalesce_policy policy)
+{
+    if (state_ptr->is_initialized == FALSE)
+    {
+        return FALSE;
+    }
+
+    state_ptr->coalesce_policies[code] = policy;
+
+    return event_register(code, listener, on_event);
+}
+
+b8 event_unregister(u16 code, void* listener, PFN_on_event on_event)
+{
+    if (state_ptr->is_initialized == FALSE)
+    {
+        return FALSE;
+    }
+
+    registered_event event;
+    event.listener = listener;
+    event.callback = on_event;
+
+    if (state_ptr->dispatch_depth > 0)
+    {
+        pending_registration pending;
+        pending.code = code;
+        pending.is_register = FALSE;
+        pending.event = event;
+        list_push(state_ptr->pending_registrations, pending);
+        return TRUE;
+    }
+
+    return apply_unregister(code, event);
+}
+
 b8 event_post(u16 code, void* sender, event_context data)
 {
     if (state_ptr->is_initialized == FALSE)
@@ -119,20 +258,182 @@ b8 event_post(u16 code, void* sender, event_context data)
         return FALSE;
     }
 
+    event_trace_record_event(code, sender, data, state_ptr->dispatch_depth > 0);
+
     if (state_ptr->registered[code].events == 0)
     {
         return FALSE;
     }
 
+    begin_dispatch();
+
+    b8 handled = FALSE;
     u64 registered_count = list_count(state_ptr->registered[code].events);
     for (u64 i = 0; i < registered_count; ++i)
     {
         registered_event e = state_ptr->registered[code].events[i];
         if (e.callback(code, sender, e.listener, data))
         {
-            return TRUE;
+            handled = TRUE;
+            break;
         }
     }
 
-    return FALSE;
+    end_dispatch();
+
+    return handled;
+}
+
+b8 event_enqueue(u16 code, void* sender, event_context data)
+{
+    if (!state_ptr || state_ptr->is_initialized == FALSE)
+    {
+        return FALSE;
+    }
+
+    event_trace_record_event(code, sender, data, state_ptr->dispatch_depth > 0);
+
+    queued_event event;
+    event.sender = sender;
+    event.data = data;
+    event.code = code;
+    event.handled = FALSE;
+    event.next_same_code = 0;
+    list_push(state_ptr->queues[state_ptr->write_queue], event);
+
+    return TRUE;
+}
+
+b8 event_post_async(u16 code, void* sender, event_context data)
+{
+    if (!state_ptr || state_ptr->is_initialized == FALSE)
+    {
+        return FALSE;
+    }
+
+    queued_event event;
+    event.sender = sender;
+    event.data = data;
+    event.code = code;
+    event.handled = FALSE;
+    event.next_same_code = 0;
+
+    return mpsc_queue_push(&state_ptr->async_queue, &event);
+}
+
+static void accumulate_context(event_context* target, const event_context* source)
+{
+    for (u32 i = 0; i < 16; ++i)
+    {
+        i32 sum = (i32)target->data.i8[i] + (i32)source->data.i8[i];
+        target->data.i8[i] = (i8)(sum > 127 ? 127 : (sum < -128 ? -128 : sum));
+    }
+}
+
+void event_dispatch()
+{
+    if (!state_ptr || state_ptr->is_initialized == FALSE)
+    {
+        return;
+    }
+
+    // Events from other threads join this frame's batch.
+    queued_event async_event;
+    while (mpsc_queue_pop(&state_ptr->async_queue, &async_event))
+    {
+        // Recorded here rather than on the posting thread; they are a consequence of earlier work.
+        event_trace_record_event(async_event.code, async_event.sender, async_event.data, TRUE);
+        list_push(state_ptr->queues[state_ptr->write_queue], async_event);
+    }
+
+    // Anything enqueued by a listener during dispatch goes to the next batch.
+    queued_event* queue = state_ptr->queues[state_ptr->write_queue];
+    state_ptr->write_queue ^= 1;
+
+    u64 queued_count = list_count(queue);
+    state_ptr->frame_stats.raw_count = (u32)queued_count;
+    state_ptr->frame_stats.delivered_count = 0;
+    if (queued_count == 0)
+    {
+        return;
+    }
+
+    // Chain the events of each code together, keeping the order they were enqueued in.
+    // Coalesced events are merged into the previous event of their code when it has the same sender.
+    list_clear(state_ptr->batch_codes);
+    for (u32 i = 0; i < queued_count; ++i)
+    {
+        u16 code = queue[i].code;
+        if (state_ptr->code_heads[code] == 0)
+        {
+            state_ptr->code_heads[code] = i + 1;
+            list_push(state_ptr->batch_codes, code);
+        }
+        else
+        {
+            queued_event* tail = &queue[state_ptr->code_tails[code] - 1];
+            u8 policy = state_ptr->coalesce_policies[code];
+            if (policy != EVENT_COALESCE_KEEP_ALL && tail->sender == queue[i].sender)
+            {
+                if (policy == EVENT_COALESCE_LAST)
+                {
+                    tail->data = queue[i].data;
+                }
+                else
+                {
+                    accumulate_context(&tail->data, &queue[i].data);
+                }
+                continue;
+            }
+
+            tail->next_same_code = i + 1;
+        }
+        state_ptr->code_tails[code] = i + 1;
+        state_ptr->frame_stats.delivered_count++;
+    }
+
+    begin_dispatch();
+
+    // Each listener list is walked once per code. A listener sees the events of a code in order,
+    // and an event handled by one listener is not passed to the ones after it, as with event_post.
+    u64 code_count = list_count(state_ptr->batch_codes);
+    for (u64 c = 0; c < code_count; ++c)
+    {
+        u16 code = state_ptr->batch_codes[c];
+        u32 head = state_ptr->code_heads[code];
+        state_ptr->code_heads[code] = 0;
+        state_ptr->code_tails[code] = 0;
+
+        registered_event* listeners = state_ptr->registered[code].events;
+        u64 listener_count = listeners ? list_count(listeners) : 0;
+        for (u64 l = 0; l < listener_count; ++l)
+        {
+            b8 any_pending = FALSE;
+            for (u32 e = head; e != 0; e = queue[e - 1].next_same_code)
+            {
+                queued_event* event = &queue[e - 1];
+                if (event->handled) continue;
+
+                event->handled = listeners[l].callback(code, event->sender, listeners[l].listener, event->data);
+                any_pending |= !event->handled;
+            }
+
+            if (!any_pending) break;
+        }
+    }
+
+    end_dispatch();
+
+    list_clear(queue);
+}
+
+void event_get_frame_stats(event_frame_stats* out_stats)
+{
+    if (!state_ptr)
+    {
+        hzero_memory(out_stats, sizeof(event_frame_stats));
+        return;
+    }
+
+    *out_stats = state_ptr->frame_stats;
 }
\ No newline at end of file
@@ -27,14 +27,49 @@ typedef struct event_context
 
 typedef b8 (*PFN_on_event)(u16 code, void* sender, void* listener_inst, event_context data);
 
+// How queued events of one code from the same sender are merged before they are dispatched.
+typedef enum event_coalesce_policy
+{
+    // Every event is delivered.
+    EVENT_COALESCE_KEEP_ALL,
+    // Only the most recent event is delivered.
+    EVENT_COALESCE_LAST,
+    // One event is delivered, its context is the element-wise sum of the i8 lanes, saturated.
+    EVENT_COALESCE_ACCUMULATE
+} event_coalesce_policy;
+
+typedef struct event_frame_stats
+{
+    // Events queued for the last dispatch, before coalescing.
+    u32 raw_count;
+    // Events left after coalescing.
+    u32 delivered_count;
+} event_frame_stats;
+
 b8 event_initialize(u64* memory_requirement, void* state);
 void event_shutdown(void* state);
 
+// Main thread only. Changes made from inside a listener take effect once the current dispatch finishes.
 HAPI b8 event_register(u16 code, void* listener, PFN_on_event on_event);
 HAPI b8 event_unregister(u16 code, void* listener, PFN_on_event on_event);
 
+// Registers the listener and sets the coalescing policy for the code. Immediate event_post calls are never coalesced.
+HAPI b8 event_register_coalesced(u16 code, void* listener, PFN_on_event on_event, event_coalesce_policy policy);
+
+// Calls every listener immediately.
 HAPI b8 event_post(u16 code, void* sender, event_context data);
 
+// Queues the event until the next event_dispatch, once per frame after the platform messages are pumped.
+HAPI b8 event_enqueue(u16 code, void* sender, event_context data);
+
+// Safe to call from any thread. The event is delivered by the next event_dispatch on the main thread.
+// Returns FALSE if too many events are already waiting.
+HAPI b8 event_post_async(u16 code, void* sender, event_context data);
+
+void event_dispatch();
+
+HAPI void event_get_frame_stats(event_frame_stats* out_stats);
+
 typedef enum system_event_code
 {
     EVENT_APPLICATION_QUIT = 0x01,
@@ -45,6 +80,8 @@ typedef enum system_event_code
     EVENT_MOUSE_MOVED = 0x06,
     EVENT_MOUSE_WHEEL = 0x07,
     EVENT_RESIZED = 0x08,
+    // context.data.u8[0] is 1 when the window gained focus, 0 when it lost it.
+    EVENT_FOCUS_CHANGED = 0x09,
 
     // DEBUG
 
@@ -0,0 +1,320 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "event_trace.h"
+
+#include "core/logger.h"
+#include "core/input.h"
+#include "core/frame_stats.h"
+
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+
+#include "containers/list.h"
+
+#include "platform/filesystem.h"
+
+#include <string.h>
+
+#define EVENT_TRACE_BUFFER_SIZE (64 * 1024)
+#define EVENT_TRACE_EVENT_RECORD_SIZE (1 + sizeof(u16) + 1 + 1 + sizeof(event_context))
+#define EVENT_TRACE_FRAME_RECORD_SIZE (1 + sizeof(u64) + sizeof(f64))
+
+typedef enum event_trace_mode
+{
+    EVENT_TRACE_MODE_NONE,
+    EVENT_TRACE_MODE_RECORD,
+    EVENT_TRACE_MODE_REPLAY
+} event_trace_mode;
+
+typedef struct event_trace_state
+{
+    event_trace_mode mode;
+
+    // Recording.
+    file_handle file;
+    void* program_sender;
+    u64 buffer_used;
+    u8 buffer[EVENT_TRACE_BUFFER_SIZE];
+
+    // Replay.
+    u8* trace_data;
+    u64 trace_size;
+    u64 trace_cursor;
+    f64* frame_times;
+} event_trace_state;
+
+static event_trace_state* state_ptr;
+
+b8 event_trace_initialize(u64* memory_requirement, void* state)
+{
+    *memory_requirement = sizeof(event_trace_state);
+
+    if (!state) return FALSE;
+
+    state_ptr = state;
+    hzero_memory(state_ptr, sizeof(event_trace_state));
+
+    return TRUE;
+}
+
+void event_trace_shutdown(void* state)
+{
+    event_trace_stop();
+
+    state_ptr = 0;
+}
+
+static void flush_buffer()
+{
+    if (state_ptr->buffer_used == 0) return;
+
+    u64 written = 0;
+    if (!filesystem_write(&state_ptr->file, state_ptr->buffer_used, state_ptr->buffer, &written))
+    {
+        HERROR("Failed to write the event trace.");
+    }
+    state_ptr->buffer_used = 0;
+}
+
+static u8* reserve(u64 size)
+{
+    if (state_ptr->buffer_used + size > EVENT_TRACE_BUFFER_SIZE)
+    {
+        flush_buffer();
+    }
+
+    u8* cursor = state_ptr->buffer + state_ptr->buffer_used;
+    state_ptr->buffer_used += size;
+    return cursor;
+}
+
+b8 event_trace_start_recording(const char* path, void* program_sender)
+{
+    if (!state_ptr) return FALSE;
+
+    event_trace_stop();
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &state_ptr->file))
+    {
+        HERROR("Unable to open event trace '%s' for writing.", path);
+        return FALSE;
+    }
+
+    event_trace_file_header header;
+    header.magic = EVENT_TRACE_MAGIC;
+    header.version = EVENT_TRACE_VERSION;
+    header.reserved = 0;
+    hcopy_memory(reserve(sizeof(event_trace_file_header)), &header, sizeof(event_trace_file_header));
+
+    state_ptr->program_sender = program_sender;
+    state_ptr->mode = EVENT_TRACE_MODE_RECORD;
+
+    HINFO("Recording event trace to '%s'.", path);
+
+    return TRUE;
+}
+
+b8 event_trace_start_replay(const char* path)
+{
+    if (!state_ptr) return FALSE;
+
+    event_trace_stop();
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, TRUE, &file))
+    {
+        HERROR("Unable to open event trace '%s' for reading.", path);
+        return FALSE;
+    }
+
+    u64 size = 0;
+    filesystem_size(&file, &size);
+
+    event_trace_file_header header;
+    if (size < sizeof(event_trace_file_header))
+    {
+        HERROR("Event trace '%s' is too small to be valid.", path);
+        filesystem_close(&file);
+        return FALSE;
+    }
+
+    state_ptr->trace_data = hallocate(size, MEMORY_TAG_ARRAY);
+    u64 read_size = 0;
+    b8 read_ok = filesystem_read_all_bytes(&file, state_ptr->trace_data, &read_size);
+    filesystem_close(&file);
+
+    hcopy_memory(&header, state_ptr->trace_data, sizeof(event_trace_file_header));
+    if (!read_ok || header.magic != EVENT_TRACE_MAGIC || header.version != EVENT_TRACE_VERSION)
+    {
+        HERROR("'%s' is not an event trace this build understands.", path);
+        hfree(state_ptr->trace_data, size, MEMORY_TAG_ARRAY);
+        state_ptr->trace_data = 0;
+        return FALSE;
+    }
+
+    state_ptr->trace_size = size;
+    state_ptr->trace_cursor = sizeof(event_trace_file_header);
+    state_ptr->frame_times = list_create(f64);
+    state_ptr->mode = EVENT_TRACE_MODE_REPLAY;
+
+    HINFO("Replaying event trace '%s'.", path);
+
+    return TRUE;
+}
+
+static void report_frame_times()
+{
+    frame_stats_summary summary;
+    if (!frame_stats_summarize_samples(state_ptr->frame_times, (u32)list_count(state_ptr->frame_times), &summary)) return;
+
+    HINFO("Replay frame times over %u frames (ms): min %.3f, avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f",
+        summary.sample_count,
+        summary.min * 1000.0,
+        summary.average * 1000.0,
+        summary.p50 * 1000.0,
+        summary.p95 * 1000.0,
+        summary.p99 * 1000.0,
+        summary.max * 1000.0);
+}
+
+void event_trace_stop()
+{
+    if (!state_ptr) return;
+
+    if (state_ptr->mode == EVENT_TRACE_MODE_RECORD)
+    {
+        flush_buffer();
+        filesystem_close(&state_ptr->file);
+    }
+    else if (state_ptr->mode == EVENT_TRACE_MODE_REPLAY)
+    {
+        report_frame_times();
+
+        list_destroy(state_ptr->frame_times);
+        state_ptr->frame_times = 0;
+        hfree(state_ptr->trace_data, state_ptr->trace_size, MEMORY_TAG_ARRAY);
+        state_ptr->trace_data = 0;
+    }
+
+    state_ptr->mode = EVENT_TRACE_MODE_NONE;
+}
+
+b8 event_trace_is_recording()
+{
+    return state_ptr && state_ptr->mode == EVENT_TRACE_MODE_RECORD;
+}
+
+b8 event_trace_is_replaying()
+{
+    return state_ptr && state_ptr->mode == EVENT_TRACE_MODE_REPLAY;
+}
+
+void event_trace_record_event(u16 code, void* sender, event_context data, b8 derived)
+{
+    if (!state_ptr || state_ptr->mode != EVENT_TRACE_MODE_RECORD) return;
+
+    u8 sender_class = EVENT_TRACE_SENDER_OTHER;
+    if (sender == 0)
+    {
+        sender_class = EVENT_TRACE_SENDER_PLATFORM;
+    }
+    else if (sender == state_ptr->program_sender)
+    {
+        sender_class = EVENT_TRACE_SENDER_PROGRAM;
+    }
+
+    u8* cursor = reserve(EVENT_TRACE_EVENT_RECORD_SIZE);
+    *cursor++ = EVENT_TRACE_RECORD_EVENT;
+    memcpy(cursor, &code, sizeof(u16));
+    cursor += sizeof(u16);
+    *cursor++ = sender_class;
+    *cursor++ = derived ? EVENT_TRACE_FLAG_DERIVED : 0;
+    memcpy(cursor, &data, sizeof(event_context));
+}
+
+void event_trace_record_frame(u64 frame_number, f64 delta_time)
+{
+    if (!state_ptr || state_ptr->mode != EVENT_TRACE_MODE_RECORD) return;
+
+    u8* cursor = reserve(EVENT_TRACE_FRAME_RECORD_SIZE);
+    *cursor++ = EVENT_TRACE_RECORD_FRAME;
+    memcpy(cursor, &frame_number, sizeof(u64));
+    cursor += sizeof(u64);
+    memcpy(cursor, &delta_time, sizeof(f64));
+}
+
+static void replay_event(u16 code, event_context data)
+{
+    u64 now = platform_get_ticks_ns();
+
+    // Input goes through the input system so that its polled state matches the recording.
+    switch (code)
+    {
+        case EVENT_KEY_PRESSED:
+        case EVENT_KEY_RELEASED:
+            input_process_key((keys)data.data.u16[0], code == EVENT_KEY_PRESSED, now);
+            break;
+        case EVENT_BUTTON_PRESSED:
+        case EVENT_BUTTON_RELEASED:
+            input_process_button((buttons)data.data.u16[0], code == EVENT_BUTTON_PRESSED, now);
+            break;
+        case EVENT_MOUSE_MOVED:
+            input_process_mouse_move(data.data.i16[0], data.data.i16[1], now);
+            break;
+        case EVENT_MOUSE_WHEEL:
+            input_process_mouse_wheel(data.data.i8[0], now);
+            break;
+        default:
+            event_post(code, 0, data);
+            break;
+    }
+}
+
+b8 event_trace_replay_frame(f64* out_delta_time)
+{
+    if (!state_ptr || state_ptr->mode != EVENT_TRACE_MODE_REPLAY) return FALSE;
+
+    const u8* data = state_ptr->trace_data;
+    while (state_ptr->trace_cursor < state_ptr->trace_size)
+    {
+        const u8* p = data + state_ptr->trace_cursor;
+        u64 remaining = state_ptr->trace_size - state_ptr->trace_cursor;
+
+        if (p[0] == EVENT_TRACE_RECORD_FRAME && remaining >= EVENT_TRACE_FRAME_RECORD_SIZE)
+        {
+            memcpy(out_delta_time, p + 1 + sizeof(u64), sizeof(f64));
+            state_ptr->trace_cursor += EVENT_TRACE_FRAME_RECORD_SIZE;
+            return TRUE;
+        }
+
+        if (p[0] != EVENT_TRACE_RECORD_EVENT || remaining < EVENT_TRACE_EVENT_RECORD_SIZE)
+        {
+            HWARN("Event trace is truncated or corrupt at offset %llu.", state_ptr->trace_cursor);
+            break;
+        }
+
+        u16 code;
+        event_context context;
+        memcpy(&code, p + 1, sizeof(u16));
+        u8 sender_class = p[3];
+        u8 flags = p[4];
+        memcpy(&context, p + 5, sizeof(event_context));
+        state_ptr->trace_cursor += EVENT_TRACE_EVENT_RECORD_SIZE;
+
+        if (sender_class == EVENT_TRACE_SENDER_PLATFORM && !(flags & EVENT_TRACE_FLAG_DERIVED))
+        {
+            replay_event(code, context);
+        }
+    }
+
+    state_ptr->trace_cursor = state_ptr->trace_size;
+    return FALSE;
+}
+
+void event_trace_replay_add_frame_time(f64 seconds)
+{
+    if (!state_ptr || state_ptr->mode != EVENT_TRACE_MODE_REPLAY) return;
+
+    list_push(state_ptr->frame_times, seconds);
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "defines.h"
+
+#include "core/event.h"
+
+/*
+File layout
+event_trace_file_header
+records...
+
+Every record starts with a u8 record type. All values are little endian and unaligned.
+The events of a frame come before the frame record that closes it.
+
+EVENT_TRACE_RECORD_EVENT    u16 code, u8 sender_class, u8 flags, u8 context[16]
+EVENT_TRACE_RECORD_FRAME    u64 frame_number, f64 delta_time
+*/
+
+#define EVENT_TRACE_MAGIC 0x54564548 // 'HEVT'
+#define EVENT_TRACE_VERSION 1
+
+typedef struct event_trace_file_header
+{
+    u32 magic;
+    u16 version;
+    u16 reserved;
+} event_trace_file_header;
+
+typedef enum event_trace_record_type
+{
+    EVENT_TRACE_RECORD_EVENT = 1,
+    EVENT_TRACE_RECORD_FRAME = 2
+} event_trace_record_type;
+
+typedef enum event_trace_sender_class
+{
+    // Posted without a sender, as the platform layer and input system do.
+    EVENT_TRACE_SENDER_PLATFORM,
+    EVENT_TRACE_SENDER_PROGRAM,
+    EVENT_TRACE_SENDER_OTHER
+} event_trace_sender_class;
+
+typedef enum event_trace_event_flags
+{
+    // Posted while another event was being dispatched or from another thread. Replay leaves these
+    // to be posted again by whoever posted them the first time.
+    EVENT_TRACE_FLAG_DERIVED = 0x1
+} event_trace_event_flags;
+
+b8 event_trace_initialize(u64* memory_requirement, void* state);
+void event_trace_shutdown(void* state);
+
+/**
+ * @brief Starts writing every posted event and every frame boundary to a trace file.
+ * 
+ * @param path the path of the trace file.
+ * @param program_sender the sender the program posts events with, to classify senders.
+ * @return b8 TRUE on success.
+*/
+HAPI b8 event_trace_start_recording(const char* path, void* program_sender);
+
+/**
+ * @brief Loads a trace to be fed back in place of platform input, one recorded frame per call
+ * to event_trace_replay_frame.
+ * 
+ * @param path the path of the trace file.
+ * @return b8 TRUE on success.
+*/
+HAPI b8 event_trace_start_replay(const char* path);
+
+// Stops recording or replaying. A replay logs the distribution of the frame times it was given.
+HAPI void event_trace_stop();
+
+HAPI b8 event_trace_is_recording();
+HAPI b8 event_trace_is_replaying();
+
+void event_trace_record_event(u16 code, void* sender, event_context data, b8 derived);
+void event_trace_record_frame(u64 frame_number, f64 delta_time);
+
+/**
+ * @brief Feeds the platform input of the next recorded frame back into the input and event systems.
+ * 
+ * @param out_delta_time the delta time the frame was recorded with.
+ * @return b8 FALSE when the trace has no more frames.
+*/
+b8 event_trace_replay_frame(f64* out_delta_time);
+
+void event_trace_replay_add_frame_time(f64 seconds);
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "frame_pacer.h"
+
+#include "core/atomic.h"
+#include "core/frame_stats.h"
+
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+
+
+#define FRAME_PACER_MIN_SPIN_MARGIN_NS 50000ull
+#define FRAME_PACER_MAX_SPIN_MARGIN_NS 4000000ull
+#define FRAME_PACER_CALIBRATION_SLEEPS 4
+#define FRAME_PACER_CALIBRATION_SLEEP_NS 500000ull
+
+static u64 clamp_margin(u64 margin_ns)
+{
+    if (margin_ns < FRAME_PACER_MIN_SPIN_MARGIN_NS) return FRAME_PACER_MIN_SPIN_MARGIN_NS;
+    if (margin_ns > FRAME_PACER_MAX_SPIN_MARGIN_NS) return FRAME_PACER_MAX_SPIN_MARGIN_NS;
+    return margin_ns;
+}
+
+static void record_deviation(frame_pacer* pacer, i64 deviation_ns)
+{
+    // A stall of more than two seconds is still recorded as the worst case.
+    if (deviation_ns > 0x7FFFFFFF) deviation_ns = 0x7FFFFFFF;
+    if (deviation_ns < -0x7FFFFFFF) deviation_ns = -0x7FFFFFFF;
+
+    pacer->deviations[pacer->history_index++ % FRAME_PACER_HISTORY] = (i32)deviation_ns;
+    pacer->frame_count++;
+}
+
+void frame_pacer_create(f64 target_rate, frame_pacer* out_pacer)
+{
+    hzero_memory(out_pacer, sizeof(frame_pacer));
+    frame_pacer_set_target_rate(out_pacer, target_rate);
+
+    // Measure how late short sleeps wake up so the first frames already spin for long enough.
+    u64 worst_oversleep_ns = 0;
+    for (u32 i = 0; i < FRAME_PACER_CALIBRATION_SLEEPS; ++i)
+    {
+        u64 target = platform_get_ticks_ns() + FRAME_PACER_CALIBRATION_SLEEP_NS;
+        platform_sleep_until_ns(target);
+        u64 now = platform_get_ticks_ns();
+        u64 oversleep_ns = now > target ? now - target : 0;
+        worst_oversleep_ns = oversleep_ns > worst_oversleep_ns ? oversleep_ns : worst_oversleep_ns;
+    }
+
+    out_pacer->spin_margin_ns = clamp_margin(worst_oversleep_ns + worst_oversleep_ns / 2);
+}
+
+void frame_pacer_set_target_rate(frame_pacer* pacer, f64 target_rate)
+{
+    pacer->target_frame_ns = target_rate > 0 ? (u64)(1000000000.0 / target_rate) : 0;
+    pacer->next_deadline_ns = 0;
+}
+
+void frame_pacer_wait(frame_pacer* pacer)
+{
+    if (pacer->target_frame_ns == 0)
+    {
+        return;
+    }
+
+    u64 now = platform_get_ticks_ns();
+    if (pacer->next_deadline_ns == 0)
+    {
+        pacer->next_deadline_ns = now + pacer->target_frame_ns;
+    }
+
+    u64 deadline = pacer->next_deadline_ns;
+
+    if (now >= deadline)
+    {
+        pacer->missed_deadlines++;
+        record_deviation(pacer, (i64)(now - deadline));
+
+        // Catching up on several frames at once would only produce a burst, so start over from now.
+        pacer->next_deadline_ns = now - deadline > pacer->target_frame_ns ? now + pacer->target_frame_ns : deadline + pacer->target_frame_ns;
+        return;
+    }
+
+    if (deadline - now > pacer->spin_margin_ns)
+    {
+        u64 sleep_target = deadline - pacer->spin_margin_ns;
+        platform_sleep_until_ns(sleep_target);
+        now = platform_get_ticks_ns();
+
+        // Grow quickly when a sleep overshoots, shrink slowly so a single fast wake does not cause a miss.
+        u64 oversleep_ns = now > sleep_target ? now - sleep_target : 0;
+        u64 wanted_margin = oversleep_ns + oversleep_ns / 2;
+        if (wanted_margin > pacer->spin_margin_ns)
+        {
+            pacer->spin_margin_ns = clamp_margin(wanted_margin);
+        }
+        else
+        {
+            pacer->spin_margin_ns = clamp_margin(pacer->spin_margin_ns - (pacer->spin_margin_ns - wanted_margin) / 50);
+        }
+    }
+
+    while (now < deadline)
+    {
+        atomic_cpu_relax();
+        now = platform_get_ticks_ns();
+    }
+
+    record_deviation(pacer, (i64)(now - deadline));
+    pacer->next_deadline_ns = deadline + pacer->target_frame_ns;
+}
+
+void frame_pacer_get_stats(const frame_pacer* pacer, frame_pacer_stats* out_stats)
+{
+    hzero_memory(out_stats, sizeof(frame_pacer_stats));
+    out_stats->frame_count = pacer->frame_count;
+    out_stats->missed_deadlines = pacer->missed_deadlines;
+
+    u32 count = pacer->frame_count < FRAME_PACER_HISTORY ? (u32)pacer->frame_count : FRAME_PACER_HISTORY;
+    f64 jitter[FRAME_PACER_HISTORY];
+    for (u32 i = 0; i < count; ++i)
+    {
+        i32 deviation = pacer->deviations[i];
+        jitter[i] = (deviation < 0 ? -(f64)deviation : (f64)deviation) * 0.000000001;
+    }
+
+    frame_stats_summary summary;
+    if (!frame_stats_summarize_samples(jitter, count, &summary))
+    {
+        return;
+    }
+
+    out_stats->mean_jitter = summary.average;
+    out_stats->max_jitter = summary.max;
+    out_stats->p99_jitter = summary.p99;
+}
\ No newline at end of file
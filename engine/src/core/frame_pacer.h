@@ -0,0 +1,52 @@
+#pragma once
+
+#include "defines.h"
+
+// Number of recent frames the jitter statistics are computed over.
+#define FRAME_PACER_HISTORY 256
+
+typedef struct frame_pacer_stats
+{
+    // Wake deviation from the frame deadline in seconds, positive when late.
+    f64 mean_jitter;
+    f64 max_jitter;
+    f64 p99_jitter;
+
+    u64 frame_count;
+    u64 missed_deadlines;
+} frame_pacer_stats;
+
+// Deadlines are platform_get_ticks_ns() values, only the rate and the stats are in seconds.
+typedef struct frame_pacer
+{
+    u64 target_frame_ns;
+    u64 next_deadline_ns;
+
+    // Time before the deadline where the pacer stops sleeping and spins, adapted to the observed oversleep.
+    u64 spin_margin_ns;
+
+    u64 frame_count;
+    u64 missed_deadlines;
+
+    u32 history_index;
+    // Wake deviations in nanoseconds, positive when late.
+    i32 deviations[FRAME_PACER_HISTORY];
+} frame_pacer;
+
+/**
+ * @brief Creates a pacer for the given rate and calibrates its spin margin against the platform sleep.
+ *
+ * @param target_rate frames per second, 0 leaves the pacer uncapped.
+ * @param out_pacer the pacer to initialize.
+ */
+HAPI void frame_pacer_create(f64 target_rate, frame_pacer* out_pacer);
+
+HAPI void frame_pacer_set_target_rate(frame_pacer* pacer, f64 target_rate);
+
+/**
+ * @brief Blocks until the next frame deadline. Deadlines are absolute, so time spent in the
+ * frame does not accumulate drift. Falls back into step if more than a frame behind.
+ */
+HAPI void frame_pacer_wait(frame_pacer* pacer);
+
+HAPI void frame_pacer_get_stats(const frame_pacer* pacer, frame_pacer_stats* out_stats);
\ No newline at end of file
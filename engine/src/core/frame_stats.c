@@ -0,0 +1,236 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "frame_stats.h"
+
+#include "core/logger.h"
+#include "core/hstring.h"
+
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct frame_stats_state
+{
+    frame_stats_config config;
+
+    f32 samples[FRAME_PHASE_COUNT][FRAME_STATS_WINDOW];
+    f64 current[FRAME_PHASE_COUNT];
+    f64 budgets[FRAME_PHASE_COUNT];
+
+    u64 frame_count;
+    f64 last_log_time;
+
+    file_handle csv_file;
+} frame_stats_state;
+
+static frame_stats_state* state_ptr;
+
+// Frame rates worth telling apart: 500, 240, 120, 60, 30, 20 and 10 fps.
+static const f64 histogram_edges[FRAME_STATS_HISTOGRAM_BUCKETS] = {2.0, 4.167, 8.333, 16.667, 33.333, 50.0, 100.0, 0.0};
+
+static const char* phase_names[FRAME_PHASE_COUNT] = {"update", "render", "present", "total"};
+
+b8 frame_stats_initialize(u64* memory_requirement, void* state, const frame_stats_config* config)
+{
+    *memory_requirement = sizeof(frame_stats_state);
+
+    if (!state) return FALSE;
+
+    state_ptr = state;
+    hzero_memory(state_ptr, sizeof(frame_stats_state));
+    if (config)
+    {
+        state_ptr->config = *config;
+    }
+    state_ptr->last_log_time = platform_get_absolute_time();
+
+    if (state_ptr->config.csv_path)
+    {
+        if (filesystem_open(state_ptr->config.csv_path, FILE_MODE_WRITE, FALSE, &state_ptr->csv_file))
+        {
+            filesystem_write_line(&state_ptr->csv_file, "frame,update_ms,render_ms,present_ms,total_ms");
+        }
+        else
+        {
+            HWARN("Unable to open frame stats CSV '%s', frame times will not be written.", state_ptr->config.csv_path);
+        }
+    }
+
+    return TRUE;
+}
+
+void frame_stats_shutdown(void* state)
+{
+    if (!state_ptr) return;
+
+    if (state_ptr->csv_file.is_valid)
+    {
+        filesystem_close(&state_ptr->csv_file);
+    }
+
+    state_ptr = 0;
+}
+
+void frame_stats_add_phase_time(frame_phase phase, f64 seconds)
+{
+    if (!state_ptr || phase >= FRAME_PHASE_COUNT) return;
+
+    state_ptr->current[phase] += seconds;
+}
+
+void frame_stats_log_summaries()
+{
+    for (u32 p = 0; p < FRAME_PHASE_COUNT; ++p)
+    {
+        frame_stats_summary summary;
+        if (!frame_stats_get_summary(p, &summary)) continue;
+
+        HINFO("Frame %-7s min %6.2fms avg %6.2fms p50 %6.2fms p95 %6.2fms p99 %6.2fms max %6.2fms over budget %u/%u",
+            phase_names[p], summary.min * 1000.0, summary.average * 1000.0, summary.p50 * 1000.0,
+            summary.p95 * 1000.0, summary.p99 * 1000.0, summary.max * 1000.0, summary.over_budget_count, summary.sample_count);
+    }
+
+    frame_stats_summary total;
+    if (frame_stats_get_summary(FRAME_PHASE_TOTAL, &total))
+    {
+        char line[256];
+        i32 length = snprintf(line, sizeof(line), "Frame histogram (ms):");
+        for (u32 i = 0; i < FRAME_STATS_HISTOGRAM_BUCKETS && length < (i32)sizeof(line); ++i)
+        {
+            if (histogram_edges[i] > 0)
+            {
+                length += snprintf(line + length, sizeof(line) - length, " <%.1f:%u", histogram_edges[i], total.histogram[i]);
+            }
+            else
+            {
+                length += snprintf(line + length, sizeof(line) - length, " more:%u", total.histogram[i]);
+            }
+        }
+        HINFO("%s", line);
+    }
+}
+
+void frame_stats_end_frame(f64 total_seconds)
+{
+    if (!state_ptr) return;
+
+    state_ptr->current[FRAME_PHASE_TOTAL] = total_seconds;
+
+    u32 slot = state_ptr->frame_count % FRAME_STATS_WINDOW;
+    for (u32 p = 0; p < FRAME_PHASE_COUNT; ++p)
+    {
+        state_ptr->samples[p][slot] = (f32)state_ptr->current[p];
+
+        if (state_ptr->budgets[p] > 0 && state_ptr->current[p] > state_ptr->budgets[p])
+        {
+            HWARN_LIMITED("Frame %s took %.2fms, over its %.2fms budget.", phase_names[p], state_ptr->current[p] * 1000.0, state_ptr->budgets[p] * 1000.0);
+        }
+    }
+
+    if (state_ptr->csv_file.is_valid)
+    {
+        char line[128];
+        snprintf(line, sizeof(line), "%llu,%.4f,%.4f,%.4f,%.4f", (unsigned long long)state_ptr->frame_count,
+            state_ptr->current[FRAME_PHASE_UPDATE] * 1000.0, state_ptr->current[FRAME_PHASE_RENDER] * 1000.0,
+            state_ptr->current[FRAME_PHASE_PRESENT] * 1000.0, state_ptr->current[FRAME_PHASE_TOTAL] * 1000.0);
+        filesystem_write_line(&state_ptr->csv_file, line);
+    }
+
+    state_ptr->frame_count++;
+    hzero_memory(state_ptr->current, sizeof(state_ptr->current));
+
+    if (state_ptr->config.log_interval > 0)
+    {
+        f64 now = platform_get_absolute_time();
+        if (now - state_ptr->last_log_time >= state_ptr->config.log_interval)
+        {
+            state_ptr->last_log_time = now;
+            frame_stats_log_summaries();
+        }
+    }
+}
+
+static i32 compare_f64(const void* a, const void* b)
+{
+    f64 fa = *(const f64*)a;
+    f64 fb = *(const f64*)b;
+    return fa < fb ? -1 : (fa > fb ? 1 : 0);
+}
+
+b8 frame_stats_summarize_samples(f64* samples, u32 count, frame_stats_summary* out_summary)
+{
+    hzero_memory(out_summary, sizeof(frame_stats_summary));
+    if (count == 0) return FALSE;
+
+    qsort(samples, count, sizeof(f64), compare_f64);
+
+    f64 total = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        total += samples[i];
+    }
+
+    out_summary->sample_count = count;
+    out_summary->min = samples[0];
+    out_summary->max = samples[count - 1];
+    out_summary->average = total / count;
+    out_summary->p50 = samples[(count - 1) * 50 / 100];
+    out_summary->p95 = samples[(count - 1) * 95 / 100];
+    out_summary->p99 = samples[(count - 1) * 99 / 100];
+
+    return TRUE;
+}
+
+b8 frame_stats_get_summary(frame_phase phase, frame_stats_summary* out_summary)
+{
+    hzero_memory(out_summary, sizeof(frame_stats_summary));
+    if (!state_ptr || phase >= FRAME_PHASE_COUNT) return FALSE;
+
+    u32 count = state_ptr->frame_count < FRAME_STATS_WINDOW ? (u32)state_ptr->frame_count : FRAME_STATS_WINDOW;
+    f64 samples[FRAME_STATS_WINDOW];
+    for (u32 i = 0; i < count; ++i)
+    {
+        samples[i] = state_ptr->samples[phase][i];
+    }
+
+    if (!frame_stats_summarize_samples(samples, count, out_summary)) return FALSE;
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        f64 sample = samples[i];
+        if (state_ptr->budgets[phase] > 0 && sample > state_ptr->budgets[phase])
+        {
+            out_summary->over_budget_count++;
+        }
+
+        u32 bucket = 0;
+        while (bucket < FRAME_STATS_HISTOGRAM_BUCKETS - 1 && sample * 1000.0 >= histogram_edges[bucket])
+        {
+            bucket++;
+        }
+        out_summary->histogram[bucket]++;
+    }
+
+    return TRUE;
+}
+
+void frame_stats_set_budget(frame_phase phase, f64 seconds)
+{
+    if (!state_ptr || phase >= FRAME_PHASE_COUNT) return;
+
+    state_ptr->budgets[phase] = seconds > 0 ? seconds : 0;
+}
+
+const f64* frame_stats_histogram_edges()
+{
+    return histogram_edges;
+}
+
+const char* frame_phase_name(frame_phase phase)
+{
+    return phase < FRAME_PHASE_COUNT ? phase_names[phase] : "unknown";
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "defines.h"
+
+// Frames kept for the rolling statistics.
+#define FRAME_STATS_WINDOW 240
+#define FRAME_STATS_HISTOGRAM_BUCKETS 8
+
+typedef enum frame_phase
+{
+    FRAME_PHASE_UPDATE,
+    FRAME_PHASE_RENDER,
+    // Handing the frame to the window system, including any wait for vsync.
+    FRAME_PHASE_PRESENT,
+    // CPU time of the whole frame, excluding the wait for the next one.
+    FRAME_PHASE_TOTAL,
+
+    FRAME_PHASE_COUNT
+} frame_phase;
+
+typedef struct frame_stats_summary
+{
+    // Seconds over the rolling window.
+    f64 min;
+    f64 average;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+    f64 max;
+
+    u32 sample_count;
+    // Frames in the window over the phase budget, if one is set.
+    u32 over_budget_count;
+
+    // Frame counts per bucket, bucket i holds frames under frame_stats_histogram_edges()[i] milliseconds.
+    u32 histogram[FRAME_STATS_HISTOGRAM_BUCKETS];
+} frame_stats_summary;
+
+typedef struct frame_stats_config
+{
+    // Log a summary every this many seconds, 0 disables it.
+    f64 log_interval;
+    // Append every frame's phase times to this CSV file, if set.
+    const char* csv_path;
+} frame_stats_config;
+
+b8 frame_stats_initialize(u64* memory_requirement, void* state, const frame_stats_config* config);
+void frame_stats_shutdown(void* state);
+
+// Adds time to a phase of the frame in progress, a phase may be timed in several pieces.
+HAPI void frame_stats_add_phase_time(frame_phase phase, f64 seconds);
+
+/**
+ * @brief Closes the frame in progress and adds it to the rolling window.
+ *
+ * @param total_seconds the CPU time of the whole frame, stored as FRAME_PHASE_TOTAL.
+ */
+HAPI void frame_stats_end_frame(f64 total_seconds);
+
+HAPI b8 frame_stats_get_summary(frame_phase phase, frame_stats_summary* out_summary);
+
+/**
+ * @brief Summarizes any set of samples the way the rolling window is, for statistics kept outside of it.
+ * Fills the sample count, min, average, percentiles and max in the samples' unit, budget and histogram are left at 0.
+ *
+ * @param samples the samples, sorted in place.
+ * @param count the number of samples.
+ * @param out_summary the summary to fill.
+ * @return FALSE if there are no samples.
+ */
+HAPI b8 frame_stats_summarize_samples(f64* samples, u32 count, frame_stats_summary* out_summary);
+
+// Logs every phase's summary and the total frame time histogram.
+HAPI void frame_stats_log_summaries();
+
+/**
+ * @brief Sets a time budget for a phase. Frames over it are counted and reported as warnings.
+ *
+ * @param phase the phase to budget.
+ * @param seconds the budget, 0 removes it.
+ */
+HAPI void frame_stats_set_budget(frame_phase phase, f64 seconds);
+
+// Upper edges of the histogram buckets in milliseconds, the last bucket is unbounded.
+HAPI const f64* frame_stats_histogram_edges();
+
+HAPI const char* frame_phase_name(frame_phase phase);
\ No newline at end of file
@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_INPUT
+
 #include "input.h"
 
 #include "memory/hmemory.h"
@@ -24,6 +26,17 @@ typedef struct input_system_state
     mouse_state mouse_current;
     mouse_state mouse_previous;
 
+    // Ring of transitions. write_count only grows; the current frame starts at frame_start.
+    input_transition transitions[INPUT_TRANSITION_CAPACITY];
+    u32 write_count;
+    u32 frame_start;
+    // First transition the previous state has not caught up with. Only input_update moves it,
+    // so frames that ran no fixed update are caught up by the next one that does.
+    u32 update_start;
+
+    input_latency_stats latency;
+    u64 latency_total_ns;
+
     b8 is_initialized;
 } input_system_state;
 
@@ -51,6 +64,12 @@ void input_shutdown(void* state)
     state_ptr = 0;
 }
 
+static void push_transition(input_transition* transition)
+{
+    state_ptr->transitions[state_ptr->write_count % INPUT_TRANSITION_CAPACITY] = *transition;
+    state_ptr->write_count++;
+}
+
 void input_update(f64 delta_time)
 {
     if (!state_ptr->is_initialized)
@@ -58,8 +77,103 @@ void input_update(f64 delta_time)
         return;
     }
 
-    hcopy_memory(&state_ptr->keyboard_previous, &state_ptr->keyboard_current, sizeof(keyboard_state));
-    hcopy_memory(&state_ptr->mouse_previous, &state_ptr->mouse_current, sizeof(mouse_state));
+    u32 count = state_ptr->write_count - state_ptr->update_start;
+    if (count > INPUT_TRANSITION_CAPACITY)
+    {
+        // Some transitions were overwritten, so the touched entries are unknown.
+        hcopy_memory(&state_ptr->keyboard_previous, &state_ptr->keyboard_current, sizeof(keyboard_state));
+        hcopy_memory(&state_ptr->mouse_previous, &state_ptr->mouse_current, sizeof(mouse_state));
+    }
+    else
+    {
+        // Only what changed since the last update needs to catch up.
+        for (u32 i = state_ptr->update_start; i != state_ptr->write_count; ++i)
+        {
+            input_transition* t = &state_ptr->transitions[i % INPUT_TRANSITION_CAPACITY];
+            switch (t->type)
+            {
+                case INPUT_TRANSITION_KEY:
+                    state_ptr->keyboard_previous.keys[t->code] = state_ptr->keyboard_current.keys[t->code];
+                    break;
+                case INPUT_TRANSITION_BUTTON:
+                    state_ptr->mouse_previous.buttons[t->code] = state_ptr->mouse_current.buttons[t->code];
+                    break;
+                case INPUT_TRANSITION_MOUSE_MOVE:
+                    state_ptr->mouse_previous.x = state_ptr->mouse_current.x;
+                    state_ptr->mouse_previous.y = state_ptr->mouse_current.y;
+                    break;
+                case INPUT_TRANSITION_MOUSE_WHEEL:
+                    break;
+            }
+        }
+    }
+
+    state_ptr->update_start = state_ptr->write_count;
+}
+
+u32 input_get_transition_count()
+{
+    if (!state_ptr || !state_ptr->is_initialized)
+    {
+        return 0;
+    }
+
+    u32 count = state_ptr->write_count - state_ptr->frame_start;
+    return count > INPUT_TRANSITION_CAPACITY ? INPUT_TRANSITION_CAPACITY : count;
+}
+
+b8 input_get_transition(u32 index, input_transition* out_transition)
+{
+    u32 count = input_get_transition_count();
+    if (index >= count)
+    {
+        return FALSE;
+    }
+
+    u32 first = state_ptr->write_count - count;
+    *out_transition = state_ptr->transitions[(first + index) % INPUT_TRANSITION_CAPACITY];
+    return TRUE;
+}
+
+void input_frame_submitted(u64 submit_time)
+{
+    u32 count = input_get_transition_count();
+
+    input_latency_stats* stats = &state_ptr->latency;
+    for (u32 i = 0; i < count; ++i)
+    {
+        input_transition t;
+        input_get_transition(i, &t);
+
+        u64 latency_ns = submit_time > t.timestamp ? submit_time - t.timestamp : 0;
+        f64 latency = latency_ns * 0.000000001;
+        if (i == 0)
+        {
+            stats->last_frame_latency = latency;
+        }
+
+        stats->max_latency = latency > stats->max_latency ? latency : stats->max_latency;
+        state_ptr->latency_total_ns += latency_ns;
+        stats->sample_count++;
+    }
+
+    if (stats->sample_count)
+    {
+        stats->average_latency = (f64)state_ptr->latency_total_ns / stats->sample_count * 0.000000001;
+    }
+
+    state_ptr->frame_start = state_ptr->write_count;
+}
+
+void input_get_latency_stats(input_latency_stats* out_stats)
+{
+    if (!state_ptr)
+    {
+        hzero_memory(out_stats, sizeof(input_latency_stats));
+        return;
+    }
+
+    *out_stats = state_ptr->latency;
 }
 
 b8 input_is_key_down(keys key)
@@ -102,7 +216,7 @@ b8 input_was_key_up(keys key)
     return state_ptr->keyboard_previous.keys[key] == FALSE;
 }
 
-void input_process_key(keys key, b8 pressed)
+void input_process_key(keys key, b8 pressed, u64 timestamp)
 {
     if (state_ptr && state_ptr->keyboard_current.keys[key] == pressed)
     {
@@ -111,9 +225,16 @@ void input_process_key(keys key, b8 pressed)
 
     state_ptr->keyboard_current.keys[key] = pressed;
 
-    event_context context;
+    input_transition transition = {};
+    transition.timestamp = timestamp;
+    transition.type = INPUT_TRANSITION_KEY;
+    transition.code = key;
+    transition.pressed = pressed;
+    push_transition(&transition);
+
+    event_context context = {};
     context.data.u16[0] = key;
-    event_post(pressed ? EVENT_KEY_PRESSED : EVENT_KEY_RELEASED, 0, context);
+    event_enqueue(pressed ? EVENT_KEY_PRESSED : EVENT_KEY_RELEASED, 0, context);
 }
 
 b8 input_is_button_down(buttons button)
@@ -183,7 +304,7 @@ void input_get_previous_mouse_position(i32* x, i32* y)
     *y = state_ptr->mouse_previous.y;
 }
 
-void input_process_button(buttons button, b8 pressed)
+void input_process_button(buttons button, b8 pressed, u64 timestamp)
 {
     if (state_ptr->mouse_current.buttons[button] == pressed)
     {
@@ -192,12 +313,19 @@ void input_process_button(buttons button, b8 pressed)
 
     state_ptr->mouse_current.buttons[button] = pressed;
 
-    event_context context;
+    input_transition transition = {};
+    transition.timestamp = timestamp;
+    transition.type = INPUT_TRANSITION_BUTTON;
+    transition.code = button;
+    transition.pressed = pressed;
+    push_transition(&transition);
+
+    event_context context = {};
     context.data.u16[0] = button;
-    event_post(pressed ? EVENT_BUTTON_PRESSED : EVENT_BUTTON_RELEASED, 0, context);
+    event_enqueue(pressed ? EVENT_BUTTON_PRESSED : EVENT_BUTTON_RELEASED, 0, context);
 }
 
-void input_process_mouse_move(i16 x, i16 y)
+void input_process_mouse_move(i16 x, i16 y, u64 timestamp)
 {
     if (state_ptr->mouse_current.x == x && state_ptr->mouse_current.y == y)
     {
@@ -207,15 +335,28 @@ void input_process_mouse_move(i16 x, i16 y)
     state_ptr->mouse_current.x = x;
     state_ptr->mouse_current.y = y;
 
-    event_context context;
+    input_transition transition = {};
+    transition.timestamp = timestamp;
+    transition.type = INPUT_TRANSITION_MOUSE_MOVE;
+    transition.x = x;
+    transition.y = y;
+    push_transition(&transition);
+
+    event_context context = {};
     context.data.i16[0] = x;
     context.data.i16[1] = y;
-    event_post(EVENT_MOUSE_MOVED, 0, context);
+    event_enqueue(EVENT_MOUSE_MOVED, 0, context);
 }
 
-void input_process_mouse_wheel(i8 z_delta)
+void input_process_mouse_wheel(i8 z_delta, u64 timestamp)
 {
-    event_context context;
+    input_transition transition = {};
+    transition.timestamp = timestamp;
+    transition.type = INPUT_TRANSITION_MOUSE_WHEEL;
+    transition.wheel_delta = z_delta;
+    push_transition(&transition);
+
+    event_context context = {};
     context.data.i8[0] = z_delta;
-    event_post(EVENT_MOUSE_WHEEL, 0, context);
+    event_enqueue(EVENT_MOUSE_WHEEL, 0, context);
 }
\ No newline at end of file
@@ -143,6 +143,42 @@ typedef enum keys
     KEYS_MAX_KEYS
 } keys;
 
+typedef enum input_transition_type
+{
+    INPUT_TRANSITION_KEY,
+    INPUT_TRANSITION_BUTTON,
+    INPUT_TRANSITION_MOUSE_MOVE,
+    INPUT_TRANSITION_MOUSE_WHEEL
+} input_transition_type;
+
+// A single change of input state, in the order the platform received it.
+typedef struct input_transition
+{
+    // platform_get_ticks_ns() when the platform received the input.
+    u64 timestamp;
+    input_transition_type type;
+    // The key or button.
+    u16 code;
+    b8 pressed;
+    i16 x;
+    i16 y;
+    i8 wheel_delta;
+} input_transition;
+
+// Time from the platform receiving input to the frame that reflects it being submitted, in seconds.
+typedef struct input_latency_stats
+{
+    // Latency of the oldest transition in the last frame that had any.
+    f64 last_frame_latency;
+    f64 average_latency;
+    f64 max_latency;
+    u64 sample_count;
+} input_latency_stats;
+
+// Transitions kept per frame, more than this in one frame are still applied but not listed.
+// A frame's transitions are kept until input_frame_submitted, input_update may run any number of times in between, including none.
+#define INPUT_TRANSITION_CAPACITY 256
+
 b8 input_initialize(u64* memeory_requirement, void* state);
 void input_shutdown(void* state);
 
@@ -153,7 +189,7 @@ HAPI b8 input_is_key_up(keys key);
 HAPI b8 input_was_key_down(keys key);
 HAPI b8 input_was_key_up(keys key);
 
-void input_process_key(keys key, b8 pressed);
+void input_process_key(keys key, b8 pressed, u64 timestamp);
 
 HAPI b8 input_is_button_down(buttons button);
 HAPI b8 input_is_button_up(buttons button);
@@ -162,6 +198,28 @@ HAPI b8 input_was_button_up(buttons button);
 HAPI void input_get_mouse_position(i32* x, i32* y);
 HAPI void input_get_previous_mouse_position(i32* x, i32* y);
 
-void input_process_button(buttons button, b8 pressed);
-void input_process_mouse_move(i16 x, i16 y);
-void input_process_mouse_wheel(i8 z_delta);
\ No newline at end of file
+void input_process_button(buttons button, b8 pressed, u64 timestamp);
+void input_process_mouse_move(i16 x, i16 y, u64 timestamp);
+void input_process_mouse_wheel(i8 z_delta, u64 timestamp);
+
+/**
+ * @brief Gets the number of input transitions received since the last submitted frame.
+ * 
+ * @return u32 the transition count, at most INPUT_TRANSITION_CAPACITY.
+*/
+HAPI u32 input_get_transition_count();
+
+/**
+ * @brief Gets a transition received since the last submitted frame, oldest first.
+ * Unlike the polled state this sees every press and release, even when both happen within one frame.
+ * 
+ * @param index the index of the transition, less than input_get_transition_count().
+ * @param out_transition a pointer to hold the transition.
+ * @return b8 TRUE if the index was valid.
+*/
+HAPI b8 input_get_transition(u32 index, input_transition* out_transition);
+
+// Called when the frame that consumed the current transitions has been submitted. Measures latency and starts the next frame's transitions.
+void input_frame_submitted(u64 submit_time);
+
+HAPI void input_get_latency_stats(input_latency_stats* out_stats);
\ No newline at end of file
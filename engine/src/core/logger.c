@@ -1,7 +1,9 @@
 #include "logger.h"
 #include "asserts.h"
+#include "binary_log.h"
 
 #include "core/hstring.h"
+#include "core/atomic.h"
 
 #include "memory/hmemory.h"
 
@@ -13,10 +15,16 @@
 typedef struct logger_system_state
 {
     file_handle log_file_handle;
+    b8 binary_mode;
 } logger_system_state;
 
 static logger_system_state* state_ptr;
 
+// Stored as distance from LOG_TRACE so that zeroed storage logs everything, even before initialization.
+static u8 category_quiet_levels[LOG_CATEGORY_COUNT];
+
+static log_site* volatile registered_sites;
+
 static const char* log_level_strings[6] = {"[FATAL]", "[ERROR]", "[WARN]", "[INFO]", "[DEBUG]", "[TRACE]"};
 
 void append_to_log_file(const char* message)
@@ -33,11 +41,16 @@ void append_to_log_file(const char* message)
 
 b8 logger_initialize(u64* memory_requirement, void* state)
 {
-    *memory_requirement = sizeof(logger_system_state);
+    u64 binary_log_requirement = 0;
+    binary_log_initialize(&binary_log_requirement, 0);
+    *memory_requirement = sizeof(logger_system_state) + binary_log_requirement;
 
     if (!state) return FALSE;
     
     state_ptr = state;
+    state_ptr->binary_mode = FALSE;
+
+    binary_log_initialize(&binary_log_requirement, state + sizeof(logger_system_state));
 
     if (!filesystem_open("console.log", FILE_MODE_WRITE, FALSE, &state_ptr->log_file_handle))
     {
@@ -54,6 +67,18 @@ b8 logger_initialize(u64* memory_requirement, void* state)
 
 void logger_shutdown(void* state)
 {
+    for (log_site* site = registered_sites; site; site = site->next)
+    {
+        u64 total_suppressed = atomic_load_u64(&site->total_suppressed) + atomic_exchange_u32(&site->window_suppressed, 0);
+        if (total_suppressed)
+        {
+            logger_log(LOG_WARN, "%s:%d suppressed %llu messages in total.", site->file, site->line, total_suppressed);
+        }
+    }
+
+    logger_set_binary_mode(FALSE);
+    binary_log_shutdown(state + sizeof(logger_system_state));
+
     filesystem_close(&state_ptr->log_file_handle);
 
     state_ptr = 0;
@@ -61,17 +86,106 @@ void logger_shutdown(void* state)
     HINFO("Logger subsystem shut down successfully.");
 }
 
-void logger_log(log_level level, const char* message, ...)
+b8 logger_set_binary_mode(b8 enabled)
+{
+    if (!state_ptr) return FALSE;
+
+    if (enabled == state_ptr->binary_mode) return TRUE;
+
+    if (enabled)
+    {
+        if (!binary_log_open("console.hlog"))
+        {
+            platform_console_write_error("ERROR: Unable to open console.hlog for writing", LOG_ERROR);
+            return FALSE;
+        }
+    }
+    else
+    {
+        binary_log_close();
+    }
+
+    state_ptr->binary_mode = enabled;
+    return TRUE;
+}
+
+const char* logger_level_string(log_level level)
+{
+    return level <= LOG_TRACE ? log_level_strings[level] : "[UNKNOWN]";
+}
+
+b8 logger_level_enabled(log_category category, log_level level)
+{
+    return level == LOG_FATAL || (u32)level + category_quiet_levels[category] <= LOG_TRACE;
+}
+
+void logger_set_category_level(log_category category, log_level max_level)
+{
+    category_quiet_levels[category] = LOG_TRACE - max_level;
+}
+
+log_level logger_get_category_level(log_category category)
+{
+    return LOG_TRACE - category_quiet_levels[category];
+}
+
+b8 logger_site_admit(log_site* site)
+{
+    u32 unregistered = FALSE;
+    if (!atomic_load_u32(&site->registered) && atomic_compare_exchange_u32(&site->registered, &unregistered, TRUE))
+    {
+        void* head = atomic_load_ptr((void* volatile*)&registered_sites);
+        do
+        {
+            site->next = head;
+        } while (!atomic_compare_exchange_ptr((void* volatile*)&registered_sites, &head, site));
+    }
+
+    u64 now = platform_get_ticks_ns();
+    u64 window_start = atomic_load_u64(&site->window_start_ns);
+
+    // Only the thread that moves the window forward reports and resets it.
+    if (now - window_start >= LOG_SITE_WINDOW_NS && atomic_compare_exchange_u64(&site->window_start_ns, &window_start, now))
+    {
+        atomic_store_u32(&site->window_count, 0);
+        u32 suppressed = atomic_exchange_u32(&site->window_suppressed, 0);
+        if (suppressed)
+        {
+            logger_log(LOG_WARN, "%s:%d suppressed %u messages.", site->file, site->line, suppressed);
+            atomic_fetch_add_u64(&site->total_suppressed, suppressed);
+        }
+    }
+
+    if (atomic_fetch_add_u32(&site->window_count, 1) < LOG_SITE_LIMIT)
+    {
+        return TRUE;
+    }
+
+    atomic_fetch_add_u32(&site->window_suppressed, 1);
+    return FALSE;
+}
+
+static void log_message_v(log_level level, const char* message, va_list args)
 {
     b8 is_error = level < 2;
 
+    if (state_ptr && state_ptr->binary_mode)
+    {
+        va_list binary_args;
+        va_copy(binary_args, args);
+        binary_log_write(level, message, &binary_args);
+        va_end(binary_args);
+
+        if (!is_error) return;
+
+        // Make sure the record leading up to an error survives a crash.
+        binary_log_flush();
+    }
+
     char out_message[32000];
     hzero_memory(out_message, sizeof(out_message));
 
-    va_list arg_ptr;
-    va_start(arg_ptr, message);
-    string_format_v(out_message, message, arg_ptr);
-    va_end(arg_ptr);
+    string_format_v(out_message, message, args);
 
     string_format(out_message, "%s %s\n", log_level_strings[level], out_message);
 
@@ -85,7 +199,24 @@ void logger_log(log_level level, const char* message, ...)
     }
 
     append_to_log_file(out_message);
+}
+
+void logger_log(log_level level, const char* message, ...)
+{
+    va_list arg_ptr;
+    va_start(arg_ptr, message);
+    log_message_v(level, message, arg_ptr);
+    va_end(arg_ptr);
+}
+
+void logger_log_category(log_category category, log_level level, const char* message, ...)
+{
+    if (!logger_level_enabled(category, level)) return;
 
+    va_list arg_ptr;
+    va_start(arg_ptr, message);
+    log_message_v(level, message, arg_ptr);
+    va_end(arg_ptr);
 }
 
 void report_assertion_failure(const char* expression, const char* message, const char* file, i32 line)
@@ -12,6 +12,39 @@ typedef enum log_level
     LOG_TRACE   = 5
 } log_level;
 
+typedef enum log_category
+{
+    LOG_CATEGORY_GENERAL,
+    LOG_CATEGORY_CORE,
+    LOG_CATEGORY_MEMORY,
+    LOG_CATEGORY_PLATFORM,
+    LOG_CATEGORY_INPUT,
+    LOG_CATEGORY_RENDERER,
+    LOG_CATEGORY_RESOURCE,
+
+    LOG_CATEGORY_COUNT
+} log_category;
+
+// Per call site state for the _LIMITED macros. Sites register themselves on first use.
+// Updated atomically from any thread, every suppressed message is counted once. Threads
+// racing a window change may get a few more than LOG_SITE_LIMIT messages through.
+typedef struct log_site
+{
+    const char* file;
+    i32 line;
+    volatile u32 registered;
+    volatile u32 window_count;
+    volatile u32 window_suppressed;
+    volatile u64 total_suppressed;
+    // platform_get_ticks_ns() when the current window started.
+    volatile u64 window_start_ns;
+    struct log_site* next;
+} log_site;
+
+// Messages admitted per call site within each window before the rest are suppressed.
+#define LOG_SITE_LIMIT 5
+#define LOG_SITE_WINDOW_NS 1000000000ull
+
 /**
  * @brief Initializes logger subsystem. Call twice; once with state = 0 to get
  * required memory size, then a second time passing allocated memory for internal state.
@@ -31,17 +64,101 @@ HAPI void logger_shutdown(void* state);
 
 HAPI void logger_log(log_level log_severity, const char* message, ...);
 
-#define HFATAL(message, ...) logger_log(LOG_FATAL, message, ##__VA_ARGS__);
-#define HERROR(message, ...) logger_log(LOG_ERROR, message, ##__VA_ARGS__);
+HAPI void logger_log_category(log_category category, log_level log_severity, const char* message, ...);
+
+/**
+ * @brief Checks the runtime level of a category. The logging macros call this
+ * before any argument is formatted.
+ * 
+ * @param category the category to check.
+ * @param log_severity the severity of the message.
+ * @return b8 TRUE if the message should be logged.
+*/
+HAPI b8 logger_level_enabled(log_category category, log_level log_severity);
+
+/**
+ * @brief Sets the most verbose level logged for a category at runtime.
+ * Fatal messages are always logged.
+ * 
+ * @param category the category to change.
+ * @param max_level the most verbose level that is still logged.
+*/
+HAPI void logger_set_category_level(log_category category, log_level max_level);
+
+HAPI log_level logger_get_category_level(log_category category);
+
+/**
+ * @brief Decides if a rate limited call site may log right now. Suppressed messages are
+ * counted and summarized when the site logs again and when the logger shuts down.
+ * 
+ * @param site the static state of the call site.
+ * @return b8 TRUE if the message should be logged.
+*/
+HAPI b8 logger_site_admit(log_site* site);
+
+/**
+ * @brief Switches the logger between formatted text output and binary records.
+ * In binary mode messages are stored as a format id, timestamp and raw arguments in
+ * console.hlog and formatted offline by the log decoder tool. Errors are still
+ * formatted and written to the console immediately.
+ * 
+ * @param enabled TRUE to record binary messages, FALSE to return to text output.
+ * @return b8 TRUE on success.
+*/
+HAPI b8 logger_set_binary_mode(b8 enabled);
+
+HAPI const char* logger_level_string(log_level level);
 
+// Files may define HLOG_CATEGORY before their includes to log under their own category.
+#ifndef HLOG_CATEGORY
+#define HLOG_CATEGORY LOG_CATEGORY_GENERAL
+#endif
+
+// Compile-time minimum level; calls above it are removed entirely. Uses the numeric log_level values.
+#ifndef HLOG_LEVEL
 #if HRELEASE == 1
-#define HWARN (message, ...)
-#define HINFO (message, ...)
+#define HLOG_LEVEL 1
+#else
+#define HLOG_LEVEL 5
+#endif
+#endif
+
+#define HLOG(level, message, ...) do { if (logger_level_enabled(HLOG_CATEGORY, level)) logger_log_category(HLOG_CATEGORY, level, message, ##__VA_ARGS__); } while (0);
+
+#define HLOG_LIMITED(level, message, ...) do { static log_site hlog_site = {__FILE__, __LINE__}; if (logger_level_enabled(HLOG_CATEGORY, level) && logger_site_admit(&hlog_site)) logger_log_category(HLOG_CATEGORY, level, message, ##__VA_ARGS__); } while (0);
+
+#define HFATAL(message, ...) HLOG(LOG_FATAL, message, ##__VA_ARGS__)
+#define HERROR(message, ...) HLOG(LOG_ERROR, message, ##__VA_ARGS__)
+#define HERROR_LIMITED(message, ...) HLOG_LIMITED(LOG_ERROR, message, ##__VA_ARGS__)
+
+#if HLOG_LEVEL >= 2
+#define HWARN(message, ...) HLOG(LOG_WARN, message, ##__VA_ARGS__)
+#define HWARN_LIMITED(message, ...) HLOG_LIMITED(LOG_WARN, message, ##__VA_ARGS__)
+#else
+#define HWARN(message, ...)
+#define HWARN_LIMITED(message, ...)
+#endif
+
+#if HLOG_LEVEL >= 3
+#define HINFO(message, ...) HLOG(LOG_INFO, message, ##__VA_ARGS__)
+#define HINFO_LIMITED(message, ...) HLOG_LIMITED(LOG_INFO, message, ##__VA_ARGS__)
+#else
+#define HINFO(message, ...)
+#define HINFO_LIMITED(message, ...)
+#endif
+
+#if HLOG_LEVEL >= 4
+#define HDEBUG(message, ...) HLOG(LOG_DEBUG, message, ##__VA_ARGS__)
+#define HDEBUG_LIMITED(message, ...) HLOG_LIMITED(LOG_DEBUG, message, ##__VA_ARGS__)
+#else
 #define HDEBUG(message, ...)
-#define HTRACE(message, ...)
+#define HDEBUG_LIMITED(message, ...)
+#endif
+
+#if HLOG_LEVEL >= 5
+#define HTRACE(message, ...) HLOG(LOG_TRACE, message, ##__VA_ARGS__)
+#define HTRACE_LIMITED(message, ...) HLOG_LIMITED(LOG_TRACE, message, ##__VA_ARGS__)
 #else
-#define HWARN(message, ...) logger_log(LOG_WARN, message, ##__VA_ARGS__);
-#define HINFO(message, ...) logger_log(LOG_INFO, message, ##__VA_ARGS__);
-#define HDEBUG(message, ...) logger_log(LOG_DEBUG, message, ##__VA_ARGS__);
-#define HTRACE(message, ...) logger_log(LOG_TRACE, message, ##__VA_ARGS__);
+#define HTRACE(message, ...)
+#define HTRACE_LIMITED(message, ...)
 #endif
\ No newline at end of file
@@ -0,0 +1,248 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "profiler.h"
+
+#include "core/logger.h"
+#include "core/atomic.h"
+
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#include <stdio.h>
+
+#define PROFILER_INVALID_ZONE 0xFFFFFFFF
+#define PROFILER_EXPORT_BUFFER_SIZE (64 * 1024)
+
+typedef struct profiler_thread
+{
+    struct profiler_thread* next;
+    u32 thread_id;
+    u32 depth;
+    u64 write_index;
+    profiler_zone_record zones[PROFILER_MAX_ZONES_PER_THREAD];
+} profiler_thread;
+
+typedef struct profiler_frame
+{
+    u64 frame_number;
+    u64 start_ns;
+    u64 end_ns;
+} profiler_frame;
+
+typedef struct profiler_state
+{
+    profiler_thread* volatile threads;
+    volatile u32 thread_count;
+
+    u64 frame_number;
+    u64 frame_start_ns;
+    profiler_frame frames[PROFILER_FRAME_HISTORY];
+} profiler_state;
+
+typedef struct export_buffer
+{
+    file_handle* file;
+    u64 used;
+    char data[PROFILER_EXPORT_BUFFER_SIZE];
+} export_buffer;
+
+static profiler_state* state_ptr;
+
+static HTHREADLOCAL_HOT profiler_thread* thread_data;
+
+HINLINE u64 profiler_now_ns()
+{
+    return platform_get_ticks_ns();
+}
+
+b8 profiler_initialize(u64* memory_requirement, void* state)
+{
+    *memory_requirement = sizeof(profiler_state);
+
+    if (!state) return FALSE;
+
+    state_ptr = state;
+    hzero_memory(state_ptr, sizeof(profiler_state));
+    state_ptr->frame_start_ns = profiler_now_ns();
+
+    return TRUE;
+}
+
+void profiler_shutdown(void* state)
+{
+    if (!state_ptr) return;
+
+    // Buffers come straight from the platform to keep zones out of the memory stats.
+    profiler_thread* thread = state_ptr->threads;
+    while (thread)
+    {
+        profiler_thread* next = thread->next;
+        platform_free(thread, FALSE);
+        thread = next;
+    }
+
+    thread_data = 0;
+    state_ptr = 0;
+}
+
+static profiler_thread* acquire_thread_data()
+{
+    if (!thread_data)
+    {
+        thread_data = platform_allocate(sizeof(profiler_thread), FALSE);
+        hzero_memory(thread_data, sizeof(profiler_thread));
+        thread_data->thread_id = atomic_fetch_add_u32(&state_ptr->thread_count, 1);
+
+        // Worker threads register concurrently.
+        void* head = atomic_load_ptr((void* volatile*)&state_ptr->threads);
+        do
+        {
+            thread_data->next = head;
+        } while (!atomic_compare_exchange_ptr((void* volatile*)&state_ptr->threads, &head, thread_data));
+    }
+
+    return thread_data;
+}
+
+u32 profiler_zone_begin(const char* name)
+{
+    if (!state_ptr) return PROFILER_INVALID_ZONE;
+
+    profiler_thread* thread = acquire_thread_data();
+    u32 zone = (u32)(thread->write_index++ & (PROFILER_MAX_ZONES_PER_THREAD - 1));
+
+    profiler_zone_record* record = &thread->zones[zone];
+    record->name = name;
+    record->depth = thread->depth++;
+    record->frame_number = state_ptr->frame_number;
+    record->end_ns = 0;
+    record->start_ns = profiler_now_ns();
+
+    return zone;
+}
+
+void profiler_zone_end(u32 zone)
+{
+    u64 end_ns = profiler_now_ns();
+
+    if (!state_ptr || zone == PROFILER_INVALID_ZONE || !thread_data) return;
+
+    thread_data->zones[zone].end_ns = end_ns;
+    thread_data->depth--;
+}
+
+void profiler_frame_mark()
+{
+    if (!state_ptr) return;
+
+    u64 now = profiler_now_ns();
+
+    profiler_frame* frame = &state_ptr->frames[state_ptr->frame_number % PROFILER_FRAME_HISTORY];
+    frame->frame_number = state_ptr->frame_number;
+    frame->start_ns = state_ptr->frame_start_ns;
+    frame->end_ns = now;
+
+    state_ptr->frame_number++;
+    state_ptr->frame_start_ns = now;
+}
+
+static void export_flush(export_buffer* buffer)
+{
+    u64 written = 0;
+    filesystem_write(buffer->file, buffer->used, buffer->data, &written);
+    buffer->used = 0;
+}
+
+static void export_event(export_buffer* buffer, const char* name, u64 frame_number, u32 thread_id, u64 start_ns, u64 end_ns, u64 base_ns, b8 first)
+{
+    // Leave room for the longest event line so it never has to be split.
+    if (buffer->used > PROFILER_EXPORT_BUFFER_SIZE - 1024)
+    {
+        export_flush(buffer);
+    }
+
+    char* out = buffer->data + buffer->used;
+    u64 length = snprintf(out, 1024, "%s\n{\"name\":\"", first ? "" : ",");
+
+    // Zone names are identifiers in practice, escape the few characters JSON cares about anyway.
+    for (const char* c = name; *c && length < 800; ++c)
+    {
+        if (*c == '"' || *c == '\\') out[length++] = '\\';
+        out[length++] = (*c < ' ') ? ' ' : *c;
+    }
+
+    length += snprintf(out + length, 1024 - length,
+        "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+        thread_id, (start_ns - base_ns) / 1000.0, (end_ns - start_ns) / 1000.0, (unsigned long long)frame_number);
+
+    buffer->used += length;
+}
+
+b8 profiler_export_chrome_trace(const char* path)
+{
+    if (!state_ptr) return FALSE;
+
+    u64 retained = state_ptr->frame_number < PROFILER_FRAME_HISTORY ? state_ptr->frame_number : PROFILER_FRAME_HISTORY;
+    u64 oldest_frame = state_ptr->frame_number - retained;
+    if (!retained)
+    {
+        HWARN("profiler_export_chrome_trace: no completed frames to export.");
+        return FALSE;
+    }
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, FALSE, &file))
+    {
+        HERROR("profiler_export_chrome_trace: unable to open '%s' for writing.", path);
+        return FALSE;
+    }
+
+    export_buffer* buffer = platform_allocate(sizeof(export_buffer), FALSE);
+    buffer->file = &file;
+    buffer->used = 0;
+
+    u64 base_ns = state_ptr->frames[oldest_frame % PROFILER_FRAME_HISTORY].start_ns;
+    u64 zone_count = 0;
+    b8 first = TRUE;
+
+    buffer->used += snprintf(buffer->data, PROFILER_EXPORT_BUFFER_SIZE, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // Frames get a track of their own above the threads.
+    for (u64 f = oldest_frame; f < state_ptr->frame_number; ++f)
+    {
+        profiler_frame* frame = &state_ptr->frames[f % PROFILER_FRAME_HISTORY];
+        char name[32];
+        snprintf(name, sizeof(name), "Frame %llu", (unsigned long long)frame->frame_number);
+        export_event(buffer, name, frame->frame_number, 0, frame->start_ns, frame->end_ns, base_ns, first);
+        first = FALSE;
+    }
+
+    for (profiler_thread* thread = state_ptr->threads; thread; thread = thread->next)
+    {
+        u64 count = thread->write_index < PROFILER_MAX_ZONES_PER_THREAD ? thread->write_index : PROFILER_MAX_ZONES_PER_THREAD;
+        for (u64 i = thread->write_index - count; i < thread->write_index; ++i)
+        {
+            profiler_zone_record* zone = &thread->zones[i & (PROFILER_MAX_ZONES_PER_THREAD - 1)];
+            if (zone->frame_number < oldest_frame || zone->end_ns == 0 || zone->start_ns < base_ns)
+            {
+                continue;
+            }
+
+            export_event(buffer, zone->name, zone->frame_number, thread->thread_id + 1, zone->start_ns, zone->end_ns, base_ns, FALSE);
+            zone_count++;
+        }
+    }
+
+    export_flush(buffer);
+    buffer->used = snprintf(buffer->data, PROFILER_EXPORT_BUFFER_SIZE, "\n]}\n");
+    export_flush(buffer);
+
+    platform_free(buffer, FALSE);
+    filesystem_close(&file);
+
+    HINFO("Exported %llu zones over %llu frames to '%s'.", zone_count, retained, path);
+
+    return TRUE;
+}
\ No newline at end of file
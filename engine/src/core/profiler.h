@@ -0,0 +1,73 @@
+#pragma once
+
+#include "defines.h"
+
+// Instrumentation is compiled out entirely when disabled, the functions below stay exported.
+#ifndef HPROFILE_ENABLED
+#if HRELEASE == 1
+#define HPROFILE_ENABLED 0
+#else
+#define HPROFILE_ENABLED 1
+#endif
+#endif
+
+// Zones kept per thread, the oldest are overwritten first. Must be a power of two.
+#define PROFILER_MAX_ZONES_PER_THREAD 16384
+// Frames kept for export, older zones are dropped from the trace.
+#define PROFILER_FRAME_HISTORY 32
+
+typedef struct profiler_zone_record
+{
+    const char* name;
+    u64 start_ns;
+    u64 end_ns;
+    u64 frame_number;
+    u32 depth;
+} profiler_zone_record;
+
+b8 profiler_initialize(u64* memory_requirement, void* state);
+void profiler_shutdown(void* state);
+
+/**
+ * @brief Opens a zone on the calling thread. Prefer the PROFILE_SCOPE macro.
+ *
+ * @param name a string that outlives the profiler, usually a literal.
+ * @return a handle to pass to profiler_zone_end.
+ */
+HAPI u32 profiler_zone_begin(const char* name);
+
+HAPI void profiler_zone_end(u32 zone);
+
+// Closes the current frame and starts the next one. Called once per frame by the application.
+HAPI void profiler_frame_mark();
+
+/**
+ * @brief Writes the retained frames as Chrome trace_event JSON, viewable in Perfetto or chrome://tracing.
+ *
+ * @param path the path of the JSON file.
+ * @return b8 TRUE on success.
+ */
+HAPI b8 profiler_export_chrome_trace(const char* path);
+
+HINLINE void profiler_zone_end_scope(u32* zone)
+{
+    profiler_zone_end(*zone);
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if HPROFILE_ENABLED
+// Profiles the rest of the enclosing block, closed by the compiler on every exit path.
+#define PROFILE_SCOPE(name) u32 PROFILE_CONCAT(profile_zone_, __LINE__) __attribute__((cleanup(profiler_zone_end_scope))) = profiler_zone_begin(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_BEGIN(zone, name) u32 zone = profiler_zone_begin(name)
+#define PROFILE_END(zone) profiler_zone_end(zone)
+#define PROFILE_FRAME_MARK() profiler_frame_mark()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_BEGIN(zone, name)
+#define PROFILE_END(zone)
+#define PROFILE_FRAME_MARK()
+#endif
\ No newline at end of file
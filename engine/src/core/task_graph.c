@@ -0,0 +1,337 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "task_graph.h"
+
+#include "core/logger.h"
+#include "core/atomic.h"
+#include "core/profiler.h"
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#include "systems/job_system.h"
+
+#include <stdio.h>
+
+static void schedule_task(task_graph* graph, u32 index);
+
+b8 task_graph_create(task_graph* out_graph)
+{
+    hzero_memory(out_graph, sizeof(task_graph));
+
+    if (mpsc_queue_memory_requirement(sizeof(u32), TASK_GRAPH_MAX_TASKS) > sizeof(out_graph->main_queue_memory))
+    {
+        HERROR("task_graph_create - main queue memory is too small.");
+        return FALSE;
+    }
+
+    return mpsc_queue_create(sizeof(u32), TASK_GRAPH_MAX_TASKS, out_graph->main_queue_memory, &out_graph->main_queue);
+}
+
+void task_graph_destroy(task_graph* graph)
+{
+    mpsc_queue_destroy(&graph->main_queue);
+    hzero_memory(graph, sizeof(task_graph));
+}
+
+u32 task_graph_add(task_graph* graph, const task_desc* desc)
+{
+    if (graph->task_count == TASK_GRAPH_MAX_TASKS)
+    {
+        HERROR("task_graph_add - graph is full, '%s' was not added.", desc->name);
+        return INVALID_ID;
+    }
+
+    u32 index = graph->task_count++;
+    task_node* node = &graph->tasks[index];
+    hzero_memory(node, sizeof(task_node));
+    node->desc = *desc;
+    node->graph = graph;
+
+    graph->compiled = FALSE;
+
+    return index;
+}
+
+static void compile(task_graph* graph)
+{
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        graph->tasks[i].predecessors = 0;
+        graph->tasks[i].successors = 0;
+    }
+
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        task_node* node = &graph->tasks[i];
+
+        // Nearest first, so an edge already implied through a later task is not added again.
+        for (u32 j = i; j-- > 0;)
+        {
+            task_node* earlier = &graph->tasks[j];
+            b8 conflicts = (earlier->desc.writes & (node->desc.reads | node->desc.writes)) || (earlier->desc.reads & node->desc.writes);
+            if (!conflicts || (node->predecessors & (1ull << j))) continue;
+
+            node->predecessors |= (1ull << j) | earlier->predecessors;
+            earlier->successors |= 1ull << i;
+        }
+    }
+
+    graph->compiled = TRUE;
+}
+
+static void run_task(task_graph* graph, u32 index)
+{
+    task_node* node = &graph->tasks[index];
+
+    node->start_ns = platform_get_ticks_ns();
+    if (!atomic_load_u32(&graph->failed))
+    {
+        u32 zone = profiler_zone_begin(node->desc.name);
+        b8 result = node->desc.entry(node->desc.data);
+        profiler_zone_end(zone);
+
+        if (!result)
+        {
+            HERROR("Task '%s' failed.", node->desc.name);
+            atomic_store_u32(&graph->failed, TRUE);
+        }
+    }
+    node->end_ns = platform_get_ticks_ns();
+
+    u64 successors = node->successors;
+    while (successors)
+    {
+        u32 next = __builtin_ctzll(successors);
+        successors &= successors - 1;
+        if (atomic_fetch_add_u32(&graph->tasks[next].pending, (u32)-1) == 1)
+        {
+            schedule_task(graph, next);
+        }
+    }
+
+    // Last, so the executing thread never returns while successors are still being scheduled.
+    atomic_fetch_add_u32(&graph->remaining, (u32)-1);
+}
+
+static void run_task_job(void* data)
+{
+    task_node* node = data;
+    run_task(node->graph, (u32)(node - node->graph->tasks));
+}
+
+static void schedule_task(task_graph* graph, u32 index)
+{
+    if (graph->tasks[index].desc.main_thread)
+    {
+        mpsc_queue_push(&graph->main_queue, &index);
+    }
+    else
+    {
+        job_system_submit(run_task_job, &graph->tasks[index], 0);
+    }
+}
+
+b8 task_graph_execute(task_graph* graph)
+{
+    if (graph->task_count == 0) return TRUE;
+
+    if (!graph->compiled)
+    {
+        compile(graph);
+    }
+
+    graph->failed = FALSE;
+    graph->remaining = graph->task_count;
+    u64 start_ns = platform_get_ticks_ns();
+
+    // Direct edges only, matching the decrements done by run_task.
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        graph->tasks[i].pending = 0;
+    }
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        u64 successors = graph->tasks[i].successors;
+        while (successors)
+        {
+            graph->tasks[__builtin_ctzll(successors)].pending++;
+            successors &= successors - 1;
+        }
+    }
+
+    // Collect the roots before scheduling any, a root finishing early would otherwise zero the
+    // pending count of a task further along and get it scheduled twice.
+    u64 roots = 0;
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        if (graph->tasks[i].pending == 0)
+        {
+            roots |= 1ull << i;
+        }
+    }
+    while (roots)
+    {
+        schedule_task(graph, __builtin_ctzll(roots));
+        roots &= roots - 1;
+    }
+
+    u32 index;
+    while (atomic_load_u32(&graph->remaining))
+    {
+        if (mpsc_queue_pop(&graph->main_queue, &index))
+        {
+            run_task(graph, index);
+        }
+        else if (!job_system_run_pending())
+        {
+            platform_thread_yield();
+        }
+    }
+
+    graph->last_start_ns = start_ns;
+    graph->last_end_ns = platform_get_ticks_ns();
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        graph->tasks[i].last_start_ns = graph->tasks[i].start_ns;
+        graph->tasks[i].last_end_ns = graph->tasks[i].end_ns;
+    }
+
+    return !graph->failed;
+}
+
+u64 task_graph_critical_path(const task_graph* graph, u32* out_indices, u32* out_count)
+{
+    u64 finish[TASK_GRAPH_MAX_TASKS];
+    u32 previous[TASK_GRAPH_MAX_TASKS];
+
+    u32 last = INVALID_ID;
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        const task_node* node = &graph->tasks[i];
+        u64 longest = 0;
+        previous[i] = INVALID_ID;
+
+        u64 predecessors = node->predecessors;
+        while (predecessors)
+        {
+            u32 p = __builtin_ctzll(predecessors);
+            predecessors &= predecessors - 1;
+            // Ties go to the later task, which is the closer one on the chain.
+            if (finish[p] >= longest || previous[i] == INVALID_ID)
+            {
+                longest = finish[p];
+                previous[i] = p;
+            }
+        }
+
+        finish[i] = longest + (node->last_end_ns - node->last_start_ns);
+        if (last == INVALID_ID || finish[i] > finish[last])
+        {
+            last = i;
+        }
+    }
+
+    u32 count = 0;
+    for (u32 i = last; i != INVALID_ID; i = previous[i])
+    {
+        out_indices[count++] = i;
+    }
+
+    // Collected back to front.
+    for (u32 i = 0; i < count / 2; ++i)
+    {
+        u32 swap = out_indices[i];
+        out_indices[i] = out_indices[count - 1 - i];
+        out_indices[count - 1 - i] = swap;
+    }
+
+    *out_count = count;
+    return last == INVALID_ID ? 0 : finish[last];
+}
+
+static u64 critical_mask(const task_graph* graph, u64* out_length_ns)
+{
+    u32 path[TASK_GRAPH_MAX_TASKS];
+    u32 path_count = 0;
+    *out_length_ns = task_graph_critical_path(graph, path, &path_count);
+
+    u64 mask = 0;
+    for (u32 i = 0; i < path_count; ++i)
+    {
+        mask |= 1ull << path[i];
+    }
+    return mask;
+}
+
+void task_graph_log_critical_path(const task_graph* graph)
+{
+    u64 path_ns = 0;
+    u64 on_path = critical_mask(graph, &path_ns);
+
+    u64 busy_ns = 0;
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        busy_ns += graph->tasks[i].last_end_ns - graph->tasks[i].last_start_ns;
+    }
+
+    u64 wall_ns = graph->last_end_ns - graph->last_start_ns;
+    HINFO("Task graph: %u tasks, wall %.3fms, critical path %.3fms, task time %.3fms (%.2fx parallel).",
+        graph->task_count, wall_ns * 0.000001, path_ns * 0.000001, busy_ns * 0.000001, wall_ns ? (f64)busy_ns / wall_ns : 0.0);
+
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        const task_node* node = &graph->tasks[i];
+        HINFO("  %c %-24s start %8.3fms  duration %8.3fms%s",
+            (on_path & (1ull << i)) ? '*' : ' ', node->desc.name,
+            (node->last_start_ns - graph->last_start_ns) * 0.000001, (node->last_end_ns - node->last_start_ns) * 0.000001,
+            node->desc.main_thread ? "  (main thread)" : "");
+    }
+}
+
+b8 task_graph_export_dot(const task_graph* graph, const char* path)
+{
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, FALSE, &file))
+    {
+        HERROR("Unable to open task graph file '%s'.", path);
+        return FALSE;
+    }
+
+    u64 path_ns = 0;
+    u64 on_path = critical_mask(graph, &path_ns);
+
+    char line[512];
+    filesystem_write_line(&file, "digraph frame {");
+    filesystem_write_line(&file, "    node [shape=box, fontname=\"monospace\"];");
+    snprintf(line, sizeof(line), "    label=\"critical path %.3fms of %.3fms\";", path_ns * 0.000001, (graph->last_end_ns - graph->last_start_ns) * 0.000001);
+    filesystem_write_line(&file, line);
+
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        const task_node* node = &graph->tasks[i];
+        snprintf(line, sizeof(line), "    t%u [label=\"%s\\n%.3fms%s\"%s];", i, node->desc.name,
+            (node->last_end_ns - node->last_start_ns) * 0.000001, node->desc.main_thread ? "\\nmain thread" : "",
+            (on_path & (1ull << i)) ? ", color=red, penwidth=2" : "");
+        filesystem_write_line(&file, line);
+    }
+
+    for (u32 i = 0; i < graph->task_count; ++i)
+    {
+        u64 successors = graph->tasks[i].successors;
+        while (successors)
+        {
+            u32 next = __builtin_ctzll(successors);
+            successors &= successors - 1;
+            b8 critical = (on_path & (1ull << i)) && (on_path & (1ull << next));
+            snprintf(line, sizeof(line), "    t%u -> t%u%s;", i, next, critical ? " [color=red, penwidth=2]" : "");
+            filesystem_write_line(&file, line);
+        }
+    }
+
+    filesystem_write_line(&file, "}");
+    filesystem_close(&file);
+
+    return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "defines.h"
+
+#include "containers/mpsc_queue.h"
+
+// Dependencies are kept as bitmasks over the task indices.
+#define TASK_GRAPH_MAX_TASKS 64
+
+// Shared state a task reads or writes. Programs use bits from TASK_RESOURCE_USER up.
+typedef enum task_resource
+{
+    TASK_RESOURCE_EVENTS = 1 << 0,
+    TASK_RESOURCE_INPUT = 1 << 1,
+    TASK_RESOURCE_PROGRAM = 1 << 2,
+    TASK_RESOURCE_RENDER_PACKET = 1 << 3,
+    TASK_RESOURCE_RENDERER = 1 << 4,
+    TASK_RESOURCE_TEXTURES = 1 << 5,
+    TASK_RESOURCE_MATERIALS = 1 << 6,
+    TASK_RESOURCE_GEOMETRY = 1 << 7,
+    // The resource system and its loaders.
+    TASK_RESOURCE_ASSETS = 1 << 8,
+
+    TASK_RESOURCE_USER = 1 << 16
+} task_resource;
+
+// Returns FALSE to fail the frame. Tasks that depend on a failed one are skipped.
+typedef b8 (*task_entry)(void* data);
+
+typedef struct task_desc
+{
+    const char* name;
+    task_entry entry;
+    void* data;
+
+    // task_resource masks.
+    u64 reads;
+    u64 writes;
+
+    // Run on the thread executing the graph, for work such as GL calls that is tied to it.
+    b8 main_thread;
+} task_desc;
+
+typedef struct task_node
+{
+    task_desc desc;
+
+    // Every task this one waits on, directly or not.
+    u64 predecessors;
+    // Tasks waiting directly on this one.
+    u64 successors;
+    volatile u32 pending;
+
+    // Timings of the execution in progress, copied to the last_ fields once it completes.
+    u64 start_ns;
+    u64 end_ns;
+    u64 last_start_ns;
+    u64 last_end_ns;
+
+    struct task_graph* graph;
+} task_node;
+
+typedef struct task_graph
+{
+    u32 task_count;
+    b8 compiled;
+
+    volatile u32 remaining;
+    volatile u32 failed;
+
+    // Of the last completed execution, so tasks can report on the previous frame.
+    u64 last_start_ns;
+    u64 last_end_ns;
+
+    // Main thread tasks that became ready, pushed by whichever thread finished their last dependency.
+    mpsc_queue main_queue;
+    u64 main_queue_memory[TASK_GRAPH_MAX_TASKS * 2];
+
+    task_node tasks[TASK_GRAPH_MAX_TASKS];
+} task_graph;
+
+HAPI b8 task_graph_create(task_graph* out_graph);
+HAPI void task_graph_destroy(task_graph* graph);
+
+/**
+ * @brief Adds a task. A task depends on every earlier task it conflicts with: one of the two
+ * writes something the other reads or writes. Tasks without conflicts may run concurrently.
+ *
+ * @return the task index, or INVALID_ID if the graph is full.
+ */
+HAPI u32 task_graph_add(task_graph* graph, const task_desc* desc);
+
+/**
+ * @brief Runs every task once, spreading tasks without pending dependencies across the job system.
+ * Must be called from the thread that initialized the job system.
+ *
+ * @return FALSE if any task failed.
+ */
+HAPI b8 task_graph_execute(task_graph* graph);
+
+/**
+ * @brief Finds the chain of dependent tasks that took longest in the last completed execution.
+ *
+ * @param out_indices receives the task indices in execution order, TASK_GRAPH_MAX_TASKS entries.
+ * @param out_count receives the length of the chain.
+ * @return the summed duration of the chain in nanoseconds.
+ */
+HAPI u64 task_graph_critical_path(const task_graph* graph, u32* out_indices, u32* out_count);
+
+// Logs every task of the last completed execution with its timings, marking the critical path.
+HAPI void task_graph_log_critical_path(const task_graph* graph);
+
+// Writes the graph with the last timings as a Graphviz file, the critical path drawn in red.
+HAPI b8 task_graph_export_dot(const task_graph* graph, const char* path);
\ No newline at end of file
@@ -83,4 +83,14 @@ typedef char b8;
 #else
 #define HINLINE static inline
 #define HNOINLINE
+#endif
+
+// Thread local storage
+#ifdef _MSC_VER
+#define HTHREADLOCAL __declspec(thread)
+#define HTHREADLOCAL_HOT __declspec(thread)
+#else
+#define HTHREADLOCAL _Thread_local
+// For thread locals read on hot paths. Skips the __tls_get_addr call, fine since the engine is never dlopen'd.
+#define HTHREADLOCAL_HOT _Thread_local __attribute__((tls_model("initial-exec")))
 #endif
\ No newline at end of file
@@ -4,20 +4,41 @@
 
 #include "core/application.h"
 #include "core/logger.h"
+#include "core/hstring.h"
 #include "program_types.h"
 
 extern b8 create_program(program* out_program);
 
 // Main entry point.
-int main(void)
+int main(int argc, char** argv)
 {
-    program program_inst;
+    program program_inst = {};
     if (!create_program(&program_inst))
     {
         HFATAL("Could not create program.");
         return -1;
     }
 
+    // Overrides for automated runs, e.g. --headless --benchmark-frames 1000 on a build agent.
+    for (i32 i = 1; i < argc; ++i)
+    {
+        if (strings_equali(argv[i], "--headless"))
+        {
+            program_inst.app_config.headless = TRUE;
+        }
+        else if (strings_equali(argv[i], "--benchmark-frames") && i + 1 < argc)
+        {
+            if (!string_to_u32(argv[++i], &program_inst.app_config.benchmark_frames))
+            {
+                HERROR("--benchmark-frames expects a frame count, got '%s'.", argv[i]);
+                return -3;
+            }
+
+            // A benchmark measures how fast frames can run, not the pacer.
+            program_inst.app_config.target_frame_rate = 0;
+        }
+    }
+
     if (!program_inst.render || !program_inst.initialize || !program_inst.update || !program_inst.on_resize)
     {
         HFATAL("The program's function pointers must be assigned.");
@@ -1,7 +1,10 @@
+#define HLOG_CATEGORY LOG_CATEGORY_MEMORY
+
 #include "hmemory.h"
 
 #include "core/logger.h"
 #include "core/hstring.h"
+#include "core/atomic.h"
 #include "platform/platform.h"
 
 #include <string.h>
@@ -66,33 +69,31 @@ void* hallocate(u64 size, memory_tag tag)
 {
     if (tag == MEMORY_TAG_UNKNOWN)
     {
-        HWARN("hallocate called using MEMORY_TAG_UNKNOWN.");
+        HWARN_LIMITED("hallocate called using MEMORY_TAG_UNKNOWN.");
     }
 
     if (state_ptr)
     {
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->total_allocations++;
+        // Jobs allocate from worker threads too.
+        atomic_fetch_add_u64(&state_ptr->stats.total_allocated, size);
+        atomic_fetch_add_u64(&state_ptr->stats.tagged_allocations[tag], size);
+        atomic_fetch_add_u64(&state_ptr->total_allocations, 1);
     }
 
-    void* block = platform_allocate(size, FALSE);
-    platform_zero_memory(block, size);
-
-    return block;
+    return platform_allocate_zeroed(size, FALSE);
 }
 
 void hfree(void* block, u64 size, memory_tag tag)
 {
     if (tag == MEMORY_TAG_UNKNOWN)
     {
-        HWARN("hfree called using MEMORY_TAG_UNKNOWN.");
+        HWARN_LIMITED("hfree called using MEMORY_TAG_UNKNOWN.");
     }
 
     if (state_ptr)
     {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+        atomic_fetch_add_u64(&state_ptr->stats.total_allocated, (u64)0 - size);
+        atomic_fetch_add_u64(&state_ptr->stats.tagged_allocations[tag], (u64)0 - size);
     }
 
     platform_free(block, FALSE);
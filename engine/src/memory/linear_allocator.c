@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_MEMORY
+
 #include "linear_allocator.h"
 
 #include "memory/hmemory.h"
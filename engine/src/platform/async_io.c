@@ -0,0 +1,730 @@
+#define HLOG_CATEGORY LOG_CATEGORY_PLATFORM
+
+#include "async_io.h"
+
+#include "core/logger.h"
+#include "core/atomic.h"
+#include "containers/mpsc_queue.h"
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#if HPLATFORM_LINUX
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#define ASYNC_IO_MAX_THREADS 8
+
+// Threads backend.
+
+typedef struct thread_backend
+{
+    u64 memory_size;
+
+    platform_thread* threads;
+    u32 thread_count;
+
+    // Reads not yet taken by a thread, a ring of queue_depth entries under the lock.
+    platform_mutex lock;
+    async_io_read** pending;
+    u32 pending_start;
+    u32 pending_count;
+    u32 capacity;
+
+    // One signal per queued read, and one per thread to exit.
+    platform_semaphore work;
+    // One signal per finished read.
+    platform_semaphore done;
+    mpsc_queue completed;
+} thread_backend;
+
+static void read_whole_file(async_io_read* read)
+{
+    read->data = 0;
+    read->size = 0;
+    read->success = FALSE;
+
+    file_handle f;
+    if (!filesystem_open(read->path, FILE_MODE_READ, TRUE, &f))
+    {
+        return;
+    }
+
+    u64 size = 0;
+    if (filesystem_size(&f, &size))
+    {
+        u8* data = size ? hallocate(size, MEMORY_TAG_ARRAY) : 0;
+        u64 read_size = 0;
+        if (!size || filesystem_read(&f, size, data, &read_size))
+        {
+            read->data = data;
+            read->size = size;
+            read->success = TRUE;
+        }
+        else
+        {
+            hfree(data, size, MEMORY_TAG_ARRAY);
+        }
+    }
+
+    filesystem_close(&f);
+}
+
+static u32 io_thread_main(void* params)
+{
+    thread_backend* backend = params;
+    while (TRUE)
+    {
+        platform_semaphore_wait(&backend->work);
+
+        async_io_read* read = 0;
+        platform_mutex_lock(&backend->lock);
+        if (backend->pending_count)
+        {
+            read = backend->pending[backend->pending_start];
+            backend->pending_start = (backend->pending_start + 1) % backend->capacity;
+            backend->pending_count--;
+        }
+        platform_mutex_unlock(&backend->lock);
+
+        // Woken without work only to exit.
+        if (!read) return 0;
+
+        read_whole_file(read);
+        mpsc_queue_push(&backend->completed, &read);
+        platform_semaphore_signal(&backend->done, 1);
+    }
+}
+
+static b8 threads_create(async_io_config config, async_io* io)
+{
+    u32 thread_count = config.thread_count;
+    if (thread_count == 0)
+    {
+        thread_count = config.queue_depth < ASYNC_IO_MAX_THREADS ? config.queue_depth : ASYNC_IO_MAX_THREADS;
+    }
+
+    u32 queue_capacity = 2;
+    while (queue_capacity < config.queue_depth)
+    {
+        queue_capacity <<= 1;
+    }
+
+    u64 threads_requirement = sizeof(platform_thread) * thread_count;
+    u64 pending_requirement = sizeof(async_io_read*) * config.queue_depth;
+    u64 queue_requirement = mpsc_queue_memory_requirement(sizeof(async_io_read*), queue_capacity);
+    u64 memory_size = sizeof(thread_backend) + threads_requirement + pending_requirement + queue_requirement;
+
+    thread_backend* backend = hallocate(memory_size, MEMORY_TAG_ARRAY);
+    backend->memory_size = memory_size;
+    backend->threads = (platform_thread*)(backend + 1);
+    backend->pending = (async_io_read**)((u8*)backend->threads + threads_requirement);
+    backend->capacity = config.queue_depth;
+
+    if (!platform_mutex_create(&backend->lock) || !platform_semaphore_create(0, &backend->work) || !platform_semaphore_create(0, &backend->done) ||
+        !mpsc_queue_create(sizeof(async_io_read*), queue_capacity, (u8*)backend->pending + pending_requirement, &backend->completed))
+    {
+        HERROR("Failed to create async I/O synchronization objects.");
+        hfree(backend, memory_size, MEMORY_TAG_ARRAY);
+        return FALSE;
+    }
+
+    for (u32 i = 0; i < thread_count; ++i)
+    {
+        if (!platform_thread_create(io_thread_main, backend, &backend->threads[i]))
+        {
+            HERROR("Failed to start async I/O thread %u.", i);
+            break;
+        }
+        backend->thread_count++;
+    }
+
+    io->internal = backend;
+    return backend->thread_count > 0;
+}
+
+static void threads_destroy(async_io* io)
+{
+    thread_backend* backend = io->internal;
+
+    // Nothing is pending anymore, every thread takes one of these signals and exits.
+    platform_semaphore_signal(&backend->work, backend->thread_count);
+    for (u32 i = 0; i < backend->thread_count; ++i)
+    {
+        platform_thread_join(&backend->threads[i]);
+    }
+
+    mpsc_queue_destroy(&backend->completed);
+    platform_semaphore_destroy(&backend->done);
+    platform_semaphore_destroy(&backend->work);
+    platform_mutex_destroy(&backend->lock);
+    hfree(backend, backend->memory_size, MEMORY_TAG_ARRAY);
+}
+
+static u32 threads_submit(async_io* io, u32 count, async_io_read** reads)
+{
+    thread_backend* backend = io->internal;
+
+    platform_mutex_lock(&backend->lock);
+    for (u32 i = 0; i < count; ++i)
+    {
+        backend->pending[(backend->pending_start + backend->pending_count) % backend->capacity] = reads[i];
+        backend->pending_count++;
+    }
+    platform_mutex_unlock(&backend->lock);
+
+    platform_semaphore_signal(&backend->work, count);
+    return count;
+}
+
+static u32 threads_poll(async_io* io, b8 wait, u32 max_count, async_io_read** out_reads)
+{
+    thread_backend* backend = io->internal;
+
+    u32 count = 0;
+    while (count < max_count && mpsc_queue_pop(&backend->completed, &out_reads[count]))
+    {
+        count++;
+    }
+
+    // Signals outnumber the reads still to pop when earlier polls did not wait, those waits return at once.
+    while (wait && count == 0 && io->in_flight)
+    {
+        platform_semaphore_wait(&backend->done);
+        while (count < max_count && mpsc_queue_pop(&backend->completed, &out_reads[count]))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+#if HPLATFORM_LINUX
+
+// io_uring backend, through the raw system calls.
+
+typedef enum uring_op
+{
+    URING_OP_OPEN,
+    URING_OP_STATX,
+    URING_OP_READ,
+    URING_OP_CLOSE
+} uring_op;
+
+// Larger reads are split, a single read returns at most about 2GiB anyway.
+#define URING_MAX_READ (1u << 30)
+
+typedef struct uring_slot
+{
+    async_io_read* read;
+    struct statx stx;
+    i32 fd;
+    // Bytes read so far.
+    u64 done;
+    // Operations submitted and not yet completed.
+    u32 outstanding;
+    b8 failed;
+} uring_slot;
+
+typedef struct uring_backend
+{
+    u64 memory_size;
+    i32 ring_fd;
+
+    void* sq_ring;
+    u64 sq_ring_size;
+    void* cq_ring;
+    u64 cq_ring_size;
+    struct io_uring_sqe* sqes;
+    u64 sqes_size;
+
+    volatile u32* sq_head;
+    volatile u32* sq_tail;
+    u32* sq_array;
+    u32 sq_mask;
+    u32 sq_entries;
+    volatile u32* cq_head;
+    volatile u32* cq_tail;
+    struct io_uring_cqe* cqes;
+    u32 cq_mask;
+
+    // Queued in the ring and not yet handed to the kernel.
+    u32 to_submit;
+
+    uring_slot* slots;
+    u32* free_slots;
+    u32 free_count;
+
+    // Finished reads that did not fit in the caller's array yet.
+    async_io_read** finished;
+    u32 finished_count;
+} uring_backend;
+
+static i32 uring_enter(uring_backend* ring, u32 to_submit, u32 min_complete, u32 flags)
+{
+    while (TRUE)
+    {
+        i32 result = (i32)syscall(__NR_io_uring_enter, ring->ring_fd, to_submit, min_complete, flags, 0, 0);
+        if (result >= 0 || errno != EINTR)
+        {
+            return result < 0 ? -errno : result;
+        }
+    }
+}
+
+// Every slot has at most two operations in the ring and the ring holds twice the queue depth, so this never runs out.
+static struct io_uring_sqe* uring_get_sqe(uring_backend* ring, u32 slot, uring_op op)
+{
+    u32 tail = *ring->sq_tail;
+    u32 index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    hzero_memory(sqe, sizeof(struct io_uring_sqe));
+    sqe->user_data = ((u64)slot << 8) | op;
+
+    ring->sq_array[index] = index;
+    atomic_store_u32(ring->sq_tail, tail + 1);
+    ring->to_submit++;
+    ring->slots[slot].outstanding++;
+    return sqe;
+}
+
+static void uring_flush(uring_backend* ring, u32 min_complete)
+{
+    u32 flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    while (ring->to_submit || min_complete)
+    {
+        i32 result = uring_enter(ring, ring->to_submit, min_complete, flags);
+        if (result == -EBUSY || result == -EAGAIN)
+        {
+            // The completion ring is full, it is drained by the caller before submitting again.
+            return;
+        }
+        if (result < 0)
+        {
+            HERROR("io_uring_enter failed with error %i.", result);
+            return;
+        }
+
+        ring->to_submit -= (u32)result;
+        min_complete = 0;
+        flags = 0;
+    }
+}
+
+static void uring_queue_read(uring_backend* ring, u32 slot_index)
+{
+    uring_slot* slot = &ring->slots[slot_index];
+    u64 remaining = slot->read->size - slot->done;
+
+    struct io_uring_sqe* sqe = uring_get_sqe(ring, slot_index, URING_OP_READ);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot->fd;
+    sqe->addr = (u64)(slot->read->data + slot->done);
+    sqe->len = remaining < URING_MAX_READ ? (u32)remaining : URING_MAX_READ;
+    sqe->off = slot->done;
+}
+
+static void uring_queue_close(uring_backend* ring, u32 slot_index)
+{
+    struct io_uring_sqe* sqe = uring_get_sqe(ring, slot_index, URING_OP_CLOSE);
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = ring->slots[slot_index].fd;
+}
+
+static void uring_finish(uring_backend* ring, u32 slot_index)
+{
+    uring_slot* slot = &ring->slots[slot_index];
+    async_io_read* read = slot->read;
+
+    read->success = !slot->failed;
+    if (slot->failed)
+    {
+        HERROR("Async read of '%s' failed.", read->path);
+        if (read->data)
+        {
+            hfree(read->data, read->size, MEMORY_TAG_ARRAY);
+        }
+        read->data = 0;
+        read->size = 0;
+    }
+
+    ring->finished[ring->finished_count++] = read;
+    slot->read = 0;
+    ring->free_slots[ring->free_count++] = slot_index;
+}
+
+// Moves a slot on to its next operation once the ones it waits on have completed.
+static void uring_complete(uring_backend* ring, u64 user_data, i32 result)
+{
+    u32 slot_index = (u32)(user_data >> 8);
+    uring_op op = (uring_op)(user_data & 0xFF);
+    uring_slot* slot = &ring->slots[slot_index];
+    slot->outstanding--;
+
+    switch (op)
+    {
+        case URING_OP_OPEN:
+            if (result >= 0)
+            {
+                slot->fd = result;
+            }
+            else
+            {
+                slot->failed = TRUE;
+            }
+            break;
+        case URING_OP_STATX:
+            slot->failed |= result < 0;
+            break;
+        case URING_OP_READ:
+            if (result <= 0)
+            {
+                // End of file early means the file shrank since it was sized.
+                slot->failed = TRUE;
+            }
+            else
+            {
+                slot->done += (u64)result;
+            }
+            break;
+        case URING_OP_CLOSE:
+            slot->fd = -1;
+            break;
+    }
+
+    if (slot->outstanding) return;
+
+    if (op == URING_OP_OPEN || op == URING_OP_STATX)
+    {
+        if (!slot->failed)
+        {
+            slot->read->size = slot->stx.stx_size;
+            slot->read->data = slot->read->size ? hallocate(slot->read->size, MEMORY_TAG_ARRAY) : 0;
+            if (slot->read->size)
+            {
+                uring_queue_read(ring, slot_index);
+                return;
+            }
+        }
+    }
+    else if (op == URING_OP_READ && !slot->failed && slot->done < slot->read->size)
+    {
+        uring_queue_read(ring, slot_index);
+        return;
+    }
+
+    if (slot->fd >= 0)
+    {
+        uring_queue_close(ring, slot_index);
+        return;
+    }
+
+    uring_finish(ring, slot_index);
+}
+
+static void uring_reap(uring_backend* ring)
+{
+    u32 head = *ring->cq_head;
+    u32 tail = atomic_load_u32(ring->cq_tail);
+    while (head != tail)
+    {
+        struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        uring_complete(ring, cqe->user_data, cqe->res);
+        head++;
+    }
+    atomic_store_u32(ring->cq_head, head);
+}
+
+static b8 uring_supports_ops(i32 ring_fd)
+{
+    u8 opcodes[] = {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE};
+
+    u64 probe_size = sizeof(struct io_uring_probe) + sizeof(struct io_uring_probe_op) * 256;
+    struct io_uring_probe* probe = hallocate(probe_size, MEMORY_TAG_ARRAY);
+    b8 supported = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    for (u32 i = 0; supported && i < sizeof(opcodes); ++i)
+    {
+        supported = opcodes[i] <= probe->last_op && (probe->ops[opcodes[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+    hfree(probe, probe_size, MEMORY_TAG_ARRAY);
+
+    return supported;
+}
+
+static void uring_release(uring_backend* ring)
+{
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring && ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+    if (ring->sq_ring) munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->ring_fd >= 0) close(ring->ring_fd);
+    hfree(ring, ring->memory_size, MEMORY_TAG_ARRAY);
+}
+
+static b8 uring_create(async_io_config config, async_io* io)
+{
+    u64 slots_requirement = sizeof(uring_slot) * config.queue_depth;
+    u64 free_requirement = sizeof(u32) * config.queue_depth;
+    u64 finished_requirement = sizeof(async_io_read*) * config.queue_depth;
+    u64 memory_size = sizeof(uring_backend) + slots_requirement + free_requirement + finished_requirement;
+
+    uring_backend* ring = hallocate(memory_size, MEMORY_TAG_ARRAY);
+    ring->memory_size = memory_size;
+    ring->slots = (uring_slot*)(ring + 1);
+    ring->free_slots = (u32*)((u8*)ring->slots + slots_requirement);
+    ring->finished = (async_io_read**)((u8*)ring->free_slots + free_requirement);
+    for (u32 i = 0; i < config.queue_depth; ++i)
+    {
+        ring->slots[i].fd = -1;
+        ring->free_slots[i] = config.queue_depth - 1 - i;
+    }
+    ring->free_count = config.queue_depth;
+
+    struct io_uring_params params;
+    hzero_memory(&params, sizeof(params));
+    ring->ring_fd = (i32)syscall(__NR_io_uring_setup, config.queue_depth * 2, &params);
+    if (ring->ring_fd < 0)
+    {
+        HINFO("io_uring is unavailable (error %i), using I/O threads.", errno);
+        uring_release(ring);
+        return FALSE;
+    }
+
+    if (!uring_supports_ops(ring->ring_fd))
+    {
+        HINFO("io_uring lacks the file operations needed, using I/O threads.");
+        uring_release(ring);
+        return FALSE;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->sq_ring_size = ring->cq_ring_size > ring->sq_ring_size ? ring->cq_ring_size : ring->sq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(0, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED)
+    {
+        ring->sq_ring = 0;
+    }
+    ring->cq_ring = ring->sq_ring;
+    if (ring->sq_ring && !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        ring->cq_ring = mmap(0, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED)
+        {
+            ring->cq_ring = 0;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = 0;
+    }
+
+    if (!ring->sq_ring || !ring->cq_ring || !ring->sqes)
+    {
+        HERROR("Failed to map the io_uring rings, using I/O threads.");
+        uring_release(ring);
+        return FALSE;
+    }
+
+    u8* sq = ring->sq_ring;
+    ring->sq_head = (volatile u32*)(sq + params.sq_off.head);
+    ring->sq_tail = (volatile u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_array = (u32*)(sq + params.sq_off.array);
+
+    u8* cq = ring->cq_ring;
+    ring->cq_head = (volatile u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (volatile u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    io->internal = ring;
+    return TRUE;
+}
+
+static void uring_destroy(async_io* io)
+{
+    uring_release(io->internal);
+}
+
+static u32 uring_submit(async_io* io, u32 count, async_io_read** reads)
+{
+    uring_backend* ring = io->internal;
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 slot_index = ring->free_slots[--ring->free_count];
+        uring_slot* slot = &ring->slots[slot_index];
+        slot->read = reads[i];
+        slot->fd = -1;
+        slot->done = 0;
+        slot->failed = FALSE;
+        reads[i]->data = 0;
+        reads[i]->size = 0;
+
+        // Opened and sized at the same time, both go by path.
+        struct io_uring_sqe* sqe = uring_get_sqe(ring, slot_index, URING_OP_OPEN);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (u64)reads[i]->path;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+
+        sqe = uring_get_sqe(ring, slot_index, URING_OP_STATX);
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (u64)reads[i]->path;
+        sqe->len = STATX_SIZE;
+        sqe->off = (u64)&slot->stx;
+    }
+
+    uring_flush(ring, 0);
+    return count;
+}
+
+static u32 uring_poll(async_io* io, b8 wait, u32 max_count, async_io_read** out_reads)
+{
+    uring_backend* ring = io->internal;
+
+    // Completions queue further operations, keep going until a read finishes or nothing more is ready.
+    uring_reap(ring);
+    uring_flush(ring, 0);
+    while (wait && ring->finished_count == 0 && io->in_flight)
+    {
+        uring_flush(ring, 1);
+        uring_reap(ring);
+        uring_flush(ring, 0);
+    }
+
+    u32 count = ring->finished_count < max_count ? ring->finished_count : max_count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        out_reads[i] = ring->finished[i];
+    }
+    ring->finished_count -= count;
+    for (u32 i = 0; i < ring->finished_count; ++i)
+    {
+        ring->finished[i] = ring->finished[count + i];
+    }
+
+    return count;
+}
+
+#endif
+
+b8 async_io_create(async_io_config config, async_io* out_io)
+{
+    hzero_memory(out_io, sizeof(async_io));
+    if (config.queue_depth == 0)
+    {
+        HERROR("async_io_create - queue_depth must be at least 1.");
+        return FALSE;
+    }
+    out_io->queue_depth = config.queue_depth;
+
+#if HPLATFORM_LINUX
+    if (!config.force_threads && uring_create(config, out_io))
+    {
+        out_io->backend = ASYNC_IO_BACKEND_URING;
+        return TRUE;
+    }
+#endif
+
+    out_io->backend = ASYNC_IO_BACKEND_THREADS;
+    return threads_create(config, out_io);
+}
+
+void async_io_destroy(async_io* io)
+{
+    if (!io->internal) return;
+
+    async_io_read* reads[64];
+    while (io->in_flight)
+    {
+        u32 count = async_io_poll(io, TRUE, 64, reads);
+        for (u32 i = 0; i < count; ++i)
+        {
+            if (reads[i]->data)
+            {
+                hfree(reads[i]->data, reads[i]->size, MEMORY_TAG_ARRAY);
+                reads[i]->data = 0;
+            }
+        }
+    }
+
+#if HPLATFORM_LINUX
+    if (io->backend == ASYNC_IO_BACKEND_URING)
+    {
+        uring_destroy(io);
+    }
+    else
+#endif
+    {
+        threads_destroy(io);
+    }
+
+    hzero_memory(io, sizeof(async_io));
+}
+
+u32 async_io_submit(async_io* io, u32 count, async_io_read** reads)
+{
+    u32 room = io->queue_depth - io->in_flight;
+    if (count > room)
+    {
+        count = room;
+    }
+    if (count == 0) return 0;
+
+#if HPLATFORM_LINUX
+    if (io->backend == ASYNC_IO_BACKEND_URING)
+    {
+        count = uring_submit(io, count, reads);
+    }
+    else
+#endif
+    {
+        count = threads_submit(io, count, reads);
+    }
+
+    io->in_flight += count;
+    return count;
+}
+
+u32 async_io_poll(async_io* io, b8 wait, u32 max_count, async_io_read** out_reads)
+{
+    if (max_count == 0) return 0;
+
+    u32 count;
+#if HPLATFORM_LINUX
+    if (io->backend == ASYNC_IO_BACKEND_URING)
+    {
+        count = uring_poll(io, wait, max_count, out_reads);
+    }
+    else
+#endif
+    {
+        count = threads_poll(io, wait, max_count, out_reads);
+    }
+
+    io->in_flight -= count;
+    return count;
+}
+
+const char* async_io_backend_name(async_io_backend backend)
+{
+    return backend == ASYNC_IO_BACKEND_URING ? "io_uring" : "threads";
+}
\ No newline at end of file
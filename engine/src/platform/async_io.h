@@ -0,0 +1,74 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Batched whole-file reads that complete in any order.
+
+On Linux the reads go through io_uring. Each file is opened and sized, then read, then closed,
+every step a ring operation of its own, so all reads in flight keep the device queue busy and
+a poll costs one system call however many files finished. Elsewhere, or when the kernel refuses
+io_uring, a small pool of threads does the same with blocking calls.
+
+A context is driven from a single thread: submit and poll must not be called concurrently.
+*/
+
+typedef enum async_io_backend
+{
+    ASYNC_IO_BACKEND_THREADS,
+    ASYNC_IO_BACKEND_URING
+} async_io_backend;
+
+typedef struct async_io_read
+{
+    // Set by the caller. The path must stay valid until the read is polled.
+    const char* path;
+    void* user_data;
+
+    // Set once polled. data is allocated with hallocate and MEMORY_TAG_ARRAY, the caller frees it.
+    u8* data;
+    u64 size;
+    b8 success;
+} async_io_read;
+
+typedef struct async_io_config
+{
+    // Reads in flight at once.
+    u32 queue_depth;
+    // Threads of the fallback backend, 0 uses the queue depth up to 8.
+    u32 thread_count;
+    // Uses the thread backend even where io_uring works, for comparison.
+    b8 force_threads;
+} async_io_config;
+
+typedef struct async_io
+{
+    async_io_backend backend;
+    u32 queue_depth;
+    u32 in_flight;
+    void* internal;
+} async_io;
+
+HAPI b8 async_io_create(async_io_config config, async_io* out_io);
+
+// Waits for the reads in flight and frees their data, they are never polled.
+HAPI void async_io_destroy(async_io* io);
+
+/**
+ * @brief Starts reading files.
+ *
+ * @param reads the reads to start, each stays untouched by the caller until it is polled.
+ * @return how many of the reads were started, from the front. Fewer than count once the queue depth is reached.
+ */
+HAPI u32 async_io_submit(async_io* io, u32 count, async_io_read** reads);
+
+/**
+ * @brief Collects finished reads.
+ *
+ * @param wait blocks until at least one read finishes, unless none are in flight.
+ * @param out_reads receives up to max_count finished reads.
+ * @return the number of reads written to out_reads.
+ */
+HAPI u32 async_io_poll(async_io* io, b8 wait, u32 max_count, async_io_read** out_reads);
+
+HAPI const char* async_io_backend_name(async_io_backend backend);
\ No newline at end of file
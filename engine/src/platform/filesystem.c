@@ -1,13 +1,25 @@
+#define HLOG_CATEGORY LOG_CATEGORY_PLATFORM
+
 #include "filesystem.h"
 
 #include "core/logger.h"
 
 #include "memory/hmemory.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
 
+#if HPLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 b8 filesystem_exists(const char* path)
 {
 #if _MSC_VER
@@ -167,4 +179,223 @@ b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* o
     fflush((FILE*)handle->handle);
 
     return TRUE;
+}
+
+b8 filesystem_map(const char* path, file_view* out_view)
+{
+    out_view->data = 0;
+    out_view->size = 0;
+
+    void* data = 0;
+    u64 size = 0;
+#if HPLATFORM_WINDOWS
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        HERROR("Error opening file for mapping: '%s'", path);
+        return FALSE;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        HERROR("Error reading size of file: '%s'", path);
+        return FALSE;
+    }
+    size = (u64)file_size.QuadPart;
+    if (size == 0)
+    {
+        CloseHandle(file);
+        return TRUE;
+    }
+
+    // The view keeps the mapping alive once both handles are closed.
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    i32 fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        HERROR("Error opening file for mapping: '%s'", path);
+        return FALSE;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        HERROR("Error reading size of file: '%s'", path);
+        return FALSE;
+    }
+    size = (u64)info.st_size;
+    if (size == 0)
+    {
+        close(fd);
+        return TRUE;
+    }
+
+    data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        data = 0;
+    }
+#endif
+
+    if (!data)
+    {
+        HERROR("Error mapping file: '%s'", path);
+        return FALSE;
+    }
+
+    out_view->data = data;
+    out_view->size = size;
+    filesystem_advise(out_view, 0, size, FILE_ACCESS_SEQUENTIAL | FILE_ACCESS_WILL_NEED);
+    return TRUE;
+}
+
+void filesystem_unmap(file_view* view)
+{
+    if (view->data)
+    {
+#if HPLATFORM_WINDOWS
+        UnmapViewOfFile(view->data);
+#else
+        munmap((void*)view->data, view->size);
+#endif
+    }
+
+    view->data = 0;
+    view->size = 0;
+}
+
+void filesystem_advise(const file_view* view, u64 offset, u64 size, u32 hints)
+{
+    if (!view->data || offset >= view->size) return;
+    if (size > view->size - offset)
+    {
+        size = view->size - offset;
+    }
+
+#if HPLATFORM_WINDOWS
+    // Access patterns are fixed when the file is opened, only prefetching can be asked for later.
+#if _WIN32_WINNT >= 0x0602
+    if (hints & FILE_ACCESS_WILL_NEED)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = {(u8*)view->data + offset, (SIZE_T)size};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#endif
+#else
+    // The range has to start on a page boundary, the mapping itself does.
+    u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+    u64 start = offset & ~(page_size - 1);
+    void* address = (u8*)view->data + start;
+    size += offset - start;
+
+    if (hints & FILE_ACCESS_SEQUENTIAL)
+    {
+        madvise(address, size, MADV_SEQUENTIAL);
+    }
+    else if (hints & FILE_ACCESS_RANDOM)
+    {
+        madvise(address, size, MADV_RANDOM);
+    }
+
+    if (hints & FILE_ACCESS_WILL_NEED)
+    {
+        madvise(address, size, MADV_WILLNEED);
+    }
+#endif
+}
+
+b8 filesystem_list_directory(const char* path, filesystem_list_callback callback, void* user_data)
+{
+#if HPLATFORM_WINDOWS
+    char pattern[MAX_PATH];
+    snprintf(pattern, sizeof(pattern), "%s\\*", path);
+
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        HERROR("Error opening directory: '%s'", path);
+        return FALSE;
+    }
+
+    do
+    {
+        if (strcmp(entry.cFileName, ".") == 0 || strcmp(entry.cFileName, "..") == 0) continue;
+        if (!callback(entry.cFileName, (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0, user_data)) break;
+    } while (FindNextFileA(find, &entry));
+
+    FindClose(find);
+#else
+    DIR* dir = opendir(path);
+    if (!dir)
+    {
+        HERROR("Error opening directory: '%s'", path);
+        return FALSE;
+    }
+
+    char entry_path[1024];
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != 0)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        b8 is_directory = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN)
+        {
+            struct stat info;
+            snprintf(entry_path, sizeof(entry_path), "%s/%s", path, entry->d_name);
+            is_directory = stat(entry_path, &info) == 0 && S_ISDIR(info.st_mode);
+        }
+
+        if (!callback(entry->d_name, is_directory, user_data)) break;
+    }
+
+    closedir(dir);
+#endif
+
+    return TRUE;
+}
+
+b8 filesystem_create_directory(const char* path)
+{
+#if HPLATFORM_WINDOWS
+    if (CreateDirectoryA(path, 0) || GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        return TRUE;
+    }
+#else
+    if (mkdir(path, 0755) == 0 || errno == EEXIST)
+    {
+        return TRUE;
+    }
+#endif
+
+    HERROR("Error creating directory: '%s'", path);
+    return FALSE;
+}
+
+b8 filesystem_rename(const char* from, const char* to)
+{
+#if HPLATFORM_WINDOWS
+    b8 result = MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    b8 result = rename(from, to) == 0;
+#endif
+
+    if (!result)
+    {
+        HERROR("Error renaming '%s' to '%s'", from, to);
+    }
+    return result;
 }
\ No newline at end of file
@@ -32,4 +32,48 @@ HAPI b8 filesystem_read_all_bytes(file_handle* handle, u8* out_bytes, u64* out_b
 
 HAPI b8 filesystem_read_all_text(file_handle* handle, char* out_text, u64* out_bytes_read);
 
-HAPI b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
\ No newline at end of file
+HAPI b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
+
+// A read-only view of a whole file mapped into memory.
+typedef struct file_view
+{
+    const void* data;
+    u64 size;
+} file_view;
+
+typedef enum file_access_hint
+{
+    // Read ahead aggressively, pages behind the reader may be dropped early.
+    FILE_ACCESS_SEQUENTIAL = 0x1,
+    // Touched in scattered places, reading ahead would only waste I/O.
+    FILE_ACCESS_RANDOM = 0x2,
+    // Start reading the range in now, ahead of the first access.
+    FILE_ACCESS_WILL_NEED = 0x4
+} file_access_hint;
+
+/**
+ * @brief Maps a file for reading. The view stays valid until filesystem_unmap, pages are read in as they are touched.
+ * The view is advised FILE_ACCESS_SEQUENTIAL | FILE_ACCESS_WILL_NEED, suiting a single pass over the whole file.
+ * An empty file maps to a view with no data.
+ */
+HAPI b8 filesystem_map(const char* path, file_view* out_view);
+
+HAPI void filesystem_unmap(file_view* view);
+
+/**
+ * @brief Tells the system how a range of a view is about to be read. Only a hint, it may be ignored.
+ *
+ * @param hints file_access_hint flags. FILE_ACCESS_SEQUENTIAL and FILE_ACCESS_RANDOM are exclusive.
+ */
+HAPI void filesystem_advise(const file_view* view, u64 offset, u64 size, u32 hints);
+
+// Called for every entry of a directory except "." and "..". Returning FALSE stops the listing.
+typedef b8 (*filesystem_list_callback)(const char* name, b8 is_directory, void* user_data);
+
+HAPI b8 filesystem_list_directory(const char* path, filesystem_list_callback callback, void* user_data);
+
+// Creates a directory, succeeding as well if it exists already. Parents are not created.
+HAPI b8 filesystem_create_directory(const char* path);
+
+// Moves a file, replacing any file at the destination. Within a volume the destination never appears partially written.
+HAPI b8 filesystem_rename(const char* from, const char* to);
\ No newline at end of file
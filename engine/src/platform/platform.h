@@ -7,17 +7,28 @@ typedef struct platform_system_state
     void* internal_state;
 } platform_system_state;
 
-b8 platform_initialize(u64* memory_requirement, void* platform_state, const char* application_name, i32 x, i32 y, i32 width, i32 height);
+// A headless platform opens no window and reports no window events, for runs without a display.
+b8 platform_initialize(u64* memory_requirement, void* platform_state, const char* application_name, i32 x, i32 y, i32 width, i32 height, b8 headless);
 
 void platform_shutdown(void* platform_state);
 
 b8 platform_pump_messages(void* platform_state);
 
+// Blocks until window system events are ready to be pumped or the timeout passes, a negative timeout waits indefinitely.
+b8 platform_wait_for_events(f64 timeout_seconds);
+
+// Waits out the whole timeout unless focus or visibility changes or a close is requested, other events stay queued for the next pump.
+b8 platform_wait_for_focus_change(f64 timeout_seconds);
+
 void* platform_opengl_context_create();
 void platform_opengl_context_delete();
+// Binds the context to the calling thread, or releases it so that another thread can bind it.
+b8 platform_opengl_context_make_current(b8 current);
 b8 platform_swap_buffers();
 
 void* platform_allocate(u64 size, b8 aligned);
+// Large blocks come straight from fresh zero pages, so untouched parts of them cost nothing.
+void* platform_allocate_zeroed(u64 size, b8 aligned);
 void platform_free(void* block, b8 aligned);
 void* platform_zero_memory(void* block, u64 size);
 void* platform_copy_memory(void* dest, const void* src, u64 size);
@@ -26,6 +37,49 @@ void* platform_set_memory(void* block, i32 value, u64 size);
 void platform_console_write(const char* message, u8 color);
 void platform_console_write_error(const char* message, u8 color);
 
-f64 platform_get_absolute_time();
+// Monotonic time in nanoseconds. Integer ticks keep full precision however long the process runs,
+// convert to seconds only where a duration is used.
+HAPI u64 platform_get_ticks_ns();
+
+// Monotonic time in seconds, platform_get_ticks_ns() converted.
+HAPI f64 platform_get_absolute_time();
+
+void platform_sleep(u64 ms);
+
+// Sleeps until platform_get_ticks_ns() reaches deadline_ns, with the best resolution the OS offers.
+void platform_sleep_until_ns(u64 deadline_ns);
+
+// Logical processors available to the process.
+HAPI u32 platform_get_processor_count();
+
+typedef u32 (*platform_thread_start)(void* params);
+
+typedef struct platform_thread
+{
+    void* internal_data;
+} platform_thread;
+
+typedef struct platform_mutex
+{
+    void* internal_data;
+} platform_mutex;
+
+typedef struct platform_semaphore
+{
+    void* internal_data;
+} platform_semaphore;
+
+HAPI b8 platform_thread_create(platform_thread_start start, void* params, platform_thread* out_thread);
+// Waits for the thread to return and releases it.
+HAPI void platform_thread_join(platform_thread* thread);
+HAPI void platform_thread_yield();
+
+HAPI b8 platform_mutex_create(platform_mutex* out_mutex);
+HAPI void platform_mutex_destroy(platform_mutex* mutex);
+HAPI void platform_mutex_lock(platform_mutex* mutex);
+HAPI void platform_mutex_unlock(platform_mutex* mutex);
 
-void platform_sleep(u64 ms);
\ No newline at end of file
+HAPI b8 platform_semaphore_create(u32 initial_count, platform_semaphore* out_semaphore);
+HAPI void platform_semaphore_destroy(platform_semaphore* semaphore);
+HAPI void platform_semaphore_signal(platform_semaphore* semaphore, u32 count);
+HAPI void platform_semaphore_wait(platform_semaphore* semaphore);
\ No newline at end of file
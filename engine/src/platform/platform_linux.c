@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_PLATFORM
+
 #include "platform/platform.h"
 
 #ifdef HPLATFORM_LINUX
@@ -25,8 +27,29 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <unistd.h>
+
+// Reads time from the invariant TSC when the CPU has one, calibrated against CLOCK_MONOTONIC_RAW at startup.
+#ifndef HPLATFORM_TSC_TIMING
+#define HPLATFORM_TSC_TIMING 0
+#endif
+
+#if HPLATFORM_TSC_TIMING && defined(__x86_64__)
+#define TSC_TIMING_AVAILABLE 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#else
+#define TSC_TIMING_AVAILABLE 0
+#endif
 
-typedef struct internal_state
+#define PENDING_EVENT_CAPACITY 64
+
+typedef struct platform_state
 {
     Display* display;
     xcb_connection_t* connection;
@@ -38,7 +61,36 @@ typedef struct internal_state
     GLXContext gl_context;
     GLXWindow gl_window;
     GLXDrawable gl_drawable;
-} internal_state;
+
+    b8 headless;
+
+    // Read while waiting for events and handed to the next pump, oldest first.
+    xcb_generic_event_t* pending_events[PENDING_EVENT_CAPACITY];
+    u32 pending_head;
+    u32 pending_count;
+
+    // Restored when the window is mapped again after being minimized.
+    u16 width;
+    u16 height;
+} platform_state;
+
+static platform_state* state_ptr;
+
+#if TSC_TIMING_AVAILABLE
+// Kept outside of platform_state, timing is used before the platform is initialized.
+typedef struct tsc_timebase
+{
+    b8 enabled;
+    u64 base_tsc;
+    u64 base_ns;
+    // Nanoseconds per tick in 32.32 fixed point.
+    u64 mult;
+} tsc_timebase;
+
+static tsc_timebase timebase;
+
+static void tsc_calibrate();
+#endif
 
 static int visual_attribs[] =
 {
@@ -62,25 +114,44 @@ static int ctxErrorHandler(Display* display, XErrorEvent* event);
 
 keys translate_keycode(u32 x_keycode);
 
-b8 platform_initialize(platform_state* platform_state, const char* application_name, i32 x, i32 y, i32 width, i32 height)
+b8 platform_initialize(u64* memory_requirement, void* state, const char* application_name, i32 x, i32 y, i32 width, i32 height, b8 headless)
 {
-    platform_state->internal_state = malloc(sizeof(internal_state));
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    *memory_requirement = sizeof(platform_state);
+    if (!state) return FALSE;
 
-    state->display = XOpenDisplay(NULL);
+    state_ptr = state;
+    state_ptr->pending_head = 0;
+    state_ptr->pending_count = 0;
+    state_ptr->width = (u16)width;
+    state_ptr->height = (u16)height;
 
-    XAutoRepeatOff(state->display);
+#if TSC_TIMING_AVAILABLE
+    tsc_calibrate();
+#endif
+
+    state_ptr->headless = headless;
+    if (headless)
+    {
+        HINFO("Running headless, no X connection is opened.");
+        return TRUE;
+    }
+
+    // The render thread presents through the same display connection.
+    XInitThreads();
+    state_ptr->display = XOpenDisplay(NULL);
+
+    XAutoRepeatOff(state_ptr->display);
 
     
-    state->connection = XGetXCBConnection(state->display);
+    state_ptr->connection = XGetXCBConnection(state_ptr->display);
 
-    if (xcb_connection_has_error(state->connection))
+    if (xcb_connection_has_error(state_ptr->connection))
     {
         HFATAL("Failed to connect to X server via XCB.");
         return FALSE;
     }
 
-    const struct xcb_setup_t* setup = xcb_get_setup(state->connection);
+    const struct xcb_setup_t* setup = xcb_get_setup(state_ptr->connection);
 
     xcb_screen_iterator_t it = xcb_setup_roots_iterator(setup);
     int screen_p = 0;
@@ -89,16 +160,16 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
         xcb_screen_next(&it);
     }
 
-    state->screen = it.data;
+    state_ptr->screen = it.data;
 
-    state->window = xcb_generate_id(state->connection);
+    state_ptr->window = xcb_generate_id(state_ptr->connection);
 
     GLXFBConfig *fb_configs = 0;
     int num_fb_configs = 0;
     fb_configs = glXChooseFBConfig
     (
-        state->display,
-        DefaultScreen(state->display),
+        state_ptr->display,
+        DefaultScreen(state_ptr->display),
         visual_attribs,
         &num_fb_configs
     );
@@ -110,17 +181,17 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
     }
 
     int visual_id;
-    state->fb_config = fb_configs[0];
-    glXGetFBConfigAttrib(state->display, state->fb_config, GLX_VISUAL_ID , &visual_id);
+    state_ptr->fb_config = fb_configs[0];
+    glXGetFBConfigAttrib(state_ptr->display, state_ptr->fb_config, GLX_VISUAL_ID , &visual_id);
 
-    xcb_colormap_t colormap = xcb_generate_id(state->connection);
-    xcb_window_t window = xcb_generate_id(state->connection);
+    xcb_colormap_t colormap = xcb_generate_id(state_ptr->connection);
+    xcb_window_t window = xcb_generate_id(state_ptr->connection);
     xcb_create_colormap
     (
-        state->connection,
+        state_ptr->connection,
         XCB_COLORMAP_ALLOC_NONE,
         colormap,
-        state->screen->root,
+        state_ptr->screen->root,
         visual_id
     );
 
@@ -129,32 +200,33 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
     u32 event_values = XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
                        XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE |
                        XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_POINTER_MOTION |
-                       XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
+                       XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY |
+                       XCB_EVENT_MASK_FOCUS_CHANGE;
 
-    u32 value_list[] = {state->screen->black_pixel, event_values};
+    u32 value_list[] = {state_ptr->screen->black_pixel, event_values};
 
     xcb_void_cookie_t cookie = xcb_create_window
     (
-        state->connection,
+        state_ptr->connection,
         XCB_COPY_FROM_PARENT,
-        state->window,
-        state->screen->root,
+        state_ptr->window,
+        state_ptr->screen->root,
         x,
         y,
         width,
         height,
         0,
         XCB_WINDOW_CLASS_INPUT_OUTPUT,
-        state->screen->root_visual,
+        state_ptr->screen->root_visual,
         event_mask,
         value_list
     );
 
     xcb_change_property
     (
-        state->connection,
+        state_ptr->connection,
         XCB_PROP_MODE_REPLACE,
-        state->window,
+        state_ptr->window,
         XCB_ATOM_WM_NAME,
         XCB_ATOM_STRING,
         8,
@@ -164,38 +236,38 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
 
     xcb_intern_atom_cookie_t wm_delete_cookie = xcb_intern_atom
     (
-        state->connection,
+        state_ptr->connection,
         0,
         strlen("WM_DELETE_WINDOW"),
         "WM_DELETE_WINDOW"
     );
     xcb_intern_atom_cookie_t wm_protocols_cookie = xcb_intern_atom
     (
-        state->connection,
+        state_ptr->connection,
         0,
         strlen("WM_PROTOCOLS"),
         "WM_PROTOCOLS"
     );
     xcb_intern_atom_reply_t* wm_delete_reply = xcb_intern_atom_reply
     (
-        state->connection,
+        state_ptr->connection,
         wm_delete_cookie,
         NULL
     );
     xcb_intern_atom_reply_t* wm_protocols_reply = xcb_intern_atom_reply
     (
-        state->connection,
+        state_ptr->connection,
         wm_protocols_cookie,
         NULL
     );
-    state->wm_delete_win = wm_delete_reply->atom;
-    state->wm_protocols = wm_protocols_reply->atom;
+    state_ptr->wm_delete_win = wm_delete_reply->atom;
+    state_ptr->wm_protocols = wm_protocols_reply->atom;
 
     xcb_change_property
     (
-        state->connection,
+        state_ptr->connection,
         XCB_PROP_MODE_REPLACE,
-        state->window,
+        state_ptr->window,
         wm_protocols_reply->atom,
         4,
         32,
@@ -203,9 +275,9 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
         &wm_delete_reply->atom
     );
 
-    xcb_map_window(state->connection, state->window);
+    xcb_map_window(state_ptr->connection, state_ptr->window);
 
-    i32 stream_result = xcb_flush(state->connection);
+    i32 stream_result = xcb_flush(state_ptr->connection);
     if (stream_result <= 0)
     {
         HFATAL("An error occurred when flushing the stream: %d", stream_result);
@@ -215,55 +287,188 @@ b8 platform_initialize(platform_state* platform_state, const char* application_n
     return TRUE;
 }
 
-void platform_shutdown(platform_state* platform_state)
+void platform_shutdown(void* state)
+{
+    if (state_ptr->headless) return;
+
+    XAutoRepeatOn(state_ptr->display);
+
+    for (u32 i = 0; i < state_ptr->pending_count; ++i)
+    {
+        free(state_ptr->pending_events[(state_ptr->pending_head + i) % PENDING_EVENT_CAPACITY]);
+    }
+    state_ptr->pending_count = 0;
+
+    xcb_destroy_window(state_ptr->connection, state_ptr->window);
+}
+
+static void queue_event(xcb_generic_event_t* event)
+{
+    u32 tail = (state_ptr->pending_head + state_ptr->pending_count) % PENDING_EVENT_CAPACITY;
+    state_ptr->pending_events[tail] = event;
+    state_ptr->pending_count++;
+}
+
+static xcb_generic_event_t* next_event()
+{
+    if (state_ptr->pending_count)
+    {
+        xcb_generic_event_t* event = state_ptr->pending_events[state_ptr->pending_head];
+        state_ptr->pending_head = (state_ptr->pending_head + 1) % PENDING_EVENT_CAPACITY;
+        state_ptr->pending_count--;
+        return event;
+    }
+
+    return xcb_poll_for_event(state_ptr->connection);
+}
+
+// Focus, visibility and close requests, the events a throttled background loop has to react to.
+static b8 is_wake_event(xcb_generic_event_t* event)
+{
+    switch (event->response_type & ~0x80)
+    {
+        case XCB_FOCUS_IN:
+        case XCB_FOCUS_OUT:
+        case XCB_MAP_NOTIFY:
+        case XCB_UNMAP_NOTIFY:
+        case XCB_CLIENT_MESSAGE:
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void wait_for_socket(f64 timeout_seconds)
+{
+    struct pollfd fd;
+    fd.fd = xcb_get_file_descriptor(state_ptr->connection);
+    fd.events = POLLIN;
+    fd.revents = 0;
+
+    i32 timeout_ms = timeout_seconds < 0 ? -1 : (i32)(timeout_seconds * 1000.0);
+
+    while (poll(&fd, 1, timeout_ms) < 0 && errno == EINTR)
+    {
+    }
+}
+
+b8 platform_wait_for_events(f64 timeout_seconds)
+{
+    if (state_ptr->headless)
+    {
+        if (timeout_seconds > 0)
+        {
+            platform_sleep_until_ns(platform_get_ticks_ns() + (u64)(timeout_seconds * 1000000000.0));
+        }
+        return FALSE;
+    }
+
+    if (state_ptr->pending_count)
+    {
+        return TRUE;
+    }
+
+    // xcb may already hold events read from the socket, which poll would not see.
+    xcb_flush(state_ptr->connection);
+    xcb_generic_event_t* event = xcb_poll_for_event(state_ptr->connection);
+    if (!event)
+    {
+        wait_for_socket(timeout_seconds);
+        event = xcb_poll_for_event(state_ptr->connection);
+    }
+
+    if (!event) return FALSE;
+
+    queue_event(event);
+    return TRUE;
+}
+
+b8 platform_wait_for_focus_change(f64 timeout_seconds)
 {
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    u64 deadline_ns = platform_get_ticks_ns() + (timeout_seconds > 0 ? (u64)(timeout_seconds * 1000000000.0) : 0);
+
+    if (state_ptr->headless)
+    {
+        platform_sleep_until_ns(deadline_ns);
+        return FALSE;
+    }
+
+    for (u32 i = 0; i < state_ptr->pending_count; ++i)
+    {
+        if (is_wake_event(state_ptr->pending_events[(state_ptr->pending_head + i) % PENDING_EVENT_CAPACITY]))
+        {
+            return TRUE;
+        }
+    }
 
-    XAutoRepeatOff(state->display);
+    xcb_flush(state_ptr->connection);
 
-    xcb_destroy_window(state->connection, state->window);
+    for (;;)
+    {
+        // Everything else, like pointer motion over the window, stays queued for the next pump.
+        xcb_generic_event_t* event;
+        while (state_ptr->pending_count < PENDING_EVENT_CAPACITY && (event = xcb_poll_for_event(state_ptr->connection)) != 0)
+        {
+            queue_event(event);
+            if (is_wake_event(event))
+            {
+                return TRUE;
+            }
+        }
+
+        if (state_ptr->pending_count == PENDING_EVENT_CAPACITY)
+        {
+            return TRUE;
+        }
+
+        u64 now = platform_get_ticks_ns();
+        if (now >= deadline_ns)
+        {
+            return FALSE;
+        }
+
+        // Rounded up so the last sub-millisecond does not spin on a zero timeout.
+        wait_for_socket((deadline_ns - now) * 0.000000001 + 0.001);
+    }
 }
 
-b8 platform_pump_messages(platform_state* platform_state)
+b8 platform_pump_messages(void* state)
 {
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    if (state_ptr->headless) return TRUE;
 
     xcb_generic_event_t* event;
     xcb_client_message_event_t* cm;
 
     b8 quit_flagged = FALSE;
 
-    while(event != 0)
+    while ((event = next_event()) != 0)
     {
-        event = xcb_poll_for_event(state->connection);
-        if (event == 0)
-        {
-            break;
-        }
+        // Taken as each event is read so input latency can be measured from here.
+        u64 timestamp = platform_get_ticks_ns();
+        u8 event_type = event->response_type & ~0x80;
 
-        switch(event->response_type & ~0x80)
+        switch (event_type)
         {
             case XCB_KEY_PRESS:
             case XCB_KEY_RELEASE:
                 {
                     xcb_key_press_event_t* kb_event = (xcb_key_press_event_t*)event;
-                    b8 pressed = event->response_type == XCB_KEY_PRESS;
+                    b8 pressed = event_type == XCB_KEY_PRESS;
                     xcb_keycode_t code = kb_event->detail;
                     KeySym key_sym = XkbKeycodeToKeysym
                     (
-                        state->display,
+                        state_ptr->display,
                         (KeyCode)code,
                         0,
                         code & ShiftMask ? 1 : 0
                     );
                     keys key = translate_keycode(key_sym);
-                    input_process_key(key, pressed);
+                    input_process_key(key, pressed, timestamp);
                 } break;
             case XCB_BUTTON_PRESS:
             case XCB_BUTTON_RELEASE:
                 {
                     xcb_button_press_event_t* mouse_event = (xcb_button_press_event_t*)event;
-                    b8 pressed = event->response_type == XCB_BUTTON_PRESS;
+                    b8 pressed = event_type == XCB_BUTTON_PRESS;
                     buttons button = BUTTON_MAX_BUTTONS;
                     switch (mouse_event->detail)
                     {
@@ -279,27 +484,49 @@ b8 platform_pump_messages(platform_state* platform_state)
                     }
                     if (button != BUTTON_MAX_BUTTONS)
                     {
-                        input_process_button(button, pressed);
+                        input_process_button(button, pressed, timestamp);
                     }
                 } break;
             case XCB_MOTION_NOTIFY:
                 {
                     xcb_motion_notify_event_t* move_event = (xcb_motion_notify_event_t*)event;
-                    input_process_mouse_move(move_event->event_x, move_event->event_y);
+                    input_process_mouse_move(move_event->event_x, move_event->event_y, timestamp);
                 } break;
             case XCB_CONFIGURE_NOTIFY:
                 {
                     xcb_configure_notify_event_t* configure_event = (xcb_configure_notify_event_t*)event;
 
-                    event_context event;
-                    event.data.u16[0] = configure_event->width;
-                    event.data.u16[1] = configure_event->height;
-                    event_post(EVENT_RESIZED, 0, event);
+                    state_ptr->width = configure_event->width;
+                    state_ptr->height = configure_event->height;
+
+                    event_context context = {};
+                    context.data.u16[0] = configure_event->width;
+                    context.data.u16[1] = configure_event->height;
+                    event_post(EVENT_RESIZED, 0, context);
+                } break;
+            case XCB_UNMAP_NOTIFY:
+            case XCB_MAP_NOTIFY:
+                {
+                    // X has no zero sized minimized state, so report one to match the other platforms.
+                    event_context context = {};
+                    if (event_type == XCB_MAP_NOTIFY)
+                    {
+                        context.data.u16[0] = state_ptr->width;
+                        context.data.u16[1] = state_ptr->height;
+                    }
+                    event_post(EVENT_RESIZED, 0, context);
+                } break;
+            case XCB_FOCUS_IN:
+            case XCB_FOCUS_OUT:
+                {
+                    event_context context = {};
+                    context.data.u8[0] = event_type == XCB_FOCUS_IN;
+                    event_post(EVENT_FOCUS_CHANGED, 0, context);
                 } break;
             case XCB_CLIENT_MESSAGE:
                 cm = (xcb_client_message_event_t*)event;
 
-                if (cm->data.data32[0] == state->wm_delete_win)
+                if (cm->data.data32[0] == state_ptr->wm_delete_win)
                 {
                     quit_flagged = TRUE;
                 }
@@ -317,6 +544,11 @@ void* platform_allocate(u64 size, b8 aligned)
     return malloc(size);
 }
 
+void* platform_allocate_zeroed(u64 size, b8 aligned)
+{
+    return calloc(1, size);
+}
+
 void platform_free(void* block, b8 aligned)
 {
     free(block);
@@ -349,11 +581,59 @@ void platform_console_write_error(const char* message, u8 color)
     printf("\033[%sm%s\033[0m", color_strings[color], message);
 }
 
-f64 platform_get_absolute_time()
+static u64 clock_ns(clockid_t clock_id)
 {
     struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    return now.tv_sec + now.tv_nsec * 0.000000001;
+    clock_gettime(clock_id, &now);
+    return (u64)now.tv_sec * 1000000000ull + (u64)now.tv_nsec;
+}
+
+#if TSC_TIMING_AVAILABLE
+static void tsc_calibrate()
+{
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1 << 8)))
+    {
+        HDEBUG("No invariant TSC, timing uses clock_gettime.");
+        return;
+    }
+
+    u64 raw_start = clock_ns(CLOCK_MONOTONIC_RAW);
+    u64 tsc_start = __rdtsc();
+    platform_sleep(20);
+    u64 raw_end = clock_ns(CLOCK_MONOTONIC_RAW);
+    u64 tsc_end = __rdtsc();
+
+    if (tsc_end <= tsc_start)
+    {
+        return;
+    }
+
+    timebase.mult = ((raw_end - raw_start) << 32) / (tsc_end - tsc_start);
+    // Continue from the clock the ticks were read from so far.
+    timebase.base_ns = clock_ns(CLOCK_MONOTONIC);
+    timebase.base_tsc = __rdtsc();
+    timebase.enabled = TRUE;
+
+    HDEBUG("Timing uses the TSC at %.3f GHz.", (tsc_end - tsc_start) / (f64)(raw_end - raw_start));
+}
+#endif
+
+u64 platform_get_ticks_ns()
+{
+#if TSC_TIMING_AVAILABLE
+    if (timebase.enabled)
+    {
+        return timebase.base_ns + (u64)(((unsigned __int128)(__rdtsc() - timebase.base_tsc) * timebase.mult) >> 32);
+    }
+#endif
+
+    return clock_ns(CLOCK_MONOTONIC);
+}
+
+f64 platform_get_absolute_time()
+{
+    return platform_get_ticks_ns() * 0.000000001;
 }
 
 void platform_sleep(u64 ms)
@@ -372,60 +652,217 @@ void platform_sleep(u64 ms)
 #endif
 }
 
-void* platform_opengl_context_create(platform_state* platform_state)
+void platform_sleep_until_ns(u64 deadline_ns)
+{
+    // Same clock as platform_get_ticks_ns, so the deadline does not drift with relative sleeps.
+
+#if TSC_TIMING_AVAILABLE
+    if (timebase.enabled)
+    {
+        // The TSC slowly drifts away from CLOCK_MONOTONIC, so carry over only the remaining time.
+        u64 now = platform_get_ticks_ns();
+        if (deadline_ns <= now)
+        {
+            return;
+        }
+        deadline_ns = clock_ns(CLOCK_MONOTONIC) + (deadline_ns - now);
+    }
+#endif
+
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+    deadline.tv_nsec = (long)(deadline_ns % 1000000000ull);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR)
+    {
+    }
+}
+
+u32 platform_get_processor_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+typedef struct linux_thread
+{
+    pthread_t handle;
+    platform_thread_start start;
+    void* params;
+} linux_thread;
+
+static void* thread_trampoline(void* params)
+{
+    linux_thread* thread = params;
+    thread->start(thread->params);
+    return 0;
+}
+
+b8 platform_thread_create(platform_thread_start start, void* params, platform_thread* out_thread)
 {
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    linux_thread* thread = malloc(sizeof(linux_thread));
+    thread->start = start;
+    thread->params = params;
+
+    i32 result = pthread_create(&thread->handle, 0, thread_trampoline, thread);
+    if (result != 0)
+    {
+        HERROR("pthread_create failed with error %i.", result);
+        free(thread);
+        out_thread->internal_data = 0;
+        return FALSE;
+    }
 
-    state->gl_context = glXCreateNewContext
+    out_thread->internal_data = thread;
+    return TRUE;
+}
+
+void platform_thread_join(platform_thread* thread)
+{
+    if (!thread->internal_data) return;
+
+    linux_thread* internal = thread->internal_data;
+    pthread_join(internal->handle, 0);
+    free(internal);
+    thread->internal_data = 0;
+}
+
+void platform_thread_yield()
+{
+    sched_yield();
+}
+
+b8 platform_mutex_create(platform_mutex* out_mutex)
+{
+    pthread_mutex_t* mutex = malloc(sizeof(pthread_mutex_t));
+    if (pthread_mutex_init(mutex, 0) != 0)
+    {
+        HERROR("pthread_mutex_init failed.");
+        free(mutex);
+        out_mutex->internal_data = 0;
+        return FALSE;
+    }
+
+    out_mutex->internal_data = mutex;
+    return TRUE;
+}
+
+void platform_mutex_destroy(platform_mutex* mutex)
+{
+    if (!mutex->internal_data) return;
+
+    pthread_mutex_destroy(mutex->internal_data);
+    free(mutex->internal_data);
+    mutex->internal_data = 0;
+}
+
+void platform_mutex_lock(platform_mutex* mutex)
+{
+    pthread_mutex_lock(mutex->internal_data);
+}
+
+void platform_mutex_unlock(platform_mutex* mutex)
+{
+    pthread_mutex_unlock(mutex->internal_data);
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore* out_semaphore)
+{
+    sem_t* semaphore = malloc(sizeof(sem_t));
+    if (sem_init(semaphore, 0, initial_count) != 0)
+    {
+        HERROR("sem_init failed with error %i.", errno);
+        free(semaphore);
+        out_semaphore->internal_data = 0;
+        return FALSE;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return TRUE;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore)
+{
+    if (!semaphore->internal_data) return;
+
+    sem_destroy(semaphore->internal_data);
+    free(semaphore->internal_data);
+    semaphore->internal_data = 0;
+}
+
+void platform_semaphore_signal(platform_semaphore* semaphore, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        sem_post(semaphore->internal_data);
+    }
+}
+
+void platform_semaphore_wait(platform_semaphore* semaphore)
+{
+    while (sem_wait(semaphore->internal_data) == -1 && errno == EINTR)
+    {
+    }
+}
+
+void* platform_opengl_context_create()
+{
+    state_ptr->gl_context = glXCreateNewContext
     (
-        state->display,
-        state->fb_config,
+        state_ptr->display,
+        state_ptr->fb_config,
         GLX_RGBA_TYPE,
         0,
         True
     );
 
-    if (!state->gl_context)
+    if (!state_ptr->gl_context)
     {
         // TODO: ERROR HANDLING
         HFATAL("Failed to create OpenGL context, shutting down.");
         return 0;
     }
     
-    state->gl_window = glXCreateWindow
+    state_ptr->gl_window = glXCreateWindow
     (
-        state->display,
-        state->fb_config,
-        state->window,
+        state_ptr->display,
+        state_ptr->fb_config,
+        state_ptr->window,
         0
     );
 
-    state->gl_drawable = state->gl_window;
+    state_ptr->gl_drawable = state_ptr->gl_window;
 
-    if (!glXMakeContextCurrent(state->display, state->gl_drawable, state->gl_drawable, state->gl_context))
+    if (!glXMakeContextCurrent(state_ptr->display, state_ptr->gl_drawable, state_ptr->gl_drawable, state_ptr->gl_context))
     {
         // TODO: ERROR HANDLING
         HFATAL("Failed to make OpenGL context current, shutting down.");
         return 0;
     }
 
-    return state->gl_context;
+    return state_ptr->gl_context;
 }
 
-void platform_opengl_context_delete(platform_state* platform_state)
+b8 platform_opengl_context_make_current(b8 current)
 {
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    if (!current)
+    {
+        return glXMakeContextCurrent(state_ptr->display, None, None, 0);
+    }
 
-    glXDestroyWindow(state->display, state->gl_window);
-    glXDestroyContext(state->display, state->gl_context);
+    return glXMakeContextCurrent(state_ptr->display, state_ptr->gl_drawable, state_ptr->gl_drawable, state_ptr->gl_context);
 }
 
-b8 platform_swap_buffers(platform_state* platform_state)
+void platform_opengl_context_delete()
 {
-    // TODO: ERROR HANDLING
-    internal_state* state = (internal_state*)platform_state->internal_state;
+    glXDestroyWindow(state_ptr->display, state_ptr->gl_window);
+    glXDestroyContext(state_ptr->display, state_ptr->gl_context);
+}
 
-    glXSwapBuffers(state->display, state->gl_drawable);
+b8 platform_swap_buffers()
+{
+    // TODO: ERROR HANDLING
+    glXSwapBuffers(state_ptr->display, state_ptr->gl_drawable);
 
     return TRUE;
 }
@@ -585,7 +1022,7 @@ keys translate_keycode(u32 x_keycode)
             return KEY_RCONTROL;
         case XK_Alt_L:
             return KEY_LALT;
-        case XK_ALT_R:
+        case XK_Alt_R:
             return KEY_RALT;
 
         case XK_semicolon:
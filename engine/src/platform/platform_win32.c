@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_PLATFORM
+
 #include "platform/platform.h"
 
 #if HPLATFORM_WINDOWS
@@ -16,24 +18,25 @@ typedef struct platform_state
     HWND hwnd;
     HDC window_device_handle;
     HGLRC gl_context;
+
+    // Set by the window procedure for focus, size and close messages.
+    b8 wake_requested;
 } platform_state;
 
 static platform_state* state_ptr;
 
-f64 clock_frequency;
-LARGE_INTEGER start_time;
+static u64 clock_frequency;
 
 LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param);
 
 void clock_setup()
 {
     LARGE_INTEGER frequency;
-    QueryPerformanceCounter(&frequency);
-    clock_frequency = 1.0 / (f64)frequency.QuadPart;
-    QueryPerformanceCounter(&start_time);
+    QueryPerformanceFrequency(&frequency);
+    clock_frequency = (u64)frequency.QuadPart;
 }
 
-b8 platform_initialize(u64* memory_requirement, void* state, const char* application_name, i32 x, i32 y, i32 width, i32 height)
+b8 platform_initialize(u64* memory_requirement, void* state, const char* application_name, i32 x, i32 y, i32 width, i32 height, b8 headless)
 {
     *memory_requirement = sizeof(platform_state);
     if (!state) return FALSE;
@@ -41,6 +44,14 @@ b8 platform_initialize(u64* memory_requirement, void* state, const char* applica
     state_ptr = state;
 
     state_ptr->h_instance = GetModuleHandleA(0);
+    state_ptr->hwnd = 0;
+
+    if (headless)
+    {
+        // No window to own the console, so it stays visible for the output.
+        clock_setup();
+        return TRUE;
+    }
 
     HICON icon = LoadIcon(state_ptr->h_instance, IDI_APPLICATION);
 
@@ -134,11 +145,50 @@ b8 platform_pump_messages(void* state)
     return TRUE;
 }
 
+b8 platform_wait_for_events(f64 timeout_seconds)
+{
+    DWORD timeout_ms = timeout_seconds < 0 ? INFINITE : (DWORD)(timeout_seconds * 1000.0);
+
+    // Returns as soon as anything is posted to this thread's queue, including input.
+    return MsgWaitForMultipleObjects(0, 0, FALSE, timeout_ms, QS_ALLINPUT) == WAIT_OBJECT_0;
+}
+
+b8 platform_wait_for_focus_change(f64 timeout_seconds)
+{
+    u64 deadline_ns = platform_get_ticks_ns() + (timeout_seconds > 0 ? (u64)(timeout_seconds * 1000000000.0) : 0);
+    state_ptr->wake_requested = FALSE;
+
+    MSG message;
+    for (;;)
+    {
+        // Peeking delivers sent messages, which is how focus changes arrive, and leaves posted input queued.
+        PeekMessageA(&message, NULL, 0, 0, PM_NOREMOVE);
+        if (state_ptr->wake_requested || PeekMessageA(&message, NULL, WM_QUIT, WM_QUIT, PM_NOREMOVE))
+        {
+            return TRUE;
+        }
+
+        u64 now = platform_get_ticks_ns();
+        if (now >= deadline_ns)
+        {
+            return FALSE;
+        }
+
+        // Only input newer than the last peek wakes this, so queued mouse moves do not spin it.
+        MsgWaitForMultipleObjects(0, 0, FALSE, (DWORD)((deadline_ns - now) / 1000000) + 1, QS_ALLINPUT);
+    }
+}
+
 void* platform_allocate(u64 size, b8 aligned)
 {
     return malloc(size);
 }
 
+void* platform_allocate_zeroed(u64 size, b8 aligned)
+{
+    return calloc(1, size);
+}
+
 void platform_free(void* block, b8 aligned)
 {
     free(block);
@@ -185,7 +235,7 @@ void platform_console_write_error(const char* message, u8 color)
     WriteConsoleA(console_handle, message, (DWORD)length, number_written, 0);
 }
 
-f64 platform_get_absolute_time()
+u64 platform_get_ticks_ns()
 {
     if (!clock_frequency)
     {
@@ -194,8 +244,15 @@ f64 platform_get_absolute_time()
 
     LARGE_INTEGER now_time;
     QueryPerformanceCounter(&now_time);
-    
-    return (f64)now_time.QuadPart * clock_frequency;
+
+    // Split so that the multiplication cannot overflow however large the counter gets.
+    u64 counter = (u64)now_time.QuadPart;
+    return (counter / clock_frequency) * 1000000000ull + ((counter % clock_frequency) * 1000000000ull) / clock_frequency;
+}
+
+f64 platform_get_absolute_time()
+{
+    return platform_get_ticks_ns() * 0.000000001;
 }
 
 void platform_sleep(u64 ms)
@@ -203,6 +260,159 @@ void platform_sleep(u64 ms)
     Sleep(ms);
 }
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void platform_sleep_until_ns(u64 deadline_ns)
+{
+    static HANDLE timer = 0;
+    if (!timer)
+    {
+        // High resolution timers need Windows 10 1803, older versions fall back to a regular one.
+        timer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer)
+        {
+            timer = CreateWaitableTimerExW(0, 0, 0, TIMER_ALL_ACCESS);
+        }
+    }
+
+    u64 now = platform_get_ticks_ns();
+    if (deadline_ns <= now)
+    {
+        return;
+    }
+    u64 remaining_ns = deadline_ns - now;
+
+    if (!timer)
+    {
+        Sleep((DWORD)(remaining_ns / 1000000));
+        return;
+    }
+
+    // Negative due times are relative, in 100 nanosecond units.
+    LARGE_INTEGER due_time;
+    due_time.QuadPart = -(LONGLONG)(remaining_ns / 100);
+    SetWaitableTimer(timer, &due_time, 0, 0, 0, FALSE);
+    WaitForSingleObject(timer, INFINITE);
+}
+
+u32 platform_get_processor_count()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+}
+
+typedef struct win32_thread
+{
+    HANDLE handle;
+    platform_thread_start start;
+    void* params;
+} win32_thread;
+
+static DWORD WINAPI thread_trampoline(LPVOID params)
+{
+    win32_thread* thread = params;
+    return (DWORD)thread->start(thread->params);
+}
+
+b8 platform_thread_create(platform_thread_start start, void* params, platform_thread* out_thread)
+{
+    win32_thread* thread = malloc(sizeof(win32_thread));
+    thread->start = start;
+    thread->params = params;
+
+    thread->handle = CreateThread(0, 0, thread_trampoline, thread, 0, 0);
+    if (!thread->handle)
+    {
+        HERROR("CreateThread failed with error %lu.", GetLastError());
+        free(thread);
+        out_thread->internal_data = 0;
+        return FALSE;
+    }
+
+    out_thread->internal_data = thread;
+    return TRUE;
+}
+
+void platform_thread_join(platform_thread* thread)
+{
+    if (!thread->internal_data) return;
+
+    win32_thread* internal = thread->internal_data;
+    WaitForSingleObject(internal->handle, INFINITE);
+    CloseHandle(internal->handle);
+    free(internal);
+    thread->internal_data = 0;
+}
+
+void platform_thread_yield()
+{
+    SwitchToThread();
+}
+
+b8 platform_mutex_create(platform_mutex* out_mutex)
+{
+    SRWLOCK* lock = malloc(sizeof(SRWLOCK));
+    InitializeSRWLock(lock);
+    out_mutex->internal_data = lock;
+    return TRUE;
+}
+
+void platform_mutex_destroy(platform_mutex* mutex)
+{
+    if (!mutex->internal_data) return;
+
+    free(mutex->internal_data);
+    mutex->internal_data = 0;
+}
+
+void platform_mutex_lock(platform_mutex* mutex)
+{
+    AcquireSRWLockExclusive(mutex->internal_data);
+}
+
+void platform_mutex_unlock(platform_mutex* mutex)
+{
+    ReleaseSRWLockExclusive(mutex->internal_data);
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore* out_semaphore)
+{
+    HANDLE semaphore = CreateSemaphoreW(0, (LONG)initial_count, 0x7FFFFFFF, 0);
+    if (!semaphore)
+    {
+        HERROR("CreateSemaphore failed with error %lu.", GetLastError());
+        out_semaphore->internal_data = 0;
+        return FALSE;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return TRUE;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore)
+{
+    if (!semaphore->internal_data) return;
+
+    CloseHandle(semaphore->internal_data);
+    semaphore->internal_data = 0;
+}
+
+void platform_semaphore_signal(platform_semaphore* semaphore, u32 count)
+{
+    if (count)
+    {
+        ReleaseSemaphore(semaphore->internal_data, (LONG)count, 0);
+    }
+}
+
+void platform_semaphore_wait(platform_semaphore* semaphore)
+{
+    WaitForSingleObject(semaphore->internal_data, INFINITE);
+}
+
 LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param)
 {
     switch (msg)
@@ -238,6 +448,7 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
             return 1;
         case WM_CLOSE:
             {
+                state_ptr->wake_requested = TRUE;
                 event_context event = {};
                 event_post(EVENT_APPLICATION_QUIT, 0, event);
                 return 1;
@@ -247,6 +458,7 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
             return 0;
         case WM_SIZE:
             {
+                state_ptr->wake_requested = TRUE;
                 RECT r;
                 GetClientRect(hwnd, &r);
 
@@ -256,6 +468,15 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
 
                 event_post(EVENT_RESIZED, 0, event);
             } break;
+        case WM_SETFOCUS:
+        case WM_KILLFOCUS:
+            {
+                event_context event = {};
+                state_ptr->wake_requested = TRUE;
+                event.data.u8[0] = msg == WM_SETFOCUS;
+
+                event_post(EVENT_FOCUS_CHANGED, 0, event);
+            } break;
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
         case WM_KEYUP:
@@ -282,19 +503,19 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
                     key = is_extended ? KEY_RCONTROL : KEY_LCONTROL;
                 }
 
-                input_process_key(key, pressed);
+                input_process_key(key, pressed, platform_get_ticks_ns());
             } break;
         case WM_MOUSEMOVE:
             i32 x_position = GET_X_LPARAM(l_param);
             i32 y_position = GET_Y_LPARAM(l_param);
-            input_process_mouse_move(x_position, y_position);
+            input_process_mouse_move(x_position, y_position, platform_get_ticks_ns());
             break;
         case WM_MOUSEWHEEL:
             i32 z_delta = GET_WHEEL_DELTA_WPARAM(w_param);
             if (z_delta != 0) 
             {
                 z_delta = (z_delta < 0) ? -1 : 1;
-                input_process_mouse_wheel(z_delta);
+                input_process_mouse_wheel(z_delta, platform_get_ticks_ns());
             }
             break;
         case WM_LBUTTONDOWN:
@@ -322,7 +543,7 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
             }
             if (button != BUTTON_MAX_BUTTONS)
             {
-                input_process_button(button, pressed);
+                input_process_button(button, pressed, platform_get_ticks_ns());
             }
             break;
     }
@@ -351,6 +572,16 @@ void* platform_opengl_context_create()
     return state_ptr->gl_context;
 }
 
+b8 platform_opengl_context_make_current(b8 current)
+{
+    if (!current)
+    {
+        return wglMakeCurrent(0, 0);
+    }
+
+    return wglMakeCurrent(state_ptr->window_device_handle, state_ptr->gl_context);
+}
+
 void platform_opengl_context_delete()
 {
     wglDeleteContext(state_ptr->gl_context);
@@ -8,9 +8,11 @@ typedef struct program
 
     b8 (*initialize)(struct program* program_inst);
 
+    // With a fixed update rate, delta_time is always the fixed step.
     b8 (*update)(struct program* program_inst, f32 delta_time);
     
-    b8 (*render)(struct program* program_inst, f32 delta_time);
+    // interpolation_alpha is how far the frame is between the last two fixed updates, 1 without a fixed update rate.
+    b8 (*render)(struct program* program_inst, f32 delta_time, f32 interpolation_alpha);
 
     void (*on_resize)(struct program* program_inst, u32 width, u32 height);
 
@@ -0,0 +1,124 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RENDERER
+
+#include "null_backend.h"
+
+#include "core/logger.h"
+
+#include "memory/hmemory.h"
+
+typedef struct null_backend_context
+{
+    null_backend_stats stats;
+    u32 next_texture_handle;
+    u32 next_geometry_id;
+} null_backend_context;
+
+// Only one renderer backend exists at a time, same as the OpenGL context.
+static null_backend_context context;
+
+b8 null_backend_initialize(renderer_backend* backend, const char* application_name)
+{
+    hzero_memory(&context, sizeof(null_backend_context));
+
+    HINFO("Null renderer backend initialized, nothing will be drawn.");
+
+    return TRUE;
+}
+
+void null_backend_shutdown(renderer_backend* backend)
+{
+    HINFO("Null renderer: %llu frames, %llu draws, %llu/%llu textures and %llu/%llu geometries created/destroyed, %llu bytes uploaded.",
+        context.stats.frames, context.stats.draws,
+        context.stats.textures_created, context.stats.textures_destroyed,
+        context.stats.geometries_created, context.stats.geometries_destroyed,
+        context.stats.bytes_uploaded);
+}
+
+void null_backend_on_resized(renderer_backend* backend, u16 width, u16 height)
+{
+}
+
+b8 null_backend_begin_frame(renderer_backend* backend, f32 delta_time)
+{
+    return TRUE;
+}
+
+void null_backend_update_global_state(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_color, i32 mode)
+{
+}
+
+b8 null_backend_end_frame(renderer_backend* backend, f32 delta_time)
+{
+    context.stats.frames++;
+    return TRUE;
+}
+
+void null_backend_create_texture(const u8* pixels, texture* texture)
+{
+    // Handles only need to be unique and valid, 0 is left unused like a GL name.
+    texture->handle = ++context.next_texture_handle;
+
+    context.stats.textures_created++;
+
+    u32 mip_count = texture->mip_count ? texture->mip_count : 1;
+    u32 width = texture->width;
+    u32 height = texture->height;
+    for (u32 level = 0; level < mip_count; ++level)
+    {
+        context.stats.bytes_uploaded += (u64)width * height * texture->channel_count;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+}
+
+void null_backend_destroy_texture(texture* texture)
+{
+    // Reloads destroy the previous texture even if it never reached the renderer, like deleting GL name 0.
+    if (texture->handle != 0 && texture->handle != INVALID_ID)
+    {
+        context.stats.textures_destroyed++;
+    }
+
+    texture->handle = INVALID_ID;
+}
+
+b8 null_backend_create_geometry(geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count, const u32* indices)
+{
+    if (!vertex_count || !vertices)
+    {
+        HERROR("null_backend_create_geometry requires vertex data and none was supplied. vertex_count=%d, vertices=%p", vertex_count, vertices);
+        return FALSE;
+    }
+
+    if (geometry->internal_id == INVALID_ID)
+    {
+        geometry->internal_id = context.next_geometry_id++;
+        context.stats.geometries_created++;
+    }
+
+    context.stats.bytes_uploaded += (u64)vertex_count * sizeof(vertex_3d) + (u64)index_count * sizeof(u32);
+
+    return TRUE;
+}
+
+void null_backend_destroy_geometry(geometry* geometry)
+{
+    if (geometry->internal_id != INVALID_ID)
+    {
+        geometry->internal_id = INVALID_ID;
+        context.stats.geometries_destroyed++;
+    }
+}
+
+void null_backend_draw_geometry(geometry_render_data data)
+{
+    if (data.geometry && data.geometry->internal_id != INVALID_ID)
+    {
+        context.stats.draws++;
+    }
+}
+
+void null_backend_get_stats(null_backend_stats* out_stats)
+{
+    *out_stats = context.stats;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "renderer/renderer_backend.h"
+#include "resources/resource_types.h"
+
+// What the null backend was asked to do, in place of anything reaching a GPU.
+typedef struct null_backend_stats
+{
+    u64 frames;
+    u64 draws;
+    u64 textures_created;
+    u64 textures_destroyed;
+    u64 geometries_created;
+    u64 geometries_destroyed;
+    u64 bytes_uploaded;
+} null_backend_stats;
+
+b8 null_backend_initialize(renderer_backend* backend, const char* application_name);
+
+void null_backend_shutdown(renderer_backend* backend);
+
+void null_backend_on_resized(renderer_backend* backend, u16 width, u16 height);
+
+b8 null_backend_begin_frame(renderer_backend* backend, f32 delta_time);
+
+void null_backend_update_global_state(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_color, i32 mode);
+
+b8 null_backend_end_frame(renderer_backend* backend, f32 delta_time);
+
+void null_backend_create_texture(const u8* pixels, texture* texture);
+
+void null_backend_destroy_texture(texture* texture);
+
+b8 null_backend_create_geometry(geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count, const u32* indices);
+
+void null_backend_destroy_geometry(geometry* geometry);
+
+void null_backend_draw_geometry(geometry_render_data data);
+
+HAPI void null_backend_get_stats(null_backend_stats* out_stats);
\ No newline at end of file
@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RENDERER
+
 #include "opengl_backend.h"
 
 #include "opengl_types.inl"
@@ -85,6 +87,14 @@ void opengl_backend_shutdown(renderer_backend* backend)
     HINFO("OpenGL renderer shut down successfully.");
 }
 
+void opengl_backend_bind_thread(renderer_backend* backend, b8 bind)
+{
+    if (!platform_opengl_context_make_current(bind))
+    {
+        HERROR("Failed to %s the OpenGL context.", bind ? "bind" : "release");
+    }
+}
+
 void opengl_backend_on_resized(renderer_backend* backend, u16 width, u16 height)
 {
     glViewport(0,0,width,height);
@@ -124,22 +134,32 @@ b8 opengl_backend_end_frame(renderer_backend* backend, f32 delta_time)
 
 void opengl_backend_create_texture (const u8* pixels, texture* texture)
 {
-    i32 image_size = texture->width * texture->height * texture->channel_count;
+    u32 mip_count = texture->mip_count ? texture->mip_count : 1;
 
     glGenTextures(1, &texture->handle);
     glActiveTexture((GL_TEXTURE0 - 1) + texture->handle);
     glBindTexture(GL_TEXTURE_2D, texture->handle);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mip_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mip_count - 1);
 
     float aniso = 0.0f;
     glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &aniso);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, aniso);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texture->width, texture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    // Levels follow each other in pixels, each half the size of the one before.
+    u32 width = texture->width;
+    u32 height = texture->height;
+    for (u32 level = 0; level < mip_count; ++level)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        pixels += (u64)width * height * texture->channel_count;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
 }
 
 void opengl_backend_destroy_texture (texture* texture)
@@ -25,4 +25,6 @@ b8 opengl_backend_create_geometry (geometry* geometry, u32 vertex_count, const v
 
 void opengl_backend_destroy_geometry (geometry* geometry);
 
-void opengl_backend_draw_geometry(geometry_render_data data);
\ No newline at end of file
+void opengl_backend_draw_geometry(geometry_render_data data);
+
+void opengl_backend_bind_thread(renderer_backend* backend, b8 bind);
\ No newline at end of file
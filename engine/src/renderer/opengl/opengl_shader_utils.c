@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RENDERER
+
 #include "opengl_shader_utils.h"
 
 #include "core/logger.h"
@@ -46,7 +48,9 @@ b8 create_shader_module(opengl_context* context, const char* name, const char* t
 
     shader_stages[stage_index].shader_handle = glCreateShader(shader_stage_flag);
 
-    glShaderSource(shader_stages[stage_index].shader_handle, 1, (const char* const*)&text_resource.data, 0);
+    // Text resources are not terminated.
+    GLint source_length = (GLint)text_resource.data_size;
+    glShaderSource(shader_stages[stage_index].shader_handle, 1, (const char* const*)&text_resource.data, &source_length);
     glCompileShader(shader_stages[stage_index].shader_handle);
 
     validate_shader_module(context, type_str, &shader_stages[stage_index]);
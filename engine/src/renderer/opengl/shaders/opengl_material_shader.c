@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RENDERER
+
 #include "opengl_material_shader.h"
 
 #include "core/logger.h"
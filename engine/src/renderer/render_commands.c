@@ -0,0 +1,67 @@
+#include "render_commands.h"
+
+#include "memory/hmemory.h"
+
+// Payloads start and end on this boundary so mat4 and pointer fields can be read in place.
+#define RENDER_COMMAND_ALIGNMENT 8
+
+b8 render_command_buffer_create(u64 capacity, render_command_buffer* out_buffer)
+{
+    out_buffer->data = hallocate(capacity, MEMORY_TAG_RENDERER);
+    out_buffer->size = 0;
+    out_buffer->capacity = capacity;
+    return out_buffer->data != 0;
+}
+
+void render_command_buffer_destroy(render_command_buffer* buffer)
+{
+    if (buffer->data)
+    {
+        hfree(buffer->data, buffer->capacity, MEMORY_TAG_RENDERER);
+    }
+    hzero_memory(buffer, sizeof(render_command_buffer));
+}
+
+void render_command_buffer_reset(render_command_buffer* buffer)
+{
+    buffer->size = 0;
+}
+
+void* render_command_buffer_push(render_command_buffer* buffer, render_command_type type, u32 size)
+{
+    u64 command_size = (sizeof(render_command_header) + size + RENDER_COMMAND_ALIGNMENT - 1) & ~(u64)(RENDER_COMMAND_ALIGNMENT - 1);
+
+    if (buffer->size + command_size > buffer->capacity)
+    {
+        u64 capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (capacity < buffer->size + command_size)
+        {
+            capacity *= 2;
+        }
+
+        u8* data = hallocate(capacity, MEMORY_TAG_RENDERER);
+        hcopy_memory(data, buffer->data, buffer->size);
+        hfree(buffer->data, buffer->capacity, MEMORY_TAG_RENDERER);
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    render_command_header* header = (render_command_header*)(buffer->data + buffer->size);
+    header->type = type;
+    header->size = (u32)command_size;
+    buffer->size += command_size;
+
+    return header + 1;
+}
+
+const render_command_header* render_command_buffer_next(const render_command_buffer* buffer, u64* offset)
+{
+    if (*offset >= buffer->size)
+    {
+        return 0;
+    }
+
+    const render_command_header* header = (const render_command_header*)(buffer->data + *offset);
+    *offset += header->size;
+    return header;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "renderer_types.inl"
+
+typedef enum render_command_type
+{
+    RENDER_COMMAND_RESIZE,
+    RENDER_COMMAND_BEGIN_FRAME,
+    RENDER_COMMAND_SET_GLOBALS,
+    RENDER_COMMAND_DRAW_GEOMETRY,
+    RENDER_COMMAND_END_FRAME
+} render_command_type;
+
+// Precedes every command's payload. Size covers header and payload, rounded up to keep the next command aligned.
+typedef struct render_command_header
+{
+    u32 type;
+    u32 size;
+} render_command_header;
+
+typedef struct render_command_resize
+{
+    u16 width;
+    u16 height;
+} render_command_resize;
+
+typedef struct render_command_frame
+{
+    f32 delta_time;
+} render_command_frame;
+
+typedef struct render_command_globals
+{
+    mat4 projection;
+    mat4 view;
+} render_command_globals;
+
+// A frame's backend calls, recorded back to back so another thread can replay them later.
+typedef struct render_command_buffer
+{
+    u8* data;
+    u64 size;
+    u64 capacity;
+} render_command_buffer;
+
+b8 render_command_buffer_create(u64 capacity, render_command_buffer* out_buffer);
+void render_command_buffer_destroy(render_command_buffer* buffer);
+
+// Drops every recorded command, keeping the memory.
+void render_command_buffer_reset(render_command_buffer* buffer);
+
+/**
+ * @brief Appends a command, growing the buffer if needed.
+ *
+ * @return the payload to fill in, size bytes long.
+ */
+void* render_command_buffer_push(render_command_buffer* buffer, render_command_type type, u32 size);
+
+/**
+ * @brief Steps through the recorded commands.
+ *
+ * @param offset 0 for the first command, advanced past the returned one.
+ * @return the next command's header, or 0 at the end. The payload follows the header.
+ */
+const render_command_header* render_command_buffer_next(const render_command_buffer* buffer, u64* offset);
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "renderer_backend.h"
 
 #include "opengl/opengl_backend.h"
+#include "null/null_backend.h"
 
 b8 renderer_backend_create(renderer_backend_type type, renderer_backend* out_renderer_backend)
 {
@@ -17,6 +18,25 @@ b8 renderer_backend_create(renderer_backend_type type, renderer_backend* out_ren
         out_renderer_backend->destroy_texture = opengl_backend_destroy_texture;
         out_renderer_backend->create_geometry = opengl_backend_create_geometry;
         out_renderer_backend->destroy_geometry = opengl_backend_destroy_geometry;
+        out_renderer_backend->bind_thread = opengl_backend_bind_thread;
+
+        return TRUE;
+    }
+
+    if (type == RENDERER_BACKEND_NULL)
+    {
+        out_renderer_backend->initialize = null_backend_initialize;
+        out_renderer_backend->shutdown = null_backend_shutdown;
+        out_renderer_backend->resized = null_backend_on_resized;
+        out_renderer_backend->begin_frame = null_backend_begin_frame;
+        out_renderer_backend->update_global_state = null_backend_update_global_state;
+        out_renderer_backend->end_frame = null_backend_end_frame;
+        out_renderer_backend->draw_geometry = null_backend_draw_geometry;
+        out_renderer_backend->create_texture = null_backend_create_texture;
+        out_renderer_backend->destroy_texture = null_backend_destroy_texture;
+        out_renderer_backend->create_geometry = null_backend_create_geometry;
+        out_renderer_backend->destroy_geometry = null_backend_destroy_geometry;
+        out_renderer_backend->bind_thread = 0;
 
         return TRUE;
     }
@@ -37,4 +57,5 @@ void renderer_backend_destroy(renderer_backend* renderer_backend)
     renderer_backend->destroy_texture = 0;
     renderer_backend->create_geometry = 0;
     renderer_backend->destroy_geometry = 0;
+    renderer_backend->bind_thread = 0;
 }
\ No newline at end of file
@@ -1,11 +1,19 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RENDERER
+
 #include "renderer_frontend.h"
 #include "renderer_backend.h"
+#include "render_commands.h"
 
 #include "memory/hmemory.h"
 
 #include "math/hmath.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
+#include "core/frame_stats.h"
+#include "core/atomic.h"
+
+#include "platform/platform.h"
 
 #include "resources/resource_types.h"
 
@@ -17,6 +25,32 @@
 #include "core/event.h"
 // TODO: End temporary
 
+// Starting size of each command buffer, they grow to fit the largest frame.
+#define RENDER_COMMAND_BUFFER_CAPACITY (64 * 1024)
+
+typedef enum render_call_type
+{
+    RENDER_CALL_NONE,
+    RENDER_CALL_CREATE_TEXTURE,
+    RENDER_CALL_DESTROY_TEXTURE,
+    RENDER_CALL_CREATE_GEOMETRY,
+    RENDER_CALL_DESTROY_GEOMETRY
+} render_call_type;
+
+// A backend call that has to finish before its caller continues, run on the render thread.
+typedef struct render_call
+{
+    render_call_type type;
+    const u8* pixels;
+    texture* texture;
+    geometry* geometry;
+    u32 vertex_count;
+    const vertex_3d* vertices;
+    u32 index_count;
+    const u32* indices;
+    b8 result;
+} render_call;
+
 typedef struct renderer_system_state
 {
     renderer_backend backend;
@@ -24,19 +58,241 @@ typedef struct renderer_system_state
     mat4 view;
     f32 near_clip;
     f32 far_clip;
+
+    b8 threaded;
+    platform_thread thread;
+    volatile u32 running;
+
+    // The main thread records into one buffer while the render thread replays the other.
+    render_command_buffer buffers[2];
+    u32 record_index;
+    render_command_buffer* volatile submitted;
+    // Signalled whenever there is a frame or a call for the render thread.
+    platform_semaphore work;
+    // Signalled once the submitted frame has been replayed, starts signalled.
+    platform_semaphore frame_done;
+    volatile u32 frame_failed;
+
+    platform_mutex call_lock;
+    render_call* volatile call;
+    platform_semaphore call_done;
 } renderer_system_state;
 
 static renderer_system_state* state_ptr;
 
-b8 renderer_initialize(u64* memory_requirement, void* state, const char* application_name)
+static b8 execute_commands(const render_command_buffer* buffer)
+{
+    b8 result = TRUE;
+    b8 frame_begun = FALSE;
+
+    u64 offset = 0;
+    const render_command_header* header;
+    while ((header = render_command_buffer_next(buffer, &offset)))
+    {
+        const void* payload = header + 1;
+        switch (header->type)
+        {
+            case RENDER_COMMAND_RESIZE:
+            {
+                const render_command_resize* resize = payload;
+                state_ptr->backend.resized(&state_ptr->backend, resize->width, resize->height);
+            } break;
+            case RENDER_COMMAND_BEGIN_FRAME:
+            {
+                const render_command_frame* frame = payload;
+                frame_begun = state_ptr->backend.begin_frame(&state_ptr->backend, frame->delta_time);
+            } break;
+            case RENDER_COMMAND_SET_GLOBALS:
+            {
+                const render_command_globals* globals = payload;
+                if (frame_begun)
+                {
+                    state_ptr->backend.update_global_state(globals->projection, globals->view, vec3_zero(), vec4_one(), 0);
+                }
+            } break;
+            case RENDER_COMMAND_DRAW_GEOMETRY:
+            {
+                if (frame_begun)
+                {
+                    state_ptr->backend.draw_geometry(*(const geometry_render_data*)payload);
+                }
+            } break;
+            case RENDER_COMMAND_END_FRAME:
+            {
+                const render_command_frame* frame = payload;
+                if (frame_begun)
+                {
+                    result = state_ptr->backend.end_frame(&state_ptr->backend, frame->delta_time) && result;
+                    state_ptr->backend.frame_number++;
+                }
+                frame_begun = FALSE;
+            } break;
+        }
+    }
+
+    return result;
+}
+
+static void execute_call(render_call* call)
+{
+    switch (call->type)
+    {
+        case RENDER_CALL_CREATE_TEXTURE:
+            state_ptr->backend.create_texture(call->pixels, call->texture);
+            break;
+        case RENDER_CALL_DESTROY_TEXTURE:
+            state_ptr->backend.destroy_texture(call->texture);
+            break;
+        case RENDER_CALL_CREATE_GEOMETRY:
+            call->result = state_ptr->backend.create_geometry(call->geometry, call->vertex_count, call->vertices, call->index_count, call->indices);
+            break;
+        case RENDER_CALL_DESTROY_GEOMETRY:
+            state_ptr->backend.destroy_geometry(call->geometry);
+            break;
+        default:
+            break;
+    }
+}
+
+static u32 render_thread_main(void* params)
+{
+    if (state_ptr->backend.bind_thread)
+    {
+        state_ptr->backend.bind_thread(&state_ptr->backend, TRUE);
+    }
+
+    for (;;)
+    {
+        platform_semaphore_wait(&state_ptr->work);
+
+        // The frame first, a call made after submitting may destroy something it draws.
+        render_command_buffer* frame = atomic_load_ptr((void* volatile*)&state_ptr->submitted);
+        if (frame)
+        {
+            u32 zone = profiler_zone_begin("render_thread_frame");
+            if (!execute_commands(frame))
+            {
+                atomic_store_u32(&state_ptr->frame_failed, TRUE);
+            }
+            profiler_zone_end(zone);
+
+            atomic_store_ptr((void* volatile*)&state_ptr->submitted, 0);
+            platform_semaphore_signal(&state_ptr->frame_done, 1);
+        }
+
+        render_call* call = atomic_load_ptr((void* volatile*)&state_ptr->call);
+        if (call)
+        {
+            execute_call(call);
+            atomic_store_ptr((void* volatile*)&state_ptr->call, 0);
+            platform_semaphore_signal(&state_ptr->call_done, 1);
+        }
+
+        if (!atomic_load_u32(&state_ptr->running))
+        {
+            break;
+        }
+    }
+
+    if (state_ptr->backend.bind_thread)
+    {
+        state_ptr->backend.bind_thread(&state_ptr->backend, FALSE);
+    }
+
+    return 0;
+}
+
+// Runs a call on the render thread and waits for it, or runs it directly without one.
+static void dispatch_call(render_call* call)
+{
+    if (!state_ptr->threaded)
+    {
+        execute_call(call);
+        return;
+    }
+
+    platform_mutex_lock(&state_ptr->call_lock);
+    atomic_store_ptr((void* volatile*)&state_ptr->call, call);
+    platform_semaphore_signal(&state_ptr->work, 1);
+    platform_semaphore_wait(&state_ptr->call_done);
+    platform_mutex_unlock(&state_ptr->call_lock);
+}
+
+static b8 start_render_thread()
+{
+    for (u32 i = 0; i < 2; ++i)
+    {
+        if (!render_command_buffer_create(RENDER_COMMAND_BUFFER_CAPACITY, &state_ptr->buffers[i]))
+        {
+            return FALSE;
+        }
+    }
+
+    if (!platform_semaphore_create(0, &state_ptr->work) ||
+        !platform_semaphore_create(1, &state_ptr->frame_done) ||
+        !platform_semaphore_create(0, &state_ptr->call_done) ||
+        !platform_mutex_create(&state_ptr->call_lock))
+    {
+        return FALSE;
+    }
+
+    // The context can only be current on one thread at a time.
+    if (state_ptr->backend.bind_thread)
+    {
+        state_ptr->backend.bind_thread(&state_ptr->backend, FALSE);
+    }
+
+    state_ptr->running = TRUE;
+    if (!platform_thread_create(render_thread_main, 0, &state_ptr->thread))
+    {
+        if (state_ptr->backend.bind_thread)
+        {
+            state_ptr->backend.bind_thread(&state_ptr->backend, TRUE);
+        }
+        return FALSE;
+    }
+
+    state_ptr->threaded = TRUE;
+    return TRUE;
+}
+
+static void stop_render_thread()
+{
+    // Let the last submitted frame finish before stopping.
+    platform_semaphore_wait(&state_ptr->frame_done);
+
+    atomic_store_u32(&state_ptr->running, FALSE);
+    platform_semaphore_signal(&state_ptr->work, 1);
+    platform_thread_join(&state_ptr->thread);
+    state_ptr->threaded = FALSE;
+
+    if (state_ptr->backend.bind_thread)
+    {
+        state_ptr->backend.bind_thread(&state_ptr->backend, TRUE);
+    }
+
+    platform_mutex_destroy(&state_ptr->call_lock);
+    platform_semaphore_destroy(&state_ptr->call_done);
+    platform_semaphore_destroy(&state_ptr->frame_done);
+    platform_semaphore_destroy(&state_ptr->work);
+    render_command_buffer_destroy(&state_ptr->buffers[0]);
+    render_command_buffer_destroy(&state_ptr->buffers[1]);
+}
+
+b8 renderer_initialize(u64* memory_requirement, void* state, const char* application_name, renderer_backend_type backend_type, b8 render_thread)
 {
     *memory_requirement = sizeof(renderer_system_state);
 
     if (!state) return FALSE;
 
     state_ptr = state;
+    hzero_memory(state_ptr, sizeof(renderer_system_state));
 
-    renderer_backend_create(RENDERER_BACKEND_OPENGL, &state_ptr->backend);
+    if (!renderer_backend_create(backend_type, &state_ptr->backend))
+    {
+        HFATAL("Renderer backend type %d is not supported. Shutting down.", backend_type);
+        return FALSE;
+    }
     state_ptr->backend.frame_number = 0;
 
     if (!state_ptr->backend.initialize(&state_ptr->backend, application_name))
@@ -52,6 +308,16 @@ b8 renderer_initialize(u64* memory_requirement, void* state, const char* applica
     state_ptr->view = mat4_translation((vec3){0, 0, -20.0f});
     state_ptr->view = mat4_inverse(state_ptr->view);
 
+    if (render_thread)
+    {
+        if (!start_render_thread())
+        {
+            HFATAL("Failed to start the render thread. Shutting down.");
+            return FALSE;
+        }
+        HINFO("Rendering on a dedicated thread.");
+    }
+
     return TRUE;
 }
 
@@ -59,6 +325,10 @@ void renderer_shutdown(void* state)
 {
     if (state_ptr)
     {
+        if (state_ptr->threaded)
+        {
+            stop_render_thread();
+        }
         state_ptr->backend.shutdown(&state_ptr->backend);
     }
 
@@ -72,6 +342,14 @@ void renderer_on_resized(u16 width, u16 height)
     if (state_ptr)
     {
         state_ptr->projection = mat4_perspective(deg_to_rad(45.0f), width/(f32)height, state_ptr->near_clip, state_ptr->far_clip);
+        if (state_ptr->threaded)
+        {
+            // Applied ahead of the next frame the render thread replays.
+            render_command_resize* resize = render_command_buffer_push(&state_ptr->buffers[state_ptr->record_index], RENDER_COMMAND_RESIZE, sizeof(render_command_resize));
+            resize->width = width;
+            resize->height = height;
+            return;
+        }
         state_ptr->backend.resized(&state_ptr->backend, width, height);
         return;
     }
@@ -89,8 +367,65 @@ b8 renderer_end_frame(f32 delta_time)
     return result;
 }
 
+// Records the frame and hands it to the render thread, which replays it while the next frame is simulated.
+static b8 submit_frame(render_packet* packet)
+{
+    u64 record_start_ns = platform_get_ticks_ns();
+
+    render_command_buffer* buffer = &state_ptr->buffers[state_ptr->record_index];
+
+    render_command_frame* begin = render_command_buffer_push(buffer, RENDER_COMMAND_BEGIN_FRAME, sizeof(render_command_frame));
+    begin->delta_time = packet->delta_time;
+
+    render_command_globals* globals = render_command_buffer_push(buffer, RENDER_COMMAND_SET_GLOBALS, sizeof(render_command_globals));
+    globals->projection = state_ptr->projection;
+    globals->view = state_ptr->view;
+
+    u32 count = packet->geometry_count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        geometry_render_data* draw = render_command_buffer_push(buffer, RENDER_COMMAND_DRAW_GEOMETRY, sizeof(geometry_render_data));
+        *draw = packet->geometries[i];
+    }
+
+    render_command_frame* end = render_command_buffer_push(buffer, RENDER_COMMAND_END_FRAME, sizeof(render_command_frame));
+    end->delta_time = packet->delta_time;
+
+    // Waiting on the previous frame is where a render thread falling behind, or a vsync wait, shows up.
+    u64 wait_start_ns = platform_get_ticks_ns();
+    frame_stats_add_phase_time(FRAME_PHASE_RENDER, (wait_start_ns - record_start_ns) * 0.000000001);
+
+    platform_semaphore_wait(&state_ptr->frame_done);
+    frame_stats_add_phase_time(FRAME_PHASE_PRESENT, (platform_get_ticks_ns() - wait_start_ns) * 0.000000001);
+
+    // Reported one frame late, the failing frame has already been handed off.
+    if (atomic_load_u32(&state_ptr->frame_failed))
+    {
+        HFATAL("renderer_end_frame failed on the render thread. Shutting down.");
+        platform_semaphore_signal(&state_ptr->frame_done, 1);
+        return FALSE;
+    }
+
+    atomic_store_ptr((void* volatile*)&state_ptr->submitted, buffer);
+    platform_semaphore_signal(&state_ptr->work, 1);
+
+    state_ptr->record_index ^= 1;
+    render_command_buffer_reset(&state_ptr->buffers[state_ptr->record_index]);
+
+    return TRUE;
+}
+
 b8 renderer_draw_frame(render_packet* packet)
 {
+    PROFILE_FUNCTION();
+
+    if (state_ptr->threaded)
+    {
+        return submit_frame(packet);
+    }
+
+    u64 render_start_ns = platform_get_ticks_ns();
+
     if (renderer_begin_frame(packet->delta_time))
     {
         state_ptr->backend.update_global_state(state_ptr->projection, state_ptr->view, vec3_zero(), vec4_one(), 0);
@@ -101,7 +436,14 @@ b8 renderer_draw_frame(render_packet* packet)
             state_ptr->backend.draw_geometry(packet->geometries[i]);
         }
 
-        if (!renderer_end_frame(packet->delta_time))
+        // Ending the frame swaps buffers, which is where a vsync wait shows up.
+        u64 present_start_ns = platform_get_ticks_ns();
+        frame_stats_add_phase_time(FRAME_PHASE_RENDER, (present_start_ns - render_start_ns) * 0.000000001);
+
+        b8 end_result = renderer_end_frame(packet->delta_time);
+        frame_stats_add_phase_time(FRAME_PHASE_PRESENT, (platform_get_ticks_ns() - present_start_ns) * 0.000000001);
+
+        if (!end_result)
         {
             HFATAL("renderer_end_frame failed. Shutting down.");
             return FALSE;
@@ -111,6 +453,15 @@ b8 renderer_draw_frame(render_packet* packet)
     return TRUE;
 }
 
+void renderer_flush()
+{
+    if (state_ptr && state_ptr->threaded)
+    {
+        platform_semaphore_wait(&state_ptr->frame_done);
+        platform_semaphore_signal(&state_ptr->frame_done, 1);
+    }
+}
+
 void renderer_set_view(mat4 view)
 {
     state_ptr->view = view;
@@ -118,20 +469,38 @@ void renderer_set_view(mat4 view)
 
 void renderer_create_texture (const u8* pixels, struct texture* texture)
 {
-    state_ptr->backend.create_texture(pixels, texture);
+    render_call call = {0};
+    call.type = RENDER_CALL_CREATE_TEXTURE;
+    call.pixels = pixels;
+    call.texture = texture;
+    dispatch_call(&call);
 }
 
 void renderer_destroy_texture (struct texture* texture)
 {
-    state_ptr->backend.destroy_texture(texture);
+    render_call call = {0};
+    call.type = RENDER_CALL_DESTROY_TEXTURE;
+    call.texture = texture;
+    dispatch_call(&call);
 }
 
 b8 renderer_create_geometry(geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count, const u32* indices)
 {
-    return state_ptr->backend.create_geometry(geometry, vertex_count, vertices, index_count, indices);
+    render_call call = {0};
+    call.type = RENDER_CALL_CREATE_GEOMETRY;
+    call.geometry = geometry;
+    call.vertex_count = vertex_count;
+    call.vertices = vertices;
+    call.index_count = index_count;
+    call.indices = indices;
+    dispatch_call(&call);
+    return call.result;
 }
 
 void renderer_destroy_geometry(geometry* geometry)
 {
-    state_ptr->backend.destroy_geometry(geometry);
+    render_call call = {0};
+    call.type = RENDER_CALL_DESTROY_GEOMETRY;
+    call.geometry = geometry;
+    dispatch_call(&call);
 }
\ No newline at end of file
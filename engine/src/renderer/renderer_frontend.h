@@ -2,7 +2,11 @@
 
 #include "renderer_types.inl"
 
-b8 renderer_initialize(u64* memory_requirement, void* state, const char* application_name);
+/**
+ * @brief Starts the renderer. With render_thread set, frames are recorded into a command buffer and
+ * replayed by a thread that owns the backend's context, one frame behind the caller.
+ */
+b8 renderer_initialize(u64* memory_requirement, void* state, const char* application_name, renderer_backend_type backend_type, b8 render_thread);
 
 void renderer_shutdown(void* state);
 
@@ -10,9 +14,13 @@ void renderer_on_resized(u16 width, u16 height);
 
 b8 renderer_draw_frame(render_packet* packet);
 
+// Waits until the render thread has replayed every submitted frame. Returns at once without one.
+void renderer_flush();
+
 // HACK: this should not be exposed.
 HAPI void renderer_set_view(mat4 view);
 
+// pixels holds texture->mip_count levels back to back, from the full size image down.
 void renderer_create_texture(const u8* pixels, struct texture* texture);
 
 void renderer_destroy_texture(struct texture* texture);
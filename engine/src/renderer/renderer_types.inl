@@ -7,7 +7,9 @@
 typedef enum renderer_backend_type
 {
     RENDERER_BACKEND_OPENGL,
-    RENDERER_BACKEND_VULKAN
+    RENDERER_BACKEND_VULKAN,
+    // Draws nothing and counts what it is asked to do, for runs without a GPU.
+    RENDERER_BACKEND_NULL
 } renderer_backend_type;
 
 typedef struct global_uniform_object
@@ -55,6 +57,9 @@ typedef struct renderer_backend
 
     b8 (*create_geometry) (geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count, const u32* indices);
     void (*destroy_geometry) (geometry* geometry);
+
+    // Optional. Moves the backend's context between threads: releases it from the calling thread, or binds it there.
+    void (*bind_thread) (struct renderer_backend* backend, b8 bind);
 } renderer_backend;
 
 typedef struct render_packet
@@ -0,0 +1,185 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
+#include "cook_manifest.h"
+
+#include "core/logger.h"
+#include "core/hstring.h"
+#include "memory/hmemory.h"
+#include "resources/hpak.h"
+
+#include <stdlib.h>
+
+b8 cook_manifest_open(const char* path, cook_manifest* out_manifest)
+{
+    hzero_memory(out_manifest, sizeof(cook_manifest));
+
+    if (!filesystem_map(path, &out_manifest->view))
+    {
+        return FALSE;
+    }
+
+    const u8* base = out_manifest->view.data;
+    u64 size = out_manifest->view.size;
+    const cook_manifest_header* header = (const cook_manifest_header*)base;
+    if (size < sizeof(cook_manifest_header) || header->magic != COOK_MANIFEST_MAGIC || header->version != COOK_MANIFEST_VERSION)
+    {
+        HERROR("'%s' is not a version %u cook manifest.", path, COOK_MANIFEST_VERSION);
+        cook_manifest_close(out_manifest);
+        return FALSE;
+    }
+
+    u64 entries_end = sizeof(cook_manifest_header) + (u64)header->entry_count * sizeof(cook_manifest_entry);
+    if (header->strings_offset < entries_end || header->strings_offset > size)
+    {
+        HERROR("Cook manifest '%s' has a damaged table.", path);
+        cook_manifest_close(out_manifest);
+        return FALSE;
+    }
+
+    out_manifest->header = header;
+    out_manifest->entries = (const cook_manifest_entry*)(base + sizeof(cook_manifest_header));
+    out_manifest->strings = (const char*)(base + header->strings_offset);
+
+    // Checked once here so lookups can trust every entry.
+    u64 strings_size = size - header->strings_offset;
+    for (u32 i = 0; i < header->entry_count; ++i)
+    {
+        const cook_manifest_entry* entry = &out_manifest->entries[i];
+        if ((u64)entry->name_offset + entry->name_length >= strings_size || (u64)entry->file_offset + entry->file_length >= strings_size ||
+            out_manifest->strings[entry->file_offset + entry->file_length] != 0 ||
+            (i > 0 && entry->name_hash < out_manifest->entries[i - 1].name_hash))
+        {
+            HERROR("Cook manifest '%s' has a damaged entry %u.", path, i);
+            cook_manifest_close(out_manifest);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void cook_manifest_close(cook_manifest* manifest)
+{
+    filesystem_unmap(&manifest->view);
+    hzero_memory(manifest, sizeof(cook_manifest));
+}
+
+b8 cook_manifest_find(const cook_manifest* manifest, const char* name, const char** out_file)
+{
+    if (!manifest->header) return FALSE;
+
+    u64 hash = hpak_hash(name);
+    u32 low = 0;
+    u32 high = manifest->header->entry_count;
+    while (low < high)
+    {
+        u32 middle = low + (high - low) / 2;
+        if (manifest->entries[middle].name_hash < hash)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    for (; low < manifest->header->entry_count && manifest->entries[low].name_hash == hash; ++low)
+    {
+        const cook_manifest_entry* entry = &manifest->entries[low];
+        if (hpak_names_match(manifest->strings + entry->name_offset, entry->name_length, name))
+        {
+            *out_file = manifest->strings + entry->file_offset;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+typedef struct manifest_item
+{
+    u64 hash;
+    const cook_manifest_source* source;
+} manifest_item;
+
+static i32 compare_items(const void* a, const void* b)
+{
+    const manifest_item* item_a = a;
+    const manifest_item* item_b = b;
+    return hpak_compare_names(item_a->hash, item_a->source->name, item_b->hash, item_b->source->name);
+}
+
+b8 cook_manifest_write(const char* path, u32 source_count, const cook_manifest_source* sources)
+{
+    u64 items_size = sizeof(manifest_item) * (source_count ? source_count : 1);
+    manifest_item* items = hallocate(items_size, MEMORY_TAG_ARRAY);
+
+    u64 strings_size = 0;
+    for (u32 i = 0; i < source_count; ++i)
+    {
+        items[i].hash = hpak_hash(sources[i].name);
+        items[i].source = &sources[i];
+        strings_size += string_length(sources[i].name) + string_length(sources[i].file) + 2;
+    }
+    qsort(items, source_count, sizeof(manifest_item), compare_items);
+
+    for (u32 i = 1; i < source_count; ++i)
+    {
+        if (compare_items(&items[i - 1], &items[i]) == 0)
+        {
+            HERROR("cook_manifest_write - '%s' is in the manifest twice.", items[i].source->name);
+            hfree(items, items_size, MEMORY_TAG_ARRAY);
+            return FALSE;
+        }
+    }
+
+    u64 strings_offset = sizeof(cook_manifest_header) + sizeof(cook_manifest_entry) * source_count;
+    u64 total_size = strings_offset + strings_size;
+    u8* data = hallocate(total_size, MEMORY_TAG_ARRAY);
+
+    cook_manifest_header* header = (cook_manifest_header*)data;
+    header->magic = COOK_MANIFEST_MAGIC;
+    header->version = COOK_MANIFEST_VERSION;
+    header->entry_count = source_count;
+    header->strings_offset = strings_offset;
+
+    cook_manifest_entry* entries = (cook_manifest_entry*)(data + sizeof(cook_manifest_header));
+    char* strings = (char*)(data + strings_offset);
+    u32 string_offset = 0;
+    for (u32 i = 0; i < source_count; ++i)
+    {
+        const cook_manifest_source* source = items[i].source;
+        cook_manifest_entry* entry = &entries[i];
+        entry->name_hash = items[i].hash;
+        entry->key = source->key;
+
+        // Zeroed by hallocate, so every string ends up terminated.
+        entry->name_offset = string_offset;
+        entry->name_length = (u32)string_length(source->name);
+        hcopy_memory(strings + string_offset, source->name, entry->name_length);
+        string_offset += entry->name_length + 1;
+
+        entry->file_offset = string_offset;
+        entry->file_length = (u32)string_length(source->file);
+        hcopy_memory(strings + string_offset, source->file, entry->file_length);
+        string_offset += entry->file_length + 1;
+    }
+
+    file_handle out;
+    b8 result = filesystem_open(path, FILE_MODE_WRITE, TRUE, &out);
+    if (result)
+    {
+        u64 written = 0;
+        result = filesystem_write(&out, total_size, data, &written) && written == total_size;
+        filesystem_close(&out);
+    }
+    if (!result)
+    {
+        HERROR("Failed to write cook manifest '%s'.", path);
+    }
+
+    hfree(data, total_size, MEMORY_TAG_ARRAY);
+    hfree(items, items_size, MEMORY_TAG_ARRAY);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "defines.h"
+
+#include "platform/filesystem.h"
+
+/*
+Index of cooked assets in the cook cache, written by the cook tool and read in place from a mapping.
+
+Layout
+cook_manifest_header
+cook_manifest_entry[entry_count], sorted by hpak_hash of the name
+strings, each NUL terminated
+
+Names are the paths the loaders would otherwise open below the asset base path, such as
+"textures/armor.htex". Each maps to a file in the directory holding the manifest, named after the
+cache key it was cooked under. A key hashes the source bytes, the cooker version and the settings,
+so a cooked file is only ever replaced by cooking something different.
+*/
+
+#define COOK_MANIFEST_MAGIC 0x4D4B4348
+#define COOK_MANIFEST_VERSION 1
+
+typedef struct cook_manifest_header
+{
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 reserved;
+    u64 strings_offset;
+} cook_manifest_header;
+
+typedef struct cook_manifest_entry
+{
+    u64 name_hash;
+    u64 key;
+    u32 name_offset;
+    u32 name_length;
+    u32 file_offset;
+    u32 file_length;
+} cook_manifest_entry;
+
+typedef struct cook_manifest
+{
+    file_view view;
+    const cook_manifest_header* header;
+    const cook_manifest_entry* entries;
+    const char* strings;
+} cook_manifest;
+
+typedef struct cook_manifest_source
+{
+    const char* name;
+    // Relative to the directory holding the manifest.
+    const char* file;
+    u64 key;
+} cook_manifest_source;
+
+// Maps a manifest and validates it.
+HAPI b8 cook_manifest_open(const char* path, cook_manifest* out_manifest);
+
+HAPI void cook_manifest_close(cook_manifest* manifest);
+
+/**
+ * @brief Looks up the cooked file of an asset, matching names like hpak_find does.
+ *
+ * @param out_file receives the file relative to the manifest's directory, valid until the manifest is closed.
+ * @return FALSE if the asset was not cooked.
+ */
+HAPI b8 cook_manifest_find(const cook_manifest* manifest, const char* name, const char** out_file);
+
+// Writes a manifest of the given entries. Fails on duplicate names.
+HAPI b8 cook_manifest_write(const char* path, u32 source_count, const cook_manifest_source* sources);
\ No newline at end of file
@@ -0,0 +1,343 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
+#include "hpak.h"
+
+#include "core/logger.h"
+#include "core/hstring.h"
+#include "memory/hmemory.h"
+
+#include <stdlib.h>
+
+typedef struct pack_item
+{
+    u64 hash;
+    u64 size;
+    u64 offset;
+    const hpak_source* source;
+    u32 name_length;
+} pack_item;
+
+HINLINE char normalize_char(char c)
+{
+    if (c == '\\') return '/';
+    if (c >= 'A' && c <= 'Z') return c + ('a' - 'A');
+    return c;
+}
+
+HINLINE u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+u64 hpak_hash_bytes(u64 hash, const void* data, u64 size)
+{
+    const u8* bytes = data;
+    for (u64 i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+u64 hpak_hash(const char* name)
+{
+    u64 hash = HPAK_HASH_SEED;
+    for (const char* c = name; *c; ++c)
+    {
+        u8 folded = (u8)normalize_char(*c);
+        hash = hpak_hash_bytes(hash, &folded, 1);
+    }
+    return hash;
+}
+
+b8 hpak_names_match(const char* stored, u32 stored_length, const char* name)
+{
+    for (u32 i = 0; i < stored_length; ++i)
+    {
+        if (!name[i] || normalize_char(stored[i]) != normalize_char(name[i])) return FALSE;
+    }
+    return name[stored_length] == 0;
+}
+
+i32 hpak_compare_names(u64 hash_a, const char* name_a, u64 hash_b, const char* name_b)
+{
+    if (hash_a != hash_b)
+    {
+        return hash_a < hash_b ? -1 : 1;
+    }
+
+    // Colliding hashes keep a stable order so archives build reproducibly.
+    for (; *name_a && normalize_char(*name_a) == normalize_char(*name_b); ++name_a, ++name_b);
+    return (i32)(u8)normalize_char(*name_a) - (i32)(u8)normalize_char(*name_b);
+}
+
+// Lookups read entries fanout[bucket - 1] up to fanout[bucket], so every range has to lie within the table.
+static b8 fanout_is_valid(const hpak_header* header)
+{
+    u32 previous = 0;
+    for (u32 bucket = 0; bucket < 256; ++bucket)
+    {
+        if (header->fanout[bucket] < previous || header->fanout[bucket] > header->entry_count)
+        {
+            return FALSE;
+        }
+        previous = header->fanout[bucket];
+    }
+    return previous == header->entry_count;
+}
+
+b8 hpak_open(const char* path, hpak* out_pak)
+{
+    hzero_memory(out_pak, sizeof(hpak));
+
+    if (!filesystem_map(path, &out_pak->view))
+    {
+        return FALSE;
+    }
+
+    const u8* base = out_pak->view.data;
+    u64 size = out_pak->view.size;
+    const hpak_header* header = (const hpak_header*)base;
+    if (size < sizeof(hpak_header) || header->magic != HPAK_MAGIC || header->version != HPAK_VERSION)
+    {
+        HERROR("'%s' is not a version %u archive.", path, HPAK_VERSION);
+        hpak_close(out_pak);
+        return FALSE;
+    }
+
+    u64 toc_end = header->toc_offset + (u64)header->entry_count * sizeof(hpak_entry);
+    if ((header->toc_offset & 7) || toc_end > size || header->names_offset < toc_end || header->names_offset > size ||
+        !fanout_is_valid(header))
+    {
+        HERROR("Archive '%s' has a damaged table of contents.", path);
+        hpak_close(out_pak);
+        return FALSE;
+    }
+
+    // Lookups jump around the archive, only the table is worth reading ahead.
+    filesystem_advise(&out_pak->view, 0, size, FILE_ACCESS_RANDOM);
+    filesystem_advise(&out_pak->view, 0, toc_end, FILE_ACCESS_WILL_NEED);
+
+    out_pak->header = header;
+    out_pak->entries = (const hpak_entry*)(base + header->toc_offset);
+    out_pak->names = (const char*)(base + header->names_offset);
+
+    // Checked once here so lookups can trust every entry.
+    u64 names_size = size - header->names_offset;
+    for (u32 i = 0; i < header->entry_count; ++i)
+    {
+        const hpak_entry* entry = &out_pak->entries[i];
+        u32 bucket = (u32)(entry->hash >> 56);
+        u32 bucket_start = bucket ? header->fanout[bucket - 1] : 0;
+        if (entry->offset > size || entry->size > size - entry->offset || (u64)entry->name_offset + entry->name_length >= names_size ||
+            (i > 0 && entry->hash < out_pak->entries[i - 1].hash) || i < bucket_start || i >= header->fanout[bucket])
+        {
+            HERROR("Archive '%s' has a damaged entry %u.", path, i);
+            hpak_close(out_pak);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void hpak_close(hpak* pak)
+{
+    filesystem_unmap(&pak->view);
+    hzero_memory(pak, sizeof(hpak));
+}
+
+b8 hpak_find(const hpak* pak, const char* name, const void** out_data, u64* out_size)
+{
+    if (!pak->header) return FALSE;
+
+    u64 hash = hpak_hash(name);
+    u32 bucket = (u32)(hash >> 56);
+    u32 low = bucket ? pak->header->fanout[bucket - 1] : 0;
+    u32 end = pak->header->fanout[bucket];
+
+    // First entry of the bucket with a hash not below the one searched for.
+    u32 high = end;
+    while (low < high)
+    {
+        u32 middle = low + (high - low) / 2;
+        if (pak->entries[middle].hash < hash)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    for (; low < end && pak->entries[low].hash == hash; ++low)
+    {
+        const hpak_entry* entry = &pak->entries[low];
+        if (hpak_names_match(pak->names + entry->name_offset, entry->name_length, name))
+        {
+            *out_data = (const u8*)pak->view.data + entry->offset;
+            *out_size = entry->size;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static i32 compare_items(const void* a, const void* b)
+{
+    const pack_item* item_a = a;
+    const pack_item* item_b = b;
+    return hpak_compare_names(item_a->hash, item_a->source->name, item_b->hash, item_b->source->name);
+}
+
+static b8 write_padding(file_handle* file, u64 count)
+{
+    static const u8 zeros[HPAK_ALIGNMENT] = {0};
+    u64 written = 0;
+    return count == 0 || filesystem_write(file, count, zeros, &written);
+}
+
+// Hashes, sizes and sorts the sources, rejecting duplicates.
+static b8 gather_items(u32 source_count, const hpak_source* sources, pack_item* items, u64* out_names_size)
+{
+    *out_names_size = 0;
+    for (u32 i = 0; i < source_count; ++i)
+    {
+        pack_item* item = &items[i];
+        item->source = &sources[i];
+        item->hash = hpak_hash(sources[i].name);
+        item->name_length = (u32)string_length(sources[i].name);
+        *out_names_size += item->name_length + 1;
+
+        file_handle f;
+        if (!filesystem_open(sources[i].path, FILE_MODE_READ, TRUE, &f))
+        {
+            return FALSE;
+        }
+        b8 sized = filesystem_size(&f, &item->size);
+        filesystem_close(&f);
+        if (!sized)
+        {
+            HERROR("Unable to read the size of '%s'.", sources[i].path);
+            return FALSE;
+        }
+    }
+
+    qsort(items, source_count, sizeof(pack_item), compare_items);
+
+    for (u32 i = 1; i < source_count; ++i)
+    {
+        if (compare_items(&items[i - 1], &items[i]) == 0)
+        {
+            HERROR("hpak_write - '%s' is in the archive twice.", items[i].source->name);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Fills in the header, entries and names, and assigns each item its data offset.
+static void build_table(u32 count, pack_item* items, u8* table, u64 names_offset, u64 table_size)
+{
+    hpak_header* header = (hpak_header*)table;
+    header->magic = HPAK_MAGIC;
+    header->version = HPAK_VERSION;
+    header->entry_count = count;
+    header->alignment = HPAK_ALIGNMENT;
+    header->toc_offset = sizeof(hpak_header);
+    header->names_offset = names_offset;
+
+    hpak_entry* entries = (hpak_entry*)(table + header->toc_offset);
+    char* names = (char*)(table + names_offset);
+    u64 data_offset = align_up(table_size, HPAK_ALIGNMENT);
+    u32 name_offset = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        pack_item* item = &items[i];
+        item->offset = data_offset;
+        data_offset = align_up(data_offset + item->size, HPAK_ALIGNMENT);
+
+        entries[i].hash = item->hash;
+        entries[i].offset = item->offset;
+        entries[i].size = item->size;
+        entries[i].name_offset = name_offset;
+        entries[i].name_length = item->name_length;
+
+        for (u32 c = 0; c < item->name_length; ++c)
+        {
+            names[name_offset + c] = item->source->name[c] == '\\' ? '/' : item->source->name[c];
+        }
+        name_offset += item->name_length + 1;
+
+        header->fanout[item->hash >> 56]++;
+    }
+    for (u32 i = 1; i < 256; ++i)
+    {
+        header->fanout[i] += header->fanout[i - 1];
+    }
+}
+
+static b8 write_archive(const char* path, u32 count, const pack_item* items, const u8* table, u64 table_size)
+{
+    file_handle out;
+    if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &out))
+    {
+        return FALSE;
+    }
+
+    u64 written = 0;
+    u64 position = table_size;
+    b8 ok = filesystem_write(&out, table_size, table, &written);
+    for (u32 i = 0; ok && i < count; ++i)
+    {
+        const pack_item* item = &items[i];
+        ok = write_padding(&out, item->offset - position);
+        position = item->offset + item->size;
+        if (!ok || item->size == 0) continue;
+
+        // Straight from the mapping, the file is never copied into a buffer of our own.
+        file_view view;
+        ok = filesystem_map(item->source->path, &view);
+        if (ok && view.size != item->size)
+        {
+            HERROR("'%s' changed while it was being packed.", item->source->path);
+            ok = FALSE;
+        }
+        ok = ok && filesystem_write(&out, item->size, view.data, &written);
+        filesystem_unmap(&view);
+    }
+    filesystem_close(&out);
+
+    if (!ok)
+    {
+        HERROR("Failed to write archive '%s'.", path);
+    }
+    return ok;
+}
+
+b8 hpak_write(const char* path, u32 source_count, const hpak_source* sources)
+{
+    u64 items_size = sizeof(pack_item) * (source_count ? source_count : 1);
+    pack_item* items = hallocate(items_size, MEMORY_TAG_ARRAY);
+
+    u64 names_size = 0;
+    b8 result = gather_items(source_count, sources, items, &names_size);
+    if (result)
+    {
+        u64 names_offset = sizeof(hpak_header) + sizeof(hpak_entry) * source_count;
+        u64 table_size = names_offset + names_size;
+        u8* table = hallocate(table_size, MEMORY_TAG_ARRAY);
+
+        build_table(source_count, items, table, names_offset, table_size);
+        result = write_archive(path, source_count, items, table, table_size);
+
+        hfree(table, table_size, MEMORY_TAG_ARRAY);
+    }
+
+    hfree(items, items_size, MEMORY_TAG_ARRAY);
+    return result;
+}
\ No newline at end of file
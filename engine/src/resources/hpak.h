@@ -0,0 +1,91 @@
+#pragma once
+
+#include "defines.h"
+
+#include "platform/filesystem.h"
+
+/*
+Packed asset archive, read in place from a mapping of the whole file.
+
+Layout
+hpak_header
+hpak_entry[entry_count], sorted by hash
+names, each NUL terminated, referenced by hpak_entry.name_offset
+file data, each file starting on an HPAK_ALIGNMENT boundary
+
+Names are paths below the asset base path, such as "textures/cobblestone.png". They are hashed
+case-insensitively with '\' treated as '/', matching how names are compared. The fanout table
+narrows a lookup to the entries sharing the top byte of the hash before a binary search.
+*/
+
+#define HPAK_MAGIC 0x4B415048
+#define HPAK_VERSION 1
+#define HPAK_ALIGNMENT 64
+
+typedef struct hpak_header
+{
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 alignment;
+    u64 toc_offset;
+    u64 names_offset;
+    // Entries whose hash has a top byte less than or equal to the index.
+    u32 fanout[256];
+} hpak_header;
+
+typedef struct hpak_entry
+{
+    u64 hash;
+    u64 offset;
+    u64 size;
+    u32 name_offset;
+    u32 name_length;
+} hpak_entry;
+
+typedef struct hpak
+{
+    file_view view;
+    const hpak_header* header;
+    const hpak_entry* entries;
+    const char* names;
+} hpak;
+
+typedef struct hpak_source
+{
+    // Stored name, looked up by hpak_find.
+    const char* name;
+    // File read into the archive.
+    const char* path;
+} hpak_source;
+
+#define HPAK_HASH_SEED 0xcbf29ce484222325ull
+
+// FNV-1a over raw bytes, continuing from hash. Start from HPAK_HASH_SEED.
+HAPI u64 hpak_hash_bytes(u64 hash, const void* data, u64 size);
+
+// Hash of a name, folded the same way hpak_names_match compares it.
+HAPI u64 hpak_hash(const char* name);
+
+// Compares a stored name of known length with a NUL terminated one.
+HAPI b8 hpak_names_match(const char* stored, u32 stored_length, const char* name);
+
+// Orders names by hash, then by folded name, as archives and cook manifests are sorted. Zero means the same name.
+HAPI i32 hpak_compare_names(u64 hash_a, const char* name_a, u64 hash_b, const char* name_b);
+
+// Maps an archive and validates its table of contents.
+HAPI b8 hpak_open(const char* path, hpak* out_pak);
+
+HAPI void hpak_close(hpak* pak);
+
+/**
+ * @brief Looks a file up by name.
+ *
+ * @param out_data receives a pointer into the mapping, valid until the archive is closed.
+ * @param out_size receives the size of the file in bytes.
+ * @return FALSE if the archive has no file of that name.
+ */
+HAPI b8 hpak_find(const hpak* pak, const char* name, const void** out_data, u64* out_size);
+
+// Writes an archive holding the given files. Fails on duplicate names.
+HAPI b8 hpak_write(const char* path, u32 source_count, const hpak_source* sources);
\ No newline at end of file
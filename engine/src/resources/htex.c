@@ -0,0 +1,155 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
+#include "htex.h"
+
+#include "core/logger.h"
+#include "memory/hmemory.h"
+#include "platform/filesystem.h"
+
+// The implementation is compiled into the image loader.
+#include "stb_image.h"
+
+#define HTEX_CHANNELS 4
+
+static u32 mip_dimension(u32 dimension, u32 level)
+{
+    u32 value = dimension >> level;
+    return value ? value : 1;
+}
+
+static u32 full_mip_count(u32 width, u32 height)
+{
+    u32 largest = width > height ? width : height;
+    u32 count = 1;
+    while ((largest >>= 1) && count < HTEX_MAX_MIPS)
+    {
+        count++;
+    }
+    return count;
+}
+
+u64 htex_mip_size(const htex_header* header, u32 level)
+{
+    return (u64)mip_dimension(header->width, level) * mip_dimension(header->height, level) * HTEX_CHANNELS;
+}
+
+b8 htex_parse(const void* data, u64 size, const htex_header** out_header)
+{
+    const htex_header* header = data;
+    if (!data || size < sizeof(htex_header) || header->magic != HTEX_MAGIC || header->version != HTEX_VERSION)
+    {
+        return FALSE;
+    }
+
+    if (header->format != HTEX_FORMAT_RGBA8 || header->width == 0 || header->height == 0 ||
+        header->mip_count == 0 || header->mip_count > full_mip_count(header->width, header->height))
+    {
+        return FALSE;
+    }
+
+    // Levels are uploaded as one run starting at the first, they have to follow each other.
+    u64 offset = sizeof(htex_header);
+    for (u32 i = 0; i < header->mip_count; ++i)
+    {
+        u64 level_size = htex_mip_size(header, i);
+        if (header->mip_offsets[i] != offset || level_size > size - offset)
+        {
+            return FALSE;
+        }
+        offset += level_size;
+    }
+
+    *out_header = header;
+    return TRUE;
+}
+
+// Averages each 2 x 2 block of the level above, repeating the last row or column of odd sizes.
+static void downsample(const u8* source, u32 source_width, u32 source_height, u8* destination, u32 width, u32 height)
+{
+    for (u32 y = 0; y < height; ++y)
+    {
+        u32 y0 = y * 2;
+        u32 y1 = y0 + 1 < source_height ? y0 + 1 : y0;
+        for (u32 x = 0; x < width; ++x)
+        {
+            u32 x0 = x * 2;
+            u32 x1 = x0 + 1 < source_width ? x0 + 1 : x0;
+            const u8* a = source + ((u64)y0 * source_width + x0) * HTEX_CHANNELS;
+            const u8* b = source + ((u64)y0 * source_width + x1) * HTEX_CHANNELS;
+            const u8* c = source + ((u64)y1 * source_width + x0) * HTEX_CHANNELS;
+            const u8* d = source + ((u64)y1 * source_width + x1) * HTEX_CHANNELS;
+            u8* out = destination + ((u64)y * width + x) * HTEX_CHANNELS;
+            for (u32 channel = 0; channel < HTEX_CHANNELS; ++channel)
+            {
+                out[channel] = (u8)((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+            }
+        }
+    }
+}
+
+b8 htex_cook(const char* name, const void* encoded, u64 encoded_size, htex_cook_settings settings, const char* output_path)
+{
+    i32 width;
+    i32 height;
+    i32 channel_count;
+    stbi_set_flip_vertically_on_load_thread(TRUE);
+    u8* pixels = stbi_load_from_memory(encoded, (i32)encoded_size, &width, &height, &channel_count, HTEX_CHANNELS);
+    if (!pixels)
+    {
+        HERROR("htex_cook - Failed to decode '%s': %s", name, stbi_failure_reason());
+        return FALSE;
+    }
+
+    htex_header header = {0};
+    header.magic = HTEX_MAGIC;
+    header.version = HTEX_VERSION;
+    header.format = HTEX_FORMAT_RGBA8;
+    header.width = (u32)width;
+    header.height = (u32)height;
+    header.mip_count = settings.generate_mips ? full_mip_count(header.width, header.height) : 1;
+
+    u64 total_size = sizeof(htex_header);
+    for (u32 i = 0; i < header.mip_count; ++i)
+    {
+        header.mip_offsets[i] = total_size;
+        total_size += htex_mip_size(&header, i);
+    }
+
+    u64 base_size = htex_mip_size(&header, 0);
+    for (u64 i = 3; i < base_size; i += HTEX_CHANNELS)
+    {
+        if (pixels[i] < 255)
+        {
+            header.flags |= HTEX_FLAG_TRANSPARENT;
+            break;
+        }
+    }
+
+    // Built whole in memory so the file is written in one go.
+    u8* file_data = hallocate(total_size, MEMORY_TAG_ARRAY);
+    hcopy_memory(file_data, &header, sizeof(htex_header));
+    hcopy_memory(file_data + header.mip_offsets[0], pixels, base_size);
+    stbi_image_free(pixels);
+
+    for (u32 i = 1; i < header.mip_count; ++i)
+    {
+        downsample(file_data + header.mip_offsets[i - 1], mip_dimension(header.width, i - 1), mip_dimension(header.height, i - 1),
+                   file_data + header.mip_offsets[i], mip_dimension(header.width, i), mip_dimension(header.height, i));
+    }
+
+    file_handle out;
+    b8 result = filesystem_open(output_path, FILE_MODE_WRITE, TRUE, &out);
+    if (result)
+    {
+        u64 written = 0;
+        result = filesystem_write(&out, total_size, file_data, &written) && written == total_size;
+        filesystem_close(&out);
+    }
+    if (!result)
+    {
+        HERROR("htex_cook - Failed to write '%s'.", output_path);
+    }
+
+    hfree(file_data, total_size, MEMORY_TAG_ARRAY);
+    return result;
+}
\ No newline at end of file
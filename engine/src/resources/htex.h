@@ -0,0 +1,70 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Cooked texture, uploaded straight from a mapping of the file with no decoding.
+
+Layout
+htex_header
+levels of the mip chain, back to back from the full size image down, each tightly packed
+
+Rows are stored bottom up, the order GL expects, so nothing is flipped at load time either.
+Each level is half the size of the one before it, rounded down but at least 1.
+*/
+
+#define HTEX_MAGIC 0x58455448
+#define HTEX_VERSION 1
+// Bumped whenever htex_cook produces different output for the same input, invalidating cooked files in caches.
+#define HTEX_COOKER_VERSION 1
+// Enough levels for a 32768 x 32768 texture.
+#define HTEX_MAX_MIPS 16
+
+typedef enum htex_format
+{
+    HTEX_FORMAT_RGBA8 = 1
+} htex_format;
+
+typedef enum htex_flags
+{
+    // Some pixel has an alpha below 255.
+    HTEX_FLAG_TRANSPARENT = 0x1
+} htex_flags;
+
+typedef struct htex_header
+{
+    u32 magic;
+    u32 version;
+    u32 format;
+    u32 flags;
+    u32 width;
+    u32 height;
+    u32 mip_count;
+    u32 reserved;
+    // From the start of the file.
+    u64 mip_offsets[HTEX_MAX_MIPS];
+} htex_header;
+
+typedef struct htex_cook_settings
+{
+    // Stores the whole mip chain down to 1 x 1, otherwise only the full size image.
+    b8 generate_mips;
+} htex_cook_settings;
+
+// Bytes of a level of the mip chain.
+HAPI u64 htex_mip_size(const htex_header* header, u32 level);
+
+/**
+ * @brief Checks that data holds a complete cooked texture.
+ *
+ * @param out_header receives the header at the start of data.
+ * @return FALSE if the data is not a version HTEX_VERSION texture or is cut short.
+ */
+HAPI b8 htex_parse(const void* data, u64 size, const htex_header** out_header);
+
+/**
+ * @brief Decodes an encoded image such as a PNG and writes it out cooked.
+ *
+ * @param name used in error messages.
+ */
+HAPI b8 htex_cook(const char* name, const void* encoded, u64 encoded_size, htex_cook_settings settings, const char* output_path);
\ No newline at end of file
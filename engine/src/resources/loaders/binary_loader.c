@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "binary_loader.h"
 
 #include "core/logger.h"
@@ -20,38 +22,32 @@ b8 binary_loader_load(struct resource_loader* self, const char* name, resource*
 
     char* format_str = "%s/%s/%s%s";
     char full_file_path[512];
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, "");
+    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, self->extension);
 
     out_resource->full_path = string_duplicate(full_file_path);
+    out_resource->view.data = 0;
+    out_resource->view.size = 0;
 
-    file_handle f;
-    if (!filesystem_open(full_file_path, FILE_MODE_READ, TRUE, &f))
+    const void* packed_data;
+    u64 packed_size;
+    if (resource_system_find_packed(self, name, &packed_data, &packed_size))
     {
-        HERROR("binary_loader_load - unable to open file for binary reading: '%s'.", full_file_path);
-        return FALSE;
+        // Points into the archive mapping, which outlives the resource.
+        out_resource->data = (void*)packed_data;
+        out_resource->data_size = packed_size;
+        out_resource->name = name;
+        return TRUE;
     }
 
-    u64 file_size = 0;
-    if (!filesystem_size(&f, &file_size))
+    // Handed out as mapped, read only and without a copy on the heap.
+    if (!filesystem_map(full_file_path, &out_resource->view))
     {
-        HERROR("Unable to binary read file: '%s'.", full_file_path);
-        filesystem_close(&f);
+        HERROR("binary_loader_load - unable to map file: '%s'.", full_file_path);
         return FALSE;
     }
 
-    u8* resource_data = hallocate(sizeof(u8) * file_size, MEMORY_TAG_ARRAY);
-    u64 read_size = 0;
-    if (!filesystem_read_all_bytes(&f, resource_data, &read_size))
-    {
-        HERROR("Unabel to binary read file: '%s'.", full_file_path);
-        filesystem_close(&f);
-        return FALSE;
-    }
-
-    filesystem_close(&f);
-
-    out_resource->data = resource_data;
-    out_resource->data_size = read_size;
+    out_resource->data = (void*)out_resource->view.data;
+    out_resource->data_size = out_resource->view.size;
     out_resource->name = name;
 
     return TRUE;
@@ -73,7 +69,8 @@ void binary_loader_unload(struct resource_loader* self, resource* resource)
 
     if (resource->data)
     {
-        hfree(resource->data, resource->data_size, MEMORY_TAG_ARRAY);
+        // Nothing to release for data inside an archive, its view is empty.
+        filesystem_unmap(&resource->view);
         resource->data = 0;
         resource->data_size = 0;
         resource->loader_id = INVALID_ID;
@@ -87,7 +84,10 @@ resource_loader binary_resource_loader_create()
     loader.custom_type = 0;
     loader.load = binary_loader_load;
     loader.unload = binary_loader_unload;
+    // Loaded as mapped, reading them into memory up front would only add a copy.
+    loader.load_from_memory = 0;
     loader.type_path = "";
+    loader.extension = "";
 
     return loader;
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
+#include "cooked_image_loader.h"
+
+#include "core/logger.h"
+#include "core/hstring.h"
+
+#include "memory/hmemory.h"
+
+#include "resources/resource_types.h"
+#include "resources/htex.h"
+
+#include "systems/resource_system.h"
+
+#include "platform/filesystem.h"
+
+b8 cooked_image_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return FALSE;
+    }
+
+    // Cached by the cook tool, or else lying next to the source image.
+    char full_file_path[512];
+    if (!resource_system_find_cooked(self, name, full_file_path))
+    {
+        string_format(full_file_path, "%s/%s/%s%s", resource_system_base_path(), self->type_path, name, self->extension);
+    }
+
+    out_resource->view.data = 0;
+    out_resource->view.size = 0;
+
+    // Either stays mapped until unload, the pixels are uploaded from where they lie.
+    const void* data;
+    u64 size;
+    if (!resource_system_find_packed(self, name, &data, &size))
+    {
+        if (!filesystem_map(full_file_path, &out_resource->view))
+        {
+            HERROR("Cooked image loader failed to open file '%s'.", full_file_path);
+            return FALSE;
+        }
+        data = out_resource->view.data;
+        size = out_resource->view.size;
+    }
+
+    const htex_header* header;
+    if (!htex_parse(data, size, &header))
+    {
+        HERROR("Cooked image loader - '%s' is not a version %u cooked texture. Cook it again.", full_file_path, HTEX_VERSION);
+        filesystem_unmap(&out_resource->view);
+        return FALSE;
+    }
+
+    image_resource_data* resource_data = hallocate(sizeof(image_resource_data), MEMORY_TAG_TEXTURE);
+    resource_data->pixels = (u8*)data + header->mip_offsets[0];
+    resource_data->width = header->width;
+    resource_data->height = header->height;
+    resource_data->channel_count = 4;
+    resource_data->mip_count = header->mip_count;
+    resource_data->has_transparency = (header->flags & HTEX_FLAG_TRANSPARENT) != 0;
+
+    out_resource->full_path = string_duplicate(full_file_path);
+    out_resource->data = resource_data;
+    out_resource->data_size = sizeof(image_resource_data);
+    out_resource->name = name;
+
+    return TRUE;
+}
+
+void cooked_image_loader_unload(struct resource_loader* self, resource* resource)
+{
+    if (!self || !resource)
+    {
+        HWARN("cooked_image_loader_unload called with nullptr for self or resource.");
+        return;
+    }
+
+    u32 path_length = string_length(resource->full_path);
+    if (path_length)
+    {
+        hfree(resource->full_path, sizeof(char) * path_length + 1, MEMORY_TAG_STRING);
+    }
+
+    if (resource->data)
+    {
+        hfree(resource->data, resource->data_size, MEMORY_TAG_TEXTURE);
+        filesystem_unmap(&resource->view);
+        resource->data = 0;
+        resource->data_size = 0;
+        resource->loader_id = INVALID_ID;
+    }
+}
+
+resource_loader cooked_image_resource_loader_create()
+{
+    resource_loader loader;
+    loader.type = RESOURCE_TYPE_COOKED_IMAGE;
+    loader.custom_type = 0;
+    loader.load = cooked_image_loader_load;
+    loader.unload = cooked_image_loader_unload;
+    // Nothing to decode, mapping the file beats reading it into a buffer.
+    loader.load_from_memory = 0;
+    loader.type_path = "textures";
+    loader.extension = ".htex";
+
+    return loader;
+}
\ No newline at end of file
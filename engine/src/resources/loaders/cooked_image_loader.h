@@ -0,0 +1,6 @@
+#pragma once
+
+#include "systems/resource_system.h"
+
+// Loads textures cooked to .htex, handing out their pixels in place in the mapped file.
+resource_loader cooked_image_resource_loader_create();
\ No newline at end of file
@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "image_loader.h"
 
 #include "core/logger.h"
@@ -9,28 +11,31 @@
 
 #include "systems/resource_system.h"
 
+#include "platform/filesystem.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-b8 image_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+b8 image_loader_load_from_memory(struct resource_loader* self, const char* name, const void* encoded, u64 encoded_size, resource* out_resource)
 {
-    if (!self || !name || !out_resource)
+    if (!self || !name || !encoded || !out_resource)
     {
         return FALSE;
     }
 
     char* format_str = "%s/%s/%s%s";
     const i32 required_channel_count = 4;
-    stbi_set_flip_vertically_on_load(TRUE);
+    // Per thread, images are decoded on job workers.
+    stbi_set_flip_vertically_on_load_thread(TRUE);
     char full_file_path[512];
 
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, ".png");
+    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, self->extension);
 
     i32 width;
     i32 height;
     i32 channel_count;
 
-    u8* data= stbi_load(full_file_path, &width, &height, &channel_count, required_channel_count);
+    u8* data = stbi_load_from_memory(encoded, (i32)encoded_size, &width, &height, &channel_count, required_channel_count);
 
     const char* fail_reason = stbi_failure_reason();
     if (fail_reason)
@@ -54,12 +59,25 @@ b8 image_loader_load(struct resource_loader* self, const char* name, resource* o
 
     out_resource->full_path = string_duplicate(full_file_path);
 
+    // Scanned here on the worker rather than when the texture is created on the main thread.
+    b8 has_transparency = FALSE;
+    u64 total_size = (u64)width * height * required_channel_count;
+    for (u64 i = 3; i < total_size; i += required_channel_count)
+    {
+        if (data[i] < 255)
+        {
+            has_transparency = TRUE;
+            break;
+        }
+    }
+
     image_resource_data* resource_data = hallocate(sizeof(image_resource_data), MEMORY_TAG_TEXTURE);
     resource_data->pixels = data;
     resource_data->width = width;
     resource_data->height = height;
     resource_data->channel_count = required_channel_count;
-
+    resource_data->mip_count = 1;
+    resource_data->has_transparency = has_transparency;
 
     out_resource->data = resource_data;
     out_resource->data_size = sizeof(image_resource_data);
@@ -68,6 +86,35 @@ b8 image_loader_load(struct resource_loader* self, const char* name, resource* o
     return TRUE;
 }
 
+b8 image_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return FALSE;
+    }
+
+    // Decoded straight out of the archive or the mapped file, the encoded image is never copied.
+    const void* encoded;
+    u64 encoded_size;
+    file_view view = {0};
+    if (!resource_system_find_packed(self, name, &encoded, &encoded_size))
+    {
+        char full_file_path[512];
+        string_format(full_file_path, "%s/%s/%s%s", resource_system_base_path(), self->type_path, name, self->extension);
+        if (!filesystem_map(full_file_path, &view))
+        {
+            HERROR("Image resource loader failed to open file '%s'.", full_file_path);
+            return FALSE;
+        }
+        encoded = view.data;
+        encoded_size = view.size;
+    }
+
+    b8 result = image_loader_load_from_memory(self, name, encoded, encoded_size, out_resource);
+    filesystem_unmap(&view);
+    return result;
+}
+
 void image_loader_unload(struct resource_loader* self, resource* resource)
 {
     if (!self || !resource)
@@ -98,7 +145,9 @@ resource_loader image_resource_loader_create()
     loader.custom_type = 0;
     loader.load = image_loader_load;
     loader.unload = image_loader_unload;
+    loader.load_from_memory = image_loader_load_from_memory;
     loader.type_path = "textures";
+    loader.extension = ".png";
 
     return loader;
 }
\ No newline at end of file
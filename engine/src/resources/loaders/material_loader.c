@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "material_loader.h"
 
 #include "core/logger.h"
@@ -13,92 +15,227 @@
 
 #include "platform/filesystem.h"
 
-b8 material_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+#include <string.h>
+
+typedef enum hmt_key
 {
-    if (!self || !name || !out_resource)
-    {
-        return FALSE;
-    }
+    HMT_KEY_UNKNOWN,
+    HMT_KEY_VERSION,
+    HMT_KEY_NAME,
+    HMT_KEY_DIFFUSE_NAME,
+    HMT_KEY_DIFFUSE_COLOR
+} hmt_key;
 
-    char* format_str = "%s/%s/%s%s";
-    char full_file_path[512];
+HINLINE b8 is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, ".hmt");
+static const char* skip_spaces(const char* c, const char* end)
+{
+    while (c < end && is_space(*c)) c++;
+    return c;
+}
 
-    out_resource->full_path = string_duplicate(full_file_path);
+// End of [start, end) without its trailing spaces.
+static const char* trim_end(const char* start, const char* end)
+{
+    while (end > start && is_space(end[-1])) end--;
+    return end;
+}
 
-    file_handle f;
-    if (!filesystem_open(full_file_path, FILE_MODE_READ, FALSE, &f))
+// Compares against a lowercase candidate of the same length, ignoring case.
+static b8 key_equals(const char* key, u32 length, const char* candidate)
+{
+    for (u32 i = 0; i < length; ++i)
     {
-        HERROR("material_loader_load - unable to open material file for reading: '%s'.", full_file_path);
-        return FALSE;
+        char c = key[i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        if (c != candidate[i]) return FALSE;
     }
+    return TRUE;
+}
 
-    material_resource_data* resource_data = hallocate(sizeof(material_resource_data), MEMORY_TAG_MATERIAL);
-    resource_data->auto_release = TRUE;
-    resource_data->diffuse_color = vec4_one();
-    resource_data->diffuse_name[0] = 0;
-    string_ncopy(resource_data->name, name, MATERIAL_NAME_MAX_LENGTH);
-
-    char line_buf[512] = "";
-    char* p = &line_buf[0];
-    u64 line_length = 0;
-    u32 line_number = 1;
-    while (filesystem_read_line(&f, 511, &p, &line_length))
+// The length and first letter leave a single candidate, one comparison confirms it.
+static hmt_key find_key(const char* key, u32 length)
+{
+    const char* candidate;
+    hmt_key result;
+    switch (length)
     {
-        char* trimmed = string_trim(line_buf);
+        case 4: candidate = "name"; result = HMT_KEY_NAME; break;
+        case 7: candidate = "version"; result = HMT_KEY_VERSION; break;
+        case 12: candidate = "diffuse_name"; result = HMT_KEY_DIFFUSE_NAME; break;
+        case 13: candidate = "diffuse_color"; result = HMT_KEY_DIFFUSE_COLOR; break;
+        default: return HMT_KEY_UNKNOWN;
+    }
 
-        line_length = string_length(trimmed);
+    return (key[0] | 0x20) == candidate[0] && key_equals(key, length, candidate) ? result : HMT_KEY_UNKNOWN;
+}
 
-        if (line_length < 1 || trimmed[0] == '#')
+// Parses a decimal such as "-1.5e2" from [*cursor, end). The buffer is not NUL terminated, so strtof can not be used.
+static b8 parse_f32(const char** cursor, const char* end, f32* out_value)
+{
+    const char* c = skip_spaces(*cursor, end);
+
+    f64 sign = 1.0;
+    if (c < end && (*c == '-' || *c == '+'))
+    {
+        sign = *c == '-' ? -1.0 : 1.0;
+        c++;
+    }
+
+    f64 value = 0.0;
+    b8 has_digits = FALSE;
+    for (; c < end && *c >= '0' && *c <= '9'; ++c)
+    {
+        value = value * 10.0 + (*c - '0');
+        has_digits = TRUE;
+    }
+    if (c < end && *c == '.')
+    {
+        f64 scale = 0.1;
+        for (++c; c < end && *c >= '0' && *c <= '9'; ++c)
         {
-            line_number++;
-            continue;
+            value += (*c - '0') * scale;
+            scale *= 0.1;
+            has_digits = TRUE;
         }
+    }
+    if (!has_digits)
+    {
+        return FALSE;
+    }
 
-        i32 equal_index = string_index_of(trimmed, '=');
-        if (equal_index == -1)
+    if (c < end && (*c == 'e' || *c == 'E'))
+    {
+        ++c;
+        b8 negative = c < end && *c == '-';
+        if (c < end && (*c == '-' || *c == '+')) ++c;
+        i32 exponent = 0;
+        for (; c < end && *c >= '0' && *c <= '9'; ++c)
         {
-            HWARN("Potential formatting issue found in file '%s': '=' token not found. Skipping line %ui.", full_file_path, line_number);
-            line_number++;
-            continue;
+            exponent = exponent < 1000 ? exponent * 10 + (*c - '0') : exponent;
+        }
+        for (i32 i = 0; i < exponent; ++i)
+        {
+            value = negative ? value * 0.1 : value * 10.0;
         }
+    }
+
+    // Numbers are separated by spaces, anything else directly after one is malformed.
+    if (c < end && !is_space(*c))
+    {
+        return FALSE;
+    }
 
-        char raw_var_name[64];
-        hzero_memory(raw_var_name, sizeof(char) * 64);
-        string_mid(raw_var_name, trimmed, 0, equal_index);
-        char* trimmed_var_name = string_trim(raw_var_name);
+    *out_value = (f32)(sign * value);
+    *cursor = c;
+    return TRUE;
+}
 
-        char raw_value[446];
-        hzero_memory(raw_value, sizeof(char) * 446);
-        string_mid(raw_value, trimmed, equal_index + 1, -1);
-        char* trimmed_value = string_trim(raw_value);
+static void copy_value(char* dest, u32 capacity, const char* value, u32 length)
+{
+    u32 copy_length = length < capacity - 1 ? length : capacity - 1;
+    hcopy_memory(dest, value, copy_length);
+    dest[copy_length] = 0;
+}
 
-        if (strings_equali(trimmed_var_name, "version"))
-        {
+static void apply_value(hmt_key key, const char* value, u32 value_length, const char* full_file_path, material_resource_data* resource_data)
+{
+    switch (key)
+    {
+        case HMT_KEY_VERSION:
             // TODO: version
+            break;
+        case HMT_KEY_NAME:
+            copy_value(resource_data->name, MATERIAL_NAME_MAX_LENGTH, value, value_length);
+            break;
+        case HMT_KEY_DIFFUSE_NAME:
+            copy_value(resource_data->diffuse_name, TEXTURE_NAME_MAX_LENGTH, value, value_length);
+            break;
+        case HMT_KEY_DIFFUSE_COLOR:
+        {
+            const char* cursor = value;
+            const char* end = value + value_length;
+            vec4 color;
+            if (parse_f32(&cursor, end, &color.x) && parse_f32(&cursor, end, &color.y) &&
+                parse_f32(&cursor, end, &color.z) && parse_f32(&cursor, end, &color.w))
+            {
+                resource_data->diffuse_color = color;
+            }
+            else
+            {
+                HWARN("Error parsing diffuse_color in file '%s'. Using default of white instead.", full_file_path);
+            }
+        } break;
+        default:
+            break;
+    }
+}
+
+// Parses "key = value" lines in place in a single pass, nothing is copied but the values kept.
+static void parse_material(const char* text, u64 size, const char* full_file_path, material_resource_data* resource_data)
+{
+    const char* c = text;
+    const char* end = text + size;
+    u32 line_number = 0;
+    while (c < end)
+    {
+        line_number++;
+        const char* line_end = memchr(c, '\n', end - c);
+        if (!line_end)
+        {
+            line_end = end;
         }
-        else if (strings_equali(trimmed_var_name, "name"))
+        const char* line = skip_spaces(c, line_end);
+        c = line_end < end ? line_end + 1 : end;
+
+        if (line == line_end || *line == '#')
         {
-            string_ncopy(resource_data->name, trimmed_value, MATERIAL_NAME_MAX_LENGTH);
+            continue;
         }
-        else if (strings_equali(trimmed_var_name, "diffuse_name"))
+
+        const char* equals = memchr(line, '=', line_end - line);
+        if (!equals)
         {
-            string_ncopy(resource_data->diffuse_name, trimmed_value, TEXTURE_NAME_MAX_LENGTH);
+            HWARN("Potential formatting issue found in file '%s': '=' token not found. Skipping line %u.", full_file_path, line_number);
+            continue;
         }
-        else if (strings_equali(trimmed_var_name, "diffuse_color"))
+
+        u32 key_length = (u32)(trim_end(line, equals) - line);
+        if (key_length == 0)
         {
-            if (!string_to_vec4(trimmed_value, &resource_data->diffuse_color))
-            {
-                HWARN("Error parsing diffuse_color in file '%s'. Using default of white instead.", full_file_path);
-            }
+            continue;
         }
 
-        hzero_memory(line_buf, sizeof(char) * 512);
-        line_number++;
+        const char* value = skip_spaces(equals + 1, line_end);
+        u32 value_length = (u32)(trim_end(value, line_end) - value);
+        apply_value(find_key(line, key_length), value, value_length, full_file_path, resource_data);
     }
+}
 
-    filesystem_close(&f);
+b8 material_loader_load_from_memory(struct resource_loader* self, const char* name, const void* data, u64 size, resource* out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return FALSE;
+    }
+
+    char* format_str = "%s/%s/%s%s";
+    char full_file_path[512];
+
+    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, self->extension);
+
+    out_resource->full_path = string_duplicate(full_file_path);
+
+    material_resource_data* resource_data = hallocate(sizeof(material_resource_data), MEMORY_TAG_MATERIAL);
+    resource_data->auto_release = TRUE;
+    resource_data->diffuse_color = vec4_one();
+    resource_data->diffuse_name[0] = 0;
+    string_ncopy(resource_data->name, name, MATERIAL_NAME_MAX_LENGTH);
+
+    parse_material(data, size, full_file_path, resource_data);
 
     out_resource->data = resource_data;
     out_resource->data_size = sizeof(material_resource_data);
@@ -107,6 +244,34 @@ b8 material_loader_load(struct resource_loader* self, const char* name, resource
     return TRUE;
 }
 
+b8 material_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return FALSE;
+    }
+
+    const void* data;
+    u64 size;
+    file_view view = {0};
+    if (!resource_system_find_packed(self, name, &data, &size))
+    {
+        char full_file_path[512];
+        string_format(full_file_path, "%s/%s/%s%s", resource_system_base_path(), self->type_path, name, self->extension);
+        if (!filesystem_map(full_file_path, &view))
+        {
+            HERROR("material_loader_load - unable to open material file for reading: '%s'.", full_file_path);
+            return FALSE;
+        }
+        data = view.data;
+        size = view.size;
+    }
+
+    b8 result = material_loader_load_from_memory(self, name, data, size, out_resource);
+    filesystem_unmap(&view);
+    return result;
+}
+
 void material_loader_unload(struct resource_loader* self, resource* resource)
 {
     if (!self || !resource)
@@ -137,7 +302,9 @@ resource_loader material_resource_loader_create()
     loader.custom_type = 0;
     loader.load = material_loader_load;
     loader.unload = material_loader_unload;
+    loader.load_from_memory = material_loader_load_from_memory;
     loader.type_path = "materials";
+    loader.extension = ".hmt";
 
     return loader;
 }
\ No newline at end of file
@@ -2,4 +2,5 @@
 
 #include "systems/resource_system.h"
 
+// Text resources hold the file as stored, not NUL terminated, data_size is its length.
 resource_loader text_resource_loader_create();
\ No newline at end of file
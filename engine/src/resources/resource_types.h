@@ -2,11 +2,15 @@
 
 #include "math/math_types.h"
 
+#include "platform/filesystem.h"
+
 typedef enum resource_type
 {
     RESOURCE_TYPE_TEXT,
     RESOURCE_TYPE_BINARY,
     RESOURCE_TYPE_IMAGE,
+    // An image cooked to .htex, see resources/htex.h.
+    RESOURCE_TYPE_COOKED_IMAGE,
     RESOURCE_TYPE_MATERIAL,
     RESOURCE_TYPE_STATIC_MESH,
     RESOURCE_TYPE_CUSTOM
@@ -19,16 +23,22 @@ typedef struct resource
     char* full_path;
     u64 data_size;
     void* data;
+    // The mapping data points into when a loader mapped a loose file, released on unload. Empty otherwise.
+    file_view view;
 } resource;
 
 #define TEXTURE_NAME_MAX_LENGTH 512
 typedef struct texture
 {
     u32 handle;
+    // Bumped whenever the pixels are replaced. INVALID_ID while the default texture stands in for a pending load.
+    u32 generation;
     u32 width;
     u32 height;
     u8 channel_count;
     b8 has_transparency;
+    // Levels stored back to back in the pixels the texture is created from, 1 for the full size image alone.
+    u32 mip_count;
     char name[TEXTURE_NAME_MAX_LENGTH];
     void* internal_data;
 } texture;
@@ -38,6 +48,9 @@ typedef struct image_resource_data
     u8 channel_count;
     u32 width;
     u32 height;
+    u32 mip_count;
+    b8 has_transparency;
+    // Every level of the mip chain back to back, bottom row first.
     u8* pixels;
 } image_resource_data;
 
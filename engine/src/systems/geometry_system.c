@@ -1,3 +1,5 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "geometry_system.h"
 
 #include "core/logger.h"
@@ -20,6 +22,8 @@ typedef struct geometry_system_state
     geometry default_geometry;
 
     geometry_reference* registered_geometries;
+    // Slots from here on have never been used, so acquiring only scans and initializes the ones below.
+    u32 used_slot_count;
 } geometry_system_state;
 
 static geometry_system_state* state_ptr = 0;
@@ -51,12 +55,7 @@ b8 geometry_system_initialize(u64* memory_requirement, void* state, geometry_sys
     void* array_block = state + struct_requirement;
     state_ptr->registered_geometries = array_block;
 
-    u32 count = state_ptr->config.max_geometry_count;
-    for (u32 i = 0; i < count; ++i)
-    {
-        state_ptr->registered_geometries[i].geometry.handle = INVALID_ID;
-        state_ptr->registered_geometries[i].geometry.internal_id = INVALID_ID;
-    }
+    state_ptr->used_slot_count = 0;
 
     if (!create_default_geometry(state_ptr))
     {
@@ -74,7 +73,7 @@ void geometry_system_shutdown(void* state)
 
 geometry* geometry_system_acquire_by_id(u32 id)
 {
-    if (id != INVALID_ID && state_ptr->registered_geometries[id].geometry.handle != INVALID_ID)
+    if (id < state_ptr->used_slot_count && state_ptr->registered_geometries[id].geometry.handle != INVALID_ID)
     {
         state_ptr->registered_geometries[id].reference_count++;
         return &state_ptr->registered_geometries[id].geometry;
@@ -87,18 +86,30 @@ geometry* geometry_system_acquire_by_id(u32 id)
 geometry* geometry_system_acquire_from_config(geometry_config config, b8 auto_release)
 {
     geometry* g = 0;
-    for (u32 i = 0; i < state_ptr->config.max_geometry_count; ++i)
+    u32 index = INVALID_ID;
+    for (u32 i = 0; i < state_ptr->used_slot_count; ++i)
     {
         if (state_ptr->registered_geometries[i].geometry.handle == INVALID_ID)
         {
-            state_ptr->registered_geometries[i].auto_release = auto_release;
-            state_ptr->registered_geometries[i].reference_count = 1;
-            g = &state_ptr->registered_geometries[i].geometry;
-            g->handle = i;
+            index = i;
             break;
         }
     }
 
+    if (index == INVALID_ID && state_ptr->used_slot_count < state_ptr->config.max_geometry_count)
+    {
+        index = state_ptr->used_slot_count++;
+        state_ptr->registered_geometries[index].geometry.internal_id = INVALID_ID;
+    }
+
+    if (index != INVALID_ID)
+    {
+        state_ptr->registered_geometries[index].auto_release = auto_release;
+        state_ptr->registered_geometries[index].reference_count = 1;
+        g = &state_ptr->registered_geometries[index].geometry;
+        g->handle = index;
+    }
+
     if (!g)
     {
         HERROR("Unable to obtain free slot for geometry. Adjust configuration to allow more space. Returning nullptr.");
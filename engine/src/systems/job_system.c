@@ -0,0 +1,430 @@
+#define HLOG_CATEGORY LOG_CATEGORY_CORE
+
+#include "job_system.h"
+
+#include "core/logger.h"
+#include "core/atomic.h"
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+
+// Failed rounds of stealing before a worker goes to sleep.
+#define JOB_SYSTEM_SPIN_ROUNDS 64
+
+typedef struct job
+{
+    job_entry entry;
+    void* data;
+    job_counter* counter;
+} job;
+
+/*
+Chase-Lev work-stealing deque with a fixed capacity.
+The owner pushes and pops at the bottom, thieves take from the top.
+Indices only grow, so they are compared as signed values.
+*/
+typedef struct job_deque
+{
+    volatile u64 top;
+    u8 top_padding[56];
+    volatile u64 bottom;
+    u8 bottom_padding[56];
+    job jobs[JOB_SYSTEM_DEQUE_CAPACITY];
+} job_deque;
+
+typedef struct job_range
+{
+    job_range_entry entry;
+    void* data;
+    u32 start;
+    u32 end;
+} job_range;
+
+typedef struct job_system_state
+{
+    u32 worker_count;
+    // Deque 0 belongs to the initializing thread, 1..worker_count to the workers.
+    u32 deque_count;
+    job_deque* deques;
+    // Jobs from threads outside the pool, pushed under the lock and stolen like any other deque.
+    job_deque* injection;
+    platform_mutex injection_lock;
+
+    platform_thread* threads;
+    platform_semaphore wake;
+    volatile u32 sleeping;
+    volatile u32 running;
+} job_system_state;
+
+static job_system_state* state_ptr;
+
+// Deque index + 1 of the calling thread, 0 outside the pool.
+static HTHREADLOCAL u32 thread_slot;
+
+static b8 deque_push(job_deque* deque, const job* j)
+{
+    i64 bottom = (i64)deque->bottom;
+    i64 top = (i64)atomic_load_u64(&deque->top);
+    if (bottom - top >= JOB_SYSTEM_DEQUE_CAPACITY)
+    {
+        return FALSE;
+    }
+
+    deque->jobs[bottom & (JOB_SYSTEM_DEQUE_CAPACITY - 1)] = *j;
+    atomic_store_u64(&deque->bottom, (u64)(bottom + 1));
+    return TRUE;
+}
+
+static b8 deque_pop(job_deque* deque, job* out_job)
+{
+    i64 bottom = (i64)deque->bottom - 1;
+    atomic_store_u64(&deque->bottom, (u64)bottom);
+    atomic_thread_fence_seq_cst();
+    i64 top = (i64)atomic_load_u64(&deque->top);
+
+    if (top > bottom)
+    {
+        atomic_store_u64(&deque->bottom, (u64)(bottom + 1));
+        return FALSE;
+    }
+
+    *out_job = deque->jobs[bottom & (JOB_SYSTEM_DEQUE_CAPACITY - 1)];
+    if (top == bottom)
+    {
+        // Last job, race the thieves for it.
+        u64 expected = (u64)top;
+        b8 won = atomic_compare_exchange_u64(&deque->top, &expected, (u64)(top + 1));
+        atomic_store_u64(&deque->bottom, (u64)(bottom + 1));
+        return won;
+    }
+
+    return TRUE;
+}
+
+static b8 deque_steal(job_deque* deque, job* out_job)
+{
+    i64 top = (i64)atomic_load_u64(&deque->top);
+    atomic_thread_fence_seq_cst();
+    i64 bottom = (i64)atomic_load_u64(&deque->bottom);
+
+    if (top >= bottom)
+    {
+        return FALSE;
+    }
+
+    // May read a slot the owner is refilling, the exchange below rejects it in that case.
+    *out_job = deque->jobs[top & (JOB_SYSTEM_DEQUE_CAPACITY - 1)];
+    u64 expected = (u64)top;
+    return atomic_compare_exchange_u64(&deque->top, &expected, (u64)(top + 1));
+}
+
+HINLINE b8 deque_is_empty(job_deque* deque)
+{
+    return (i64)atomic_load_u64(&deque->top) >= (i64)atomic_load_u64(&deque->bottom);
+}
+
+static b8 any_work()
+{
+    if (!deque_is_empty(state_ptr->injection)) return TRUE;
+
+    for (u32 i = 0; i < state_ptr->deque_count; ++i)
+    {
+        if (!deque_is_empty(&state_ptr->deques[i])) return TRUE;
+    }
+
+    return FALSE;
+}
+
+static b8 find_job(u32 slot, u32* seed, job* out_job)
+{
+    if (slot && deque_pop(&state_ptr->deques[slot - 1], out_job))
+    {
+        return TRUE;
+    }
+
+    // Start at a different victim each time so thieves spread out.
+    *seed = *seed * 1664525u + 1013904223u;
+    u32 count = state_ptr->deque_count;
+    u32 first = (*seed >> 16) % count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 victim = (first + i) % count;
+        if (victim + 1 != slot && deque_steal(&state_ptr->deques[victim], out_job))
+        {
+            return TRUE;
+        }
+    }
+
+    return deque_steal(state_ptr->injection, out_job);
+}
+
+HINLINE void run_job(const job* j)
+{
+    j->entry(j->data);
+    if (j->counter)
+    {
+        atomic_fetch_add_u32(&j->counter->pending, (u32)-1);
+    }
+}
+
+static void wake_one()
+{
+    // Pairs with the fence in worker_sleep: either the worker sees the new job or we see it sleeping.
+    atomic_thread_fence_seq_cst();
+    u32 sleeping = atomic_load_u32(&state_ptr->sleeping);
+    while (sleeping)
+    {
+        if (atomic_compare_exchange_u32(&state_ptr->sleeping, &sleeping, sleeping - 1))
+        {
+            platform_semaphore_signal(&state_ptr->wake, 1);
+            return;
+        }
+    }
+}
+
+static void worker_sleep()
+{
+    atomic_fetch_add_u32(&state_ptr->sleeping, 1);
+    atomic_thread_fence_seq_cst();
+
+    if (any_work() || !atomic_load_u32(&state_ptr->running))
+    {
+        // Take the sleeper back unless a submitter already did, its signal then just costs a spurious wake up.
+        u32 sleeping = atomic_load_u32(&state_ptr->sleeping);
+        while (sleeping)
+        {
+            if (atomic_compare_exchange_u32(&state_ptr->sleeping, &sleeping, sleeping - 1))
+            {
+                return;
+            }
+        }
+    }
+
+    platform_semaphore_wait(&state_ptr->wake);
+}
+
+static u32 worker_main(void* params)
+{
+    u32 slot = (u32)(u64)params;
+    thread_slot = slot;
+    u32 seed = slot * 2654435761u;
+
+    u32 idle_rounds = 0;
+    job j;
+    while (atomic_load_u32(&state_ptr->running))
+    {
+        if (find_job(slot, &seed, &j))
+        {
+            run_job(&j);
+            idle_rounds = 0;
+            continue;
+        }
+
+        if (++idle_rounds < JOB_SYSTEM_SPIN_ROUNDS)
+        {
+            atomic_cpu_relax();
+            continue;
+        }
+
+        worker_sleep();
+        idle_rounds = 0;
+    }
+
+    return 0;
+}
+
+b8 job_system_initialize(u64* memory_requirement, void* state, job_system_config config)
+{
+    u32 worker_count = config.worker_count;
+    if (worker_count == 0)
+    {
+        u32 processors = platform_get_processor_count();
+        worker_count = processors > 1 ? processors - 1 : 0;
+    }
+    if (worker_count > JOB_SYSTEM_MAX_WORKERS)
+    {
+        worker_count = JOB_SYSTEM_MAX_WORKERS;
+    }
+
+    u64 struct_requirement = sizeof(job_system_state);
+    u64 deques_requirement = sizeof(job_deque) * (worker_count + 2);
+    u64 threads_requirement = sizeof(platform_thread) * worker_count;
+    // Room to align the deques to a cache line.
+    *memory_requirement = struct_requirement + deques_requirement + threads_requirement + 64;
+
+    if (!state)
+    {
+        return FALSE;
+    }
+
+    state_ptr = state;
+    hzero_memory(state_ptr, *memory_requirement);
+
+    state_ptr->worker_count = worker_count;
+    state_ptr->deque_count = worker_count + 1;
+    state_ptr->deques = (job_deque*)(((u64)state + struct_requirement + 63) & ~(u64)63);
+    state_ptr->injection = &state_ptr->deques[worker_count + 1];
+    state_ptr->threads = (platform_thread*)(state_ptr->injection + 1);
+    state_ptr->running = TRUE;
+
+    if (!platform_mutex_create(&state_ptr->injection_lock) || !platform_semaphore_create(0, &state_ptr->wake))
+    {
+        HERROR("Failed to create job system synchronization objects.");
+        return FALSE;
+    }
+
+    thread_slot = 1;
+
+    for (u32 i = 0; i < worker_count; ++i)
+    {
+        if (!platform_thread_create(worker_main, (void*)(u64)(i + 2), &state_ptr->threads[i]))
+        {
+            HERROR("Failed to start job worker %u.", i);
+            state_ptr->worker_count = i;
+            job_system_shutdown(state_ptr);
+            return FALSE;
+        }
+    }
+
+    HINFO("Job system initialized with %u workers.", worker_count);
+
+    return TRUE;
+}
+
+void job_system_shutdown(void* state)
+{
+    if (!state_ptr) return;
+
+    atomic_store_u32(&state_ptr->running, FALSE);
+    platform_semaphore_signal(&state_ptr->wake, state_ptr->worker_count);
+
+    for (u32 i = 0; i < state_ptr->worker_count; ++i)
+    {
+        platform_thread_join(&state_ptr->threads[i]);
+    }
+
+    platform_semaphore_destroy(&state_ptr->wake);
+    platform_mutex_destroy(&state_ptr->injection_lock);
+
+    thread_slot = 0;
+    state_ptr = 0;
+}
+
+u32 job_system_worker_count()
+{
+    return state_ptr ? state_ptr->worker_count : 0;
+}
+
+void job_system_submit(job_entry entry, void* data, job_counter* counter)
+{
+    job j;
+    j.entry = entry;
+    j.data = data;
+    j.counter = counter;
+
+    if (counter)
+    {
+        atomic_fetch_add_u32(&counter->pending, 1);
+    }
+
+    if (!state_ptr)
+    {
+        run_job(&j);
+        return;
+    }
+
+    b8 queued;
+    if (thread_slot)
+    {
+        queued = deque_push(&state_ptr->deques[thread_slot - 1], &j);
+    }
+    else
+    {
+        platform_mutex_lock(&state_ptr->injection_lock);
+        queued = deque_push(state_ptr->injection, &j);
+        platform_mutex_unlock(&state_ptr->injection_lock);
+    }
+
+    if (!queued)
+    {
+        run_job(&j);
+        return;
+    }
+
+    wake_one();
+}
+
+void job_system_wait(job_counter* counter)
+{
+    u32 seed = (u32)(u64)counter;
+    job j;
+    while (atomic_load_u32(&counter->pending))
+    {
+        if (state_ptr && find_job(thread_slot, &seed, &j))
+        {
+            run_job(&j);
+        }
+        else
+        {
+            // What remains is running on other threads.
+            platform_thread_yield();
+        }
+    }
+}
+
+b8 job_system_run_pending()
+{
+    if (!state_ptr) return FALSE;
+
+    u32 seed = (u32)platform_get_ticks_ns();
+    job j;
+    if (!find_job(thread_slot, &seed, &j))
+    {
+        return FALSE;
+    }
+
+    run_job(&j);
+    return TRUE;
+}
+
+static void run_range(void* data)
+{
+    job_range* range = data;
+    range->entry(range->data, range->start, range->end);
+}
+
+void job_system_parallel_for(u32 count, u32 batch_size, job_range_entry entry, void* data)
+{
+    if (count == 0) return;
+
+    if (batch_size == 0)
+    {
+        // A few batches per thread leaves room to balance uneven work.
+        u32 threads = job_system_worker_count() + 1;
+        batch_size = (count + threads * 4 - 1) / (threads * 4);
+    }
+    if ((count + batch_size - 1) / batch_size > JOB_SYSTEM_MAX_BATCHES)
+    {
+        batch_size = (count + JOB_SYSTEM_MAX_BATCHES - 1) / JOB_SYSTEM_MAX_BATCHES;
+    }
+
+    u32 batch_count = (count + batch_size - 1) / batch_size;
+    if (batch_count == 1)
+    {
+        entry(data, 0, count);
+        return;
+    }
+
+    job_range ranges[JOB_SYSTEM_MAX_BATCHES];
+    job_counter counter = {0};
+    for (u32 i = 0; i < batch_count; ++i)
+    {
+        ranges[i].entry = entry;
+        ranges[i].data = data;
+        ranges[i].start = i * batch_size;
+        ranges[i].end = i == batch_count - 1 ? count : (i + 1) * batch_size;
+        job_system_submit(run_range, &ranges[i], &counter);
+    }
+
+    job_system_wait(&counter);
+}
\ No newline at end of file
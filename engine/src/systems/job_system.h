@@ -0,0 +1,59 @@
+#pragma once
+
+#include "defines.h"
+
+#define JOB_SYSTEM_MAX_WORKERS 64
+// Per thread deque size, must be a power of two. Submissions to a full deque run inline.
+#define JOB_SYSTEM_DEQUE_CAPACITY 4096
+// Batches a single parallel_for splits its range into at most.
+#define JOB_SYSTEM_MAX_BATCHES 256
+
+typedef void (*job_entry)(void* data);
+
+// Processes elements [start, end) of a parallel_for.
+typedef void (*job_range_entry)(void* data, u32 start, u32 end);
+
+// Counts unfinished jobs; zero it before submitting and wait on it with job_system_wait.
+typedef struct job_counter
+{
+    volatile u32 pending;
+} job_counter;
+
+typedef struct job_system_config
+{
+    // Worker threads besides the calling thread, 0 uses one per remaining processor.
+    u32 worker_count;
+} job_system_config;
+
+/**
+ * @brief Starts the worker pool. The calling thread joins the pool while it waits on counters,
+ * so it must be the thread that later calls job_system_shutdown.
+ */
+b8 job_system_initialize(u64* memory_requirement, void* state, job_system_config config);
+void job_system_shutdown(void* state);
+
+// Worker threads, not counting the thread that initialized the system.
+HAPI u32 job_system_worker_count();
+
+/**
+ * @brief Queues a job. It goes on the calling thread's own deque when the caller is part of the pool,
+ * other threads share a locked injection deque.
+ *
+ * @param entry the function to run.
+ * @param data passed to entry, must stay valid until the job has run.
+ * @param counter incremented now and decremented once the job finishes, may be 0.
+ */
+HAPI void job_system_submit(job_entry entry, void* data, job_counter* counter);
+
+// Runs queued jobs on the calling thread until the counter drops to zero.
+HAPI void job_system_wait(job_counter* counter);
+
+// Runs one queued job on the calling thread, for callers that wait on something other than a counter.
+HAPI b8 job_system_run_pending();
+
+/**
+ * @brief Splits [0, count) into batches, runs them across the pool and returns once all are done.
+ *
+ * @param batch_size elements per job, 0 picks one from the worker count.
+ */
+HAPI void job_system_parallel_for(u32 count, u32 batch_size, job_range_entry entry, void* data);
\ No newline at end of file
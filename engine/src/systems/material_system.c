@@ -1,7 +1,10 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "material_system.h"
 
 #include "core/logger.h"
 #include "core/hstring.h"
+#include "memory/hmemory.h"
 #include "containers/hashtable.h"
 #include "math/hmath.h"
 #include "renderer/renderer_frontend.h"
@@ -16,14 +19,18 @@ typedef struct material_system_state
     material default_material;
 
     material* registered_materials;
+    // Slots from here on have never been used, so acquiring only scans and initializes the ones below.
+    u32 used_slot_count;
 
     hashtable registered_materials_table;
 } material_system_state;
 
+// Zeroed means not loaded, so the table needs no filling.
 typedef struct material_reference
 {
     u64 reference_count;
-    u32 id;
+    // Index + 1 into registered_materials, 0 while the material is not loaded.
+    u32 slot;
     b8 auto_release;
 } material_reference;
 
@@ -57,21 +64,10 @@ b8 material_system_initialize(u64* memory_requirement, void* state, material_sys
     void* array_block = state + struct_requirement;
     state_ptr->registered_materials = array_block;
 
-    void* hashtable_block = array_block + hashtable_requirement;
-    hashtable_create(sizeof(material_reference), config.max_material_count, hashtable_block, FALSE, &state_ptr->registered_materials_table);
-
-    material_reference invalid_ref;
-    invalid_ref.auto_release = FALSE;
-    invalid_ref.id = INVALID_ID;
-    invalid_ref.reference_count = 0;
-    hashtable_fill(&state_ptr->registered_materials_table, &invalid_ref);
+    void* hashtable_block = array_block + array_requirement;
+    hashtable_create_zeroed(sizeof(material_reference), config.max_material_count, hashtable_block, FALSE, &state_ptr->registered_materials_table);
 
-    u32 count = state_ptr->config.max_material_count;
-    for (u32 i = 0; i < count; ++i)
-    {
-        state_ptr->registered_materials[i].handle = INVALID_ID;
-        state_ptr->registered_materials[i].internal_id = INVALID_ID;
-    }
+    state_ptr->used_slot_count = 0;
 
     if (!create_default_material(state_ptr))
     {
@@ -88,7 +84,7 @@ void material_system_shutdown(void* state)
 
     if (!s) { return; }
 
-    u32 count = s->config.max_material_count;
+    u32 count = s->used_slot_count;
     for (u32 i = 0; i < count; ++i)
     {
         if (s->registered_materials[i].handle != INVALID_ID)
@@ -102,6 +98,24 @@ void material_system_shutdown(void* state)
     state_ptr = 0;
 }
 
+static material* acquire_loaded(resource* material_resource)
+{
+    material* m = 0;
+    if (material_resource->data)
+    {
+        m = material_system_acquire_from_config(*(material_config*)material_resource->data);
+    }
+
+    resource_system_unload(material_resource);
+
+    if (!m)
+    {
+        HERROR("Failed to load material resource. returning nullptr.");
+    }
+
+    return m;
+}
+
 material* material_system_acquire(const char* name)
 {
     resource material_resource;
@@ -111,20 +125,36 @@ material* material_system_acquire(const char* name)
         return 0;
     }
 
-    material* m;
-    if (material_resource.data)
-    {
-        m = material_system_acquire_from_config(*(material_config*)material_resource.data);
-    }
+    return acquire_loaded(&material_resource);
+}
 
-    resource_system_unload(&material_resource);
+u32 material_system_acquire_batch(u32 count, const char** names, material** out_materials)
+{
+    u64 resources_size = sizeof(resource) * count;
+    u64 loaded_size = sizeof(b8) * count;
+    resource* resources = hallocate(resources_size, MEMORY_TAG_ARRAY);
+    b8* loaded = hallocate(loaded_size, MEMORY_TAG_ARRAY);
 
-    if (!m)
+    resource_system_load_batch(count, names, RESOURCE_TYPE_MATERIAL, resources, loaded);
+
+    // Registering touches the texture system and the renderer, which stays on this thread.
+    u32 acquired = 0;
+    for (u32 i = 0; i < count; ++i)
     {
-        HERROR("Failed to load material resource. returning nullptr.");
+        out_materials[i] = 0;
+        if (!loaded[i])
+        {
+            HERROR("Failed to load material resource '%s'.", names[i]);
+            continue;
+        }
+
+        out_materials[i] = acquire_loaded(&resources[i]);
+        acquired += out_materials[i] ? 1 : 0;
     }
 
-    return m;
+    hfree(loaded, loaded_size, MEMORY_TAG_ARRAY);
+    hfree(resources, resources_size, MEMORY_TAG_ARRAY);
+    return acquired;
 }
 
 material* material_system_acquire_from_config(material_config config)
@@ -144,21 +174,29 @@ material* material_system_acquire_from_config(material_config config)
 
         ref.reference_count++;
 
-        if (ref.id == INVALID_ID)
+        if (ref.slot == 0)
         {
-            u32 count = state_ptr->config.max_material_count;
+            u32 count = state_ptr->used_slot_count;
             material* m = 0;
             for (u32 i = 0; i < count; ++i)
             {
                 if (state_ptr->registered_materials[i].handle == INVALID_ID)
                 {
-                    ref.id = i;
+                    ref.slot = i + 1;
                     m = &state_ptr->registered_materials[i];
                     break;
                 }
             }
 
-            if (!m || ref.id == INVALID_ID)
+            if (!m && state_ptr->used_slot_count < state_ptr->config.max_material_count)
+            {
+                m = &state_ptr->registered_materials[state_ptr->used_slot_count++];
+                m->handle = INVALID_ID;
+                m->internal_id = INVALID_ID;
+                ref.slot = state_ptr->used_slot_count;
+            }
+
+            if (!m)
             {
                 HFATAL("material_system_acquire - Material system cannot hold any more materials. Adjust configuration to allow more.");
                 return 0;
@@ -178,7 +216,7 @@ material* material_system_acquire_from_config(material_config config)
         }
 
         hashtable_set(&state_ptr->registered_materials_table, config.name, &ref);
-        return &state_ptr->registered_materials[ref.id];
+        return &state_ptr->registered_materials[ref.slot - 1];
     }
 
     HERROR("material_system_acquire_from_config failed to acquire material '%s'.", config.name);
@@ -204,11 +242,11 @@ void material_system_release(const char* name)
         ref.reference_count--;
         if (ref.reference_count == 0 && ref.auto_release)
         {
-            material* m = &state_ptr->registered_materials[ref.id];
+            material* m = &state_ptr->registered_materials[ref.slot - 1];
 
             destroy_material(m);
 
-            ref.id = INVALID_ID;
+            ref.slot = 0;
             ref.auto_release = FALSE;
             HTRACE("Released material '%s' because reference count = 0 and auto_release = true.", name);
         }
@@ -19,12 +19,21 @@ typedef struct material_config
     char diffuse_name[TEXTURE_NAME_MAX_LENGTH];
 } material_config;
 
+// state must be zeroed memory, the material table starts out empty without being cleared.
 b8 material_system_initialize(u64* memory_requirement, void* state, material_system_config config);
 
 void material_system_shutdown(void* state);
 
 material* material_system_acquire(const char* name);
 
+/**
+ * @brief Acquires many materials at once. Their files are read and parsed in parallel on the job system.
+ *
+ * @param out_materials receives a material per name, 0 for those that failed.
+ * @return the number of materials acquired.
+ */
+u32 material_system_acquire_batch(u32 count, const char** names, material** out_materials);
+
 material* material_system_acquire_from_config(material_config config);
 
 void material_system_release(const char* name);
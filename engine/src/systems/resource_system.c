@@ -1,24 +1,115 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "resource_system.h"
 
 #include "core/logger.h"
 #include "core/hstring.h"
+#include "core/profiler.h"
+#include "core/atomic.h"
+#include "containers/mpsc_queue.h"
+#include "memory/hmemory.h"
+
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "platform/async_io.h"
+
+#include "resources/hpak.h"
+#include "resources/cook_manifest.h"
+
+#include "systems/job_system.h"
 
 // Known resource loaders.
 #include "resources/loaders/text_loader.h"
 #include "resources/loaders/binary_loader.h"
 #include "resources/loaders/image_loader.h"
+#include "resources/loaders/cooked_image_loader.h"
 #include "resources/loaders/material_loader.h"
 
+#define RESOURCE_REQUEST_NAME_MAX_LENGTH 512
+#define RESOURCE_SYSTEM_MAX_PACKS 8
+
+typedef struct resource_request
+{
+    // A copy, the caller's string may not outlive the request.
+    char name[RESOURCE_REQUEST_NAME_MAX_LENGTH];
+    resource_loader* loader;
+    resource_loaded_callback callback;
+    void* user_data;
+
+    // Written by the job, read on the main thread once the request is popped from the completed queue.
+    resource result;
+    b8 success;
+
+    // Bytes handed to loader->load_from_memory, either inside an archive or read by async I/O and owned by the request.
+    const void* file_data;
+    u64 file_size;
+    b8 owns_file;
+    async_io_read read;
+    char path[RESOURCE_REQUEST_NAME_MAX_LENGTH];
+
+    volatile u32 cancelled;
+    // Bumped on every reuse of the slot, so stale ids do not cancel a newer request.
+    u16 generation;
+    b8 in_use;
+} resource_request;
+
 typedef struct resource_system_state
 {
     resource_system_config config;
     resource_loader* registered_loaders;
+
+    resource_request* requests;
+    u32 next_request;
+    // Indices of requests whose job finished, pushed from the workers.
+    mpsc_queue completed;
+
+    // Reads of loaders with load_from_memory. Requests beyond its queue depth wait in the backlog, a ring of indices.
+    async_io io;
+    u32* io_backlog;
+    u32 io_backlog_start;
+    u32 io_backlog_count;
+
+    hpak packs[RESOURCE_SYSTEM_MAX_PACKS];
+    // Published after the archive is opened, so loads running on workers only see complete ones.
+    volatile u32 pack_count;
+
+    // Opened during initialization and left alone until shutdown, so workers read it freely.
+    cook_manifest manifest;
+    // Holds the manifest and the cooked files it names, with a trailing separator.
+    char cooked_directory[RESOURCE_REQUEST_NAME_MAX_LENGTH];
 } resource_system_state;
 
 static resource_system_state* state_ptr = 0;
 
 b8 load(const char* name, resource_loader* loader, resource* out_resource);
 
+// Request ids carry the slot in the low bits and its generation in the high bits.
+#define REQUEST_ID(index, generation) (((u32)(generation) << 16) | (index))
+
+static void open_manifest(const char* path)
+{
+    if (!cook_manifest_open(path, &state_ptr->manifest))
+    {
+        HWARN("Cook manifest '%s' could not be opened, cooked assets are looked for below the base path.", path);
+        return;
+    }
+
+    // Cooked files are named relative to the manifest.
+    u64 length = string_length(path);
+    while (length > 0 && path[length - 1] != '/' && path[length - 1] != '\\')
+    {
+        length--;
+    }
+    if (length >= RESOURCE_REQUEST_NAME_MAX_LENGTH)
+    {
+        length = RESOURCE_REQUEST_NAME_MAX_LENGTH - 1;
+    }
+    string_ncopy(state_ptr->cooked_directory, path, length);
+    state_ptr->cooked_directory[length] = 0;
+
+    HINFO("Opened cook manifest '%s' with %u cooked assets.", path, state_ptr->manifest.header->entry_count);
+}
+
 b8 resource_system_initialize(u64* memory_requirement, void* state, resource_system_config config)
 {
     if (config.max_loader_count == 0)
@@ -27,7 +118,17 @@ b8 resource_system_initialize(u64* memory_requirement, void* state, resource_sys
         return FALSE;
     }
 
-    *memory_requirement = sizeof(resource_system_state) + (sizeof(resource_loader) * config.max_loader_count);
+    if (config.max_async_request_count < 2 || config.max_async_request_count > 0x10000 || (config.max_async_request_count & (config.max_async_request_count - 1)))
+    {
+        HFATAL("resource_system_initialize failed because config.max_async_request_count is not a power of two up to 65536.");
+        return FALSE;
+    }
+
+    u64 loaders_requirement = sizeof(resource_loader) * config.max_loader_count;
+    u64 requests_requirement = sizeof(resource_request) * config.max_async_request_count;
+    u64 queue_requirement = mpsc_queue_memory_requirement(sizeof(u32), config.max_async_request_count);
+    u64 backlog_requirement = sizeof(u32) * config.max_async_request_count;
+    *memory_requirement = sizeof(resource_system_state) + loaders_requirement + requests_requirement + queue_requirement + backlog_requirement;
 
     if (!state)
     {
@@ -40,6 +141,23 @@ b8 resource_system_initialize(u64* memory_requirement, void* state, resource_sys
     void* array_block = state + sizeof(resource_system_state);
     state_ptr->registered_loaders = array_block;
 
+    state_ptr->requests = array_block + loaders_requirement;
+    hzero_memory(state_ptr->requests, requests_requirement);
+    state_ptr->next_request = 0;
+    state_ptr->io_backlog = (void*)state_ptr->requests + requests_requirement + queue_requirement;
+    state_ptr->io_backlog_start = 0;
+    state_ptr->io_backlog_count = 0;
+    hzero_memory(&state_ptr->io, sizeof(async_io));
+    hzero_memory(state_ptr->packs, sizeof(state_ptr->packs));
+    state_ptr->pack_count = 0;
+    hzero_memory(&state_ptr->manifest, sizeof(cook_manifest));
+
+    // Every request completes once, so the queue never fills up.
+    if (!mpsc_queue_create(sizeof(u32), config.max_async_request_count, (void*)state_ptr->requests + requests_requirement, &state_ptr->completed))
+    {
+        return FALSE;
+    }
+
     u32 count = config.max_loader_count;
     for (u32 i = 0; i < count; ++i)
     {
@@ -49,8 +167,33 @@ b8 resource_system_initialize(u64* memory_requirement, void* state, resource_sys
     resource_system_register_loader(text_resource_loader_create());
     resource_system_register_loader(binary_resource_loader_create());
     resource_system_register_loader(image_resource_loader_create());
+    resource_system_register_loader(cooked_image_resource_loader_create());
     resource_system_register_loader(material_resource_loader_create());
 
+    if (config.pack_path && filesystem_exists(config.pack_path))
+    {
+        resource_system_mount(config.pack_path);
+    }
+
+    if (config.cook_manifest_path && filesystem_exists(config.cook_manifest_path))
+    {
+        open_manifest(config.cook_manifest_path);
+    }
+
+    if (config.io_queue_depth)
+    {
+        async_io_config io_config = {0};
+        io_config.queue_depth = config.io_queue_depth;
+        if (async_io_create(io_config, &state_ptr->io))
+        {
+            HINFO("Asynchronous loads read files through %s, %u at a time.", async_io_backend_name(state_ptr->io.backend), config.io_queue_depth);
+        }
+        else
+        {
+            HWARN("Async I/O could not be started, asynchronous loads read files on job workers.");
+        }
+    }
+
     HINFO("Resource system initialized successfully. Base path '%s'.", config.asset_base_path);
 
     return TRUE;
@@ -60,6 +203,29 @@ void resource_system_shutdown(void* state)
 {
     if (state_ptr)
     {
+        // Normally empty, resource_system_cancel_all drained the loads while the job system was still up.
+        async_io_destroy(&state_ptr->io);
+        state_ptr->io_backlog_count = 0;
+
+        u32 index;
+        while (mpsc_queue_pop(&state_ptr->completed, &index))
+        {
+            resource_request* request = &state_ptr->requests[index];
+            if (request->success)
+            {
+                resource_system_unload(&request->result);
+            }
+        }
+        mpsc_queue_destroy(&state_ptr->completed);
+
+        for (u32 i = 0; i < state_ptr->pack_count; ++i)
+        {
+            hpak_close(&state_ptr->packs[i]);
+        }
+        state_ptr->pack_count = 0;
+
+        cook_manifest_close(&state_ptr->manifest);
+
         state_ptr = 0;
     }
 }
@@ -100,7 +266,7 @@ b8 resource_system_register_loader(resource_loader loader)
     return FALSE;
 }
 
-b8 resource_system_load(const char* name, resource_type type, resource* out_resource)
+static resource_loader* find_loader(resource_type type)
 {
     if (state_ptr && type != RESOURCE_TYPE_CUSTOM)
     {
@@ -110,18 +276,81 @@ b8 resource_system_load(const char* name, resource_type type, resource* out_reso
             resource_loader* l = &state_ptr->registered_loaders[i];
             if (l->id != INVALID_ID && l->type == type)
             {
-                return load(name, l, out_resource);
+                return l;
             }
         }
     }
 
+    return 0;
+}
+
+b8 resource_system_load(const char* name, resource_type type, resource* out_resource)
+{
+    PROFILE_FUNCTION();
+
+    resource_loader* l = find_loader(type);
+    if (l)
+    {
+        return load(name, l, out_resource);
+    }
+
     out_resource->loader_id = INVALID_ID;
     HERROR("resource_system_load - No loader for type %d was found.", type);
     return FALSE;
 }
 
+typedef struct load_batch
+{
+    resource_loader* loader;
+    const char** names;
+    resource* resources;
+    b8* loaded;
+} load_batch;
+
+static void load_batch_range(void* data, u32 start, u32 end)
+{
+    load_batch* batch = data;
+    for (u32 i = start; i < end; ++i)
+    {
+        batch->loaded[i] = load(batch->names[i], batch->loader, &batch->resources[i]);
+    }
+}
+
+u32 resource_system_load_batch(u32 count, const char** names, resource_type type, resource* out_resources, b8* out_loaded)
+{
+    PROFILE_FUNCTION();
+
+    resource_loader* l = find_loader(type);
+    if (!l)
+    {
+        HERROR("resource_system_load_batch - No loader for type %d was found.", type);
+        for (u32 i = 0; i < count; ++i)
+        {
+            out_resources[i].loader_id = INVALID_ID;
+            out_loaded[i] = FALSE;
+        }
+        return 0;
+    }
+
+    load_batch batch;
+    batch.loader = l;
+    batch.names = names;
+    batch.resources = out_resources;
+    batch.loaded = out_loaded;
+    job_system_parallel_for(count, 0, load_batch_range, &batch);
+
+    u32 loaded = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        loaded += out_loaded[i] ? 1 : 0;
+    }
+    return loaded;
+}
+
 b8 resource_system_load_custom(const char* name, const char* custom_type, resource* out_resource)
 {
+    PROFILE_FUNCTION();
+
     if (state_ptr && custom_type && string_length(custom_type) > 0)
     {
         u32 count = state_ptr->config.max_loader_count;
@@ -155,6 +384,307 @@ void resource_system_unload(resource* resource)
     }
 }
 
+static void complete_request(resource_request* request)
+{
+    u32 index = (u32)(request - state_ptr->requests);
+    mpsc_queue_push(&state_ptr->completed, &index);
+}
+
+static void load_job(void* data)
+{
+    PROFILE_FUNCTION();
+
+    resource_request* request = data;
+    if (!atomic_load_u32(&request->cancelled))
+    {
+        request->success = load(request->name, request->loader, &request->result);
+    }
+
+    complete_request(request);
+}
+
+static void decode_job(void* data)
+{
+    PROFILE_FUNCTION();
+
+    resource_request* request = data;
+    if (!atomic_load_u32(&request->cancelled))
+    {
+        request->result.loader_id = request->loader->id;
+        request->success = request->loader->load_from_memory(request->loader, request->name, request->file_data, request->file_size, &request->result);
+    }
+
+    if (request->owns_file && request->file_data)
+    {
+        hfree((void*)request->file_data, request->file_size, MEMORY_TAG_ARRAY);
+    }
+    request->file_data = 0;
+
+    complete_request(request);
+}
+
+// Starts reads from the backlog while the async I/O queue has room.
+static void submit_backlog()
+{
+    u32 capacity = state_ptr->config.max_async_request_count;
+    while (state_ptr->io_backlog_count)
+    {
+        async_io_read* reads[64];
+        u32 count = state_ptr->io_backlog_count < 64 ? state_ptr->io_backlog_count : 64;
+        for (u32 i = 0; i < count; ++i)
+        {
+            u32 index = state_ptr->io_backlog[(state_ptr->io_backlog_start + i) & (capacity - 1)];
+            reads[i] = &state_ptr->requests[index].read;
+        }
+
+        u32 submitted = async_io_submit(&state_ptr->io, count, reads);
+        state_ptr->io_backlog_start = (state_ptr->io_backlog_start + submitted) & (capacity - 1);
+        state_ptr->io_backlog_count -= submitted;
+        if (submitted < count) return;
+    }
+}
+
+// Hands finished reads to decode jobs.
+static void collect_reads()
+{
+    async_io_read* reads[64];
+    u32 count;
+    while ((count = async_io_poll(&state_ptr->io, FALSE, 64, reads)) > 0)
+    {
+        for (u32 i = 0; i < count; ++i)
+        {
+            resource_request* request = reads[i]->user_data;
+            request->file_data = reads[i]->data;
+            request->file_size = reads[i]->size;
+            request->owns_file = TRUE;
+            if (reads[i]->success)
+            {
+                job_system_submit(decode_job, request, 0);
+            }
+            else
+            {
+                request->success = FALSE;
+                complete_request(request);
+            }
+        }
+    }
+
+    submit_backlog();
+}
+
+static void start_request(resource_request* request, b8 submit)
+{
+    resource_loader* l = request->loader;
+    if (!l->load_from_memory || !state_ptr->io.internal)
+    {
+        job_system_submit(load_job, request, 0);
+        return;
+    }
+
+    // Archived files are mapped already, only the decoding is left.
+    if (resource_system_find_packed(l, request->name, &request->file_data, &request->file_size))
+    {
+        request->owns_file = FALSE;
+        job_system_submit(decode_job, request, 0);
+        return;
+    }
+
+    string_format(request->path, "%s/%s/%s%s", state_ptr->config.asset_base_path, l->type_path, request->name, l->extension);
+    request->read.path = request->path;
+    request->read.user_data = request;
+
+    u32 capacity = state_ptr->config.max_async_request_count;
+    u32 index = (u32)(request - state_ptr->requests);
+    state_ptr->io_backlog[(state_ptr->io_backlog_start + state_ptr->io_backlog_count) & (capacity - 1)] = index;
+    state_ptr->io_backlog_count++;
+    if (submit)
+    {
+        submit_backlog();
+    }
+}
+
+// Claims a request slot and starts it. Reads are only queued in the backlog unless submit is set.
+static u32 queue_load(const char* name, resource_loader* l, resource_loaded_callback callback, void* user_data, b8 submit)
+{
+    u32 count = state_ptr->config.max_async_request_count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 index = (state_ptr->next_request + i) & (count - 1);
+        resource_request* request = &state_ptr->requests[index];
+        if (request->in_use)
+        {
+            continue;
+        }
+
+        state_ptr->next_request = index + 1;
+
+        string_ncopy(request->name, name, RESOURCE_REQUEST_NAME_MAX_LENGTH);
+        request->name[RESOURCE_REQUEST_NAME_MAX_LENGTH - 1] = 0;
+        request->loader = l;
+        request->callback = callback;
+        request->user_data = user_data;
+        hzero_memory(&request->result, sizeof(resource));
+        request->result.loader_id = INVALID_ID;
+        request->success = FALSE;
+        request->file_data = 0;
+        request->file_size = 0;
+        request->owns_file = FALSE;
+        request->cancelled = FALSE;
+        // Skips the generation that would make an id equal INVALID_ID.
+        request->generation = request->generation == 0xFFFE ? 0 : request->generation + 1;
+        request->in_use = TRUE;
+
+        start_request(request, submit);
+
+        return REQUEST_ID(index, request->generation);
+    }
+
+    HERROR("resource_system_load_async - %u loads are already pending, '%s' was not queued.", count, name);
+    return INVALID_ID;
+}
+
+u32 resource_system_load_async(const char* name, resource_type type, resource_loaded_callback callback, void* user_data)
+{
+    resource_loader* l = find_loader(type);
+    if (!l || !name || !callback)
+    {
+        HERROR("resource_system_load_async - No loader for type %d was found.", type);
+        return INVALID_ID;
+    }
+
+    return queue_load(name, l, callback, user_data, TRUE);
+}
+
+u32 resource_system_load_batch_async(u32 count, const char** names, resource_type type, resource_loaded_callback callback, void* user_data, u32* out_request_ids)
+{
+    resource_loader* l = find_loader(type);
+    if (!l || !names || !callback)
+    {
+        HERROR("resource_system_load_batch_async - No loader for type %d was found.", type);
+        return 0;
+    }
+
+    u32 queued = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 id = queue_load(names[i], l, callback, user_data, FALSE);
+        if (out_request_ids)
+        {
+            out_request_ids[i] = id;
+        }
+        queued += id != INVALID_ID;
+    }
+
+    // All reads at once, as many in flight as the queue depth allows.
+    if (state_ptr->io.internal)
+    {
+        submit_backlog();
+    }
+
+    return queued;
+}
+
+b8 resource_system_cancel(u32 request_id)
+{
+    if (!state_ptr || request_id == INVALID_ID) return FALSE;
+
+    u32 index = request_id & 0xFFFF;
+    if (index >= state_ptr->config.max_async_request_count) return FALSE;
+
+    resource_request* request = &state_ptr->requests[index];
+    if (!request->in_use || REQUEST_ID(index, request->generation) != request_id)
+    {
+        return FALSE;
+    }
+
+    atomic_store_u32(&request->cancelled, TRUE);
+    return TRUE;
+}
+
+void resource_system_cancel_all()
+{
+    if (!state_ptr) return;
+
+    u32 capacity = state_ptr->config.max_async_request_count;
+    for (u32 i = 0; i < capacity; ++i)
+    {
+        if (state_ptr->requests[i].in_use)
+        {
+            atomic_store_u32(&state_ptr->requests[i].cancelled, TRUE);
+        }
+    }
+
+    // Backlogged reads never started, so they complete right away.
+    while (state_ptr->io_backlog_count)
+    {
+        u32 index = state_ptr->io_backlog[state_ptr->io_backlog_start];
+        state_ptr->io_backlog_start = (state_ptr->io_backlog_start + 1) & (capacity - 1);
+        state_ptr->io_backlog_count--;
+        complete_request(&state_ptr->requests[index]);
+    }
+
+    // Reads and jobs in flight still finish, the dispatch frees what they loaded.
+    for (;;)
+    {
+        resource_system_dispatch_completed();
+
+        u32 pending = 0;
+        for (u32 i = 0; i < capacity; ++i)
+        {
+            pending += state_ptr->requests[i].in_use;
+        }
+        if (!pending) break;
+
+        if (!job_system_run_pending())
+        {
+            platform_thread_yield();
+        }
+    }
+}
+
+void resource_system_dispatch_completed()
+{
+    if (!state_ptr) return;
+
+    PROFILE_FUNCTION();
+
+    if (state_ptr->io.internal)
+    {
+        collect_reads();
+    }
+
+    // Nothing else would run the loads on a machine without job workers.
+    if (job_system_worker_count() == 0)
+    {
+        while (job_system_run_pending())
+        {
+        }
+    }
+
+    u32 index;
+    while (mpsc_queue_pop(&state_ptr->completed, &index))
+    {
+        resource_request* request = &state_ptr->requests[index];
+        if (request->cancelled)
+        {
+            if (request->success)
+            {
+                resource_system_unload(&request->result);
+            }
+        }
+        else
+        {
+            if (!request->success)
+            {
+                HERROR("Asynchronous load of '%s' failed.", request->name);
+            }
+            request->callback(request->success, &request->result, request->user_data);
+        }
+
+        request->in_use = FALSE;
+    }
+}
+
 const char* resource_system_base_path()
 {
     if (state_ptr)
@@ -176,4 +706,105 @@ b8 load(const char* name, resource_loader* loader, resource* out_resource)
 
     out_resource->loader_id = loader->id;
     return loader->load(loader, name, out_resource);
+}
+
+b8 resource_system_mount(const char* path)
+{
+    if (!state_ptr || !path) return FALSE;
+
+    u32 count = state_ptr->pack_count;
+    if (count == RESOURCE_SYSTEM_MAX_PACKS)
+    {
+        HERROR("resource_system_mount - %u archives are already mounted, '%s' was not.", RESOURCE_SYSTEM_MAX_PACKS, path);
+        return FALSE;
+    }
+
+    hpak* pak = &state_ptr->packs[count];
+    if (!hpak_open(path, pak))
+    {
+        HERROR("resource_system_mount - Failed to open archive '%s'.", path);
+        return FALSE;
+    }
+
+    atomic_store_u32(&state_ptr->pack_count, count + 1);
+
+    HINFO("Mounted archive '%s' with %u files.", path, pak->header->entry_count);
+    return TRUE;
+}
+
+// The name of the loader's file below the base path, as archives and the cook manifest store it.
+static void relative_path_of(const resource_loader* loader, const char* name, char* out_path)
+{
+    const char* type_path = loader->type_path ? loader->type_path : "";
+    string_format(out_path, "%s%s%s%s", type_path, type_path[0] ? "/" : "", name, loader->extension ? loader->extension : "");
+}
+
+b8 resource_system_find_packed(const resource_loader* loader, const char* name, const void** out_data, u64* out_size)
+{
+    if (!state_ptr || !loader || !name) return FALSE;
+
+    u32 count = atomic_load_u32(&state_ptr->pack_count);
+    if (count == 0) return FALSE;
+
+    char relative_path[RESOURCE_REQUEST_NAME_MAX_LENGTH];
+    relative_path_of(loader, name, relative_path);
+
+    for (u32 i = count; i-- > 0;)
+    {
+        const hpak* pak = &state_ptr->packs[i];
+        if (hpak_find(pak, relative_path, out_data, out_size))
+        {
+            // The loader reads it all right away, fetch it in one go rather than fault by fault.
+            filesystem_advise(&pak->view, (const u8*)*out_data - (const u8*)pak->view.data, *out_size, FILE_ACCESS_WILL_NEED);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+b8 resource_system_find_cooked(const resource_loader* loader, const char* name, char* out_path)
+{
+    if (!state_ptr || !loader || !name || !state_ptr->manifest.header) return FALSE;
+
+    char relative_path[RESOURCE_REQUEST_NAME_MAX_LENGTH];
+    relative_path_of(loader, name, relative_path);
+
+    const char* file;
+    if (!cook_manifest_find(&state_ptr->manifest, relative_path, &file))
+    {
+        return FALSE;
+    }
+
+    string_format(out_path, "%s%s", state_ptr->cooked_directory, file);
+    return TRUE;
+}
+
+// Types the cooker writes, and so the only ones a cook manifest can list.
+static b8 is_cooked_type(resource_type type)
+{
+    return type == RESOURCE_TYPE_COOKED_IMAGE;
+}
+
+b8 resource_system_exists(const char* name, resource_type type)
+{
+    resource_loader* l = find_loader(type);
+    if (!l) return FALSE;
+
+    const void* data;
+    u64 size;
+    char path[512];
+    if (resource_system_find_packed(l, name, &data, &size) || resource_system_find_cooked(l, name, path))
+    {
+        return TRUE;
+    }
+
+    // The manifest lists everything cooked, probing for loose cooked files would only cost a system call per name.
+    if (state_ptr->manifest.header && is_cooked_type(type))
+    {
+        return FALSE;
+    }
+
+    string_format(path, "%s/%s/%s%s", state_ptr->config.asset_base_path, l->type_path, name, l->extension);
+    return filesystem_exists(path);
 }
\ No newline at end of file
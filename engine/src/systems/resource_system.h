@@ -6,16 +6,39 @@ typedef struct resource_system_config
 {
     u32 max_loader_count;
     char* asset_base_path;
+    // Asynchronous loads in flight or awaiting delivery at once, must be a power of two.
+    u32 max_async_request_count;
+    // Archive mounted at startup if the file exists, may be 0.
+    const char* pack_path;
+    // File reads in flight for asynchronous loads, 0 reads them on job workers instead.
+    u32 io_queue_depth;
+    // Manifest of the cook cache opened at startup if the file exists, may be 0.
+    const char* cook_manifest_path;
 } resource_system_config;
 
+/**
+ * @brief Receives an asynchronously loaded resource on the main thread.
+ *
+ * @param success FALSE if loading failed, loaded is then not valid.
+ * @param loaded owned by the callback, which releases it with resource_system_unload. Its name is only valid during the call.
+ */
+typedef void (*resource_loaded_callback)(b8 success, resource* loaded, void* user_data);
+
 typedef struct resource_loader
 {
     u32 id;
     resource_type type;
     const char* custom_type;
     const char* type_path;
+    // Appended to names to find their file, "" for none.
+    const char* extension;
     b8 (*load)(struct resource_loader* self, const char* name, resource* out_resource);
     void (*unload)(struct resource_loader* self, resource* resource);
+    /**
+     * Optional. Builds the resource from the bytes of its file, which stay owned by the caller.
+     * Asynchronous loads through such a loader read the file with async I/O and only decode on a job worker.
+     */
+    b8 (*load_from_memory)(struct resource_loader* self, const char* name, const void* data, u64 size, resource* out_resource);
 } resource_loader;
 
 b8 resource_system_initialize(u64* memory_requirement, void* state, resource_system_config config);
@@ -28,4 +51,69 @@ HAPI b8 resource_system_load_custom(const char* name, const char* custom_type, r
 
 HAPI void resource_system_unload(resource* resource);
 
-HAPI const char* resource_system_base_path();
\ No newline at end of file
+/**
+ * @brief Loads many resources of one type at once, spread across the job system, and returns when all are done.
+ *
+ * @param out_resources receives a resource per name, each released with resource_system_unload if it loaded.
+ * @param out_loaded receives whether each name loaded.
+ * @return the number of resources loaded.
+ */
+HAPI u32 resource_system_load_batch(u32 count, const char** names, resource_type type, resource* out_resources, b8* out_loaded);
+
+/**
+ * @brief Loads a resource on a job worker. Must be called from the main thread. With io_queue_depth set, loaders
+ * providing load_from_memory have the file read through async I/O first and only decode on the worker.
+ *
+ * @param callback run from resource_system_dispatch_completed once the load finished or failed.
+ * @return an id for resource_system_cancel, or INVALID_ID if no loader exists or too many loads are pending.
+ */
+HAPI u32 resource_system_load_async(const char* name, resource_type type, resource_loaded_callback callback, void* user_data);
+
+/**
+ * @brief Queues asynchronous loads of many resources of one type, such as everything a level uses, so their
+ * files are read with as many requests in flight as async I/O allows rather than one after another.
+ *
+ * @param out_request_ids receives an id per name, INVALID_ID for those not queued. May be 0.
+ * @return the number of loads queued.
+ */
+HAPI u32 resource_system_load_batch_async(u32 count, const char** names, resource_type type, resource_loaded_callback callback, void* user_data, u32* out_request_ids);
+
+// Drops a pending asynchronous load. Its callback will not run, and a resource that already loaded is unloaded.
+HAPI b8 resource_system_cancel(u32 request_id);
+
+// Cancels every pending asynchronous load and waits until all of them are freed. Must run before the job system shuts down, which drops queued jobs.
+HAPI void resource_system_cancel_all();
+
+// Runs the callbacks of finished asynchronous loads, and the loads themselves without job workers. Called by the application once per frame, on the main thread.
+HAPI void resource_system_dispatch_completed();
+
+HAPI const char* resource_system_base_path();
+
+/**
+ * @brief Whether the loader of a type would find a file for the name, in a mounted archive, the cook cache or
+ * below the base path. With a cook manifest open the base path is not searched for cooked types, nothing touches the disk.
+ */
+HAPI b8 resource_system_exists(const char* name, resource_type type);
+
+/**
+ * @brief Mounts an .hpak archive. Its files take precedence over loose files and over archives mounted before it.
+ * Archives stay mounted until the system shuts down.
+ */
+HAPI b8 resource_system_mount(const char* path);
+
+/**
+ * @brief Looks up the file a loader would otherwise open below the base path, type_path/name + extension,
+ * in the mounted archives. Loaders fall back to loose files when it is not found.
+ *
+ * @param out_data receives a pointer into the mapped archive, valid until the system shuts down.
+ * @param out_size receives the size of the file in bytes.
+ */
+HAPI b8 resource_system_find_packed(const resource_loader* loader, const char* name, const void** out_data, u64* out_size);
+
+/**
+ * @brief Looks up the file a loader would otherwise open below the base path in the manifest of the cook cache.
+ * Loaders of cooked assets try it after the mounted archives and before loose files.
+ *
+ * @param out_path receives the path of the cached file, at least 512 bytes.
+ */
+HAPI b8 resource_system_find_cooked(const resource_loader* loader, const char* name, char* out_path);
\ No newline at end of file
@@ -1,7 +1,10 @@
+#define HLOG_CATEGORY LOG_CATEGORY_RESOURCE
+
 #include "texture_system.h"
 
 #include "core/logger.h"
 #include "core/hstring.h"
+#include "core/profiler.h"
 #include "memory/hmemory.h"
 #include "containers/hashtable.h"
 
@@ -15,14 +18,20 @@ typedef struct texture_system_state
     texture default_texture;
 
     texture* registered_textures;
+    // Asynchronous load of each slot's texture, INVALID_ID once it arrived.
+    u32* load_requests;
+    // Slots from here on have never been used, so acquiring only scans and initializes the ones below.
+    u32 used_slot_count;
 
     hashtable registered_texture_table;
 } texture_system_state;
 
+// Zeroed means not loaded, so the table needs no filling.
 typedef struct texture_reference
 {
     u64 reference_count;
-    u32 index;
+    // Index + 1 into registered_textures, 0 while the texture is not loaded.
+    u32 slot;
     b8 auto_release;
 } texture_reference;
 
@@ -30,8 +39,8 @@ static texture_system_state* state_ptr = 0;
 
 b8 create_default_textures(texture_system_state* state);
 void destroy_default_textures(texture_system_state* state);
-b8 load_texture(const char* texture_name, texture* t);
-void destroy_texture(texture* t);
+b8 load_texture(const char* texture_name, texture* t, u32 slot);
+void destroy_texture(texture* t, u32 slot);
 
 b8 texture_system_initialize(u64* memory_requirement, void* state, texture_system_config config)
 {
@@ -44,8 +53,9 @@ b8 texture_system_initialize(u64* memory_requirement, void* state, texture_syste
     u64 struct_requirement = sizeof(texture_system_state);
     u64 array_requirement = sizeof(texture) * config.max_texture_count;
     u64 hashtable_requirement = sizeof(texture_reference) * config.max_texture_count;
+    u64 requests_requirement = sizeof(u32) * config.max_texture_count;
 
-    *memory_requirement = struct_requirement + array_requirement + hashtable_requirement;
+    *memory_requirement = struct_requirement + array_requirement + hashtable_requirement + requests_requirement;
 
     if (!state)
     {
@@ -59,19 +69,12 @@ b8 texture_system_initialize(u64* memory_requirement, void* state, texture_syste
     state_ptr->registered_textures = array_block;
 
     void* hashtable_block = array_block + array_requirement;
-    hashtable_create(sizeof(texture_reference), config.max_texture_count, hashtable_block, FALSE, &state_ptr->registered_texture_table);
+    hashtable_create_zeroed(sizeof(texture_reference), config.max_texture_count, hashtable_block, FALSE, &state_ptr->registered_texture_table);
 
-    texture_reference invalid_ref;
-    invalid_ref.auto_release = FALSE;
-    invalid_ref.index = INVALID_ID;
-    invalid_ref.reference_count = 0;
-    hashtable_fill(&state_ptr->registered_texture_table, &invalid_ref);
+    // Set for each slot as it gets used.
+    state_ptr->load_requests = hashtable_block + hashtable_requirement;
 
-    u32 count = state_ptr->config.max_texture_count;
-    for (u32 i = 0; i < count; ++i)
-    {
-        state_ptr->registered_textures[i].handle = INVALID_ID;
-    }
+    state_ptr->used_slot_count = 0;
 
     create_default_textures(state_ptr);
 
@@ -82,12 +85,12 @@ void texture_system_shutdown(void* state)
 {
     if (!state_ptr) return;
 
-    for (u32 i = 0; i < state_ptr->config.max_texture_count; ++i)
+    for (u32 i = 0; i < state_ptr->used_slot_count; ++i)
     {
         texture* t = &state_ptr->registered_textures[i];
         if (t->handle != INVALID_ID)
         {
-            renderer_destroy_texture(t);
+            destroy_texture(t, i);
         }
     }
 
@@ -98,6 +101,8 @@ void texture_system_shutdown(void* state)
 
 texture* texture_system_acquire(const char* name, b8 auto_release)
 {
+    PROFILE_FUNCTION();
+
     if (strings_equali(name, DEFAULT_TEXTURE_NAME))
     {
         HWARN("texture_system_acquire called for default texture. Use texture_system_get_default_texture for texture 'default'.");
@@ -114,27 +119,35 @@ texture* texture_system_acquire(const char* name, b8 auto_release)
 
         ref.reference_count++;
         
-        if (ref.index == INVALID_ID)
+        if (ref.slot == 0)
         {
-            u32 count = state_ptr->config.max_texture_count;
+            u32 count = state_ptr->used_slot_count;
             texture* t = 0;
             for (u32 i = 0; i < count; ++i)
             {
                 if (state_ptr->registered_textures[i].handle == INVALID_ID)
                 {
-                    ref.index = i;
+                    ref.slot = i + 1;
                     t = &state_ptr->registered_textures[i];
                     break;
                 }
             }
 
-            if (!t || ref.index == INVALID_ID)
+            if (!t && state_ptr->used_slot_count < state_ptr->config.max_texture_count)
+            {
+                t = &state_ptr->registered_textures[state_ptr->used_slot_count++];
+                t->handle = INVALID_ID;
+                state_ptr->load_requests[state_ptr->used_slot_count - 1] = INVALID_ID;
+                ref.slot = state_ptr->used_slot_count;
+            }
+
+            if (!t)
             {
                 HFATAL("texture_system_acquire - Texture system cannot hold any more textures. Adjust configuration to allow more.");
                 return 0;
             }
 
-            if (!load_texture(name, t))
+            if (!load_texture(name, t, ref.slot - 1))
             {
                 HERROR("Failed to load texture '%s'.", name);
                 return 0;
@@ -148,7 +161,7 @@ texture* texture_system_acquire(const char* name, b8 auto_release)
         }
 
         hashtable_set(&state_ptr->registered_texture_table, name, &ref);
-        return &state_ptr->registered_textures[ref.index];
+        return &state_ptr->registered_textures[ref.slot - 1];
     }
 
     HERROR("texture_system_acquire failed to acquire texture '%s'.", name);
@@ -178,11 +191,11 @@ void texture_system_release(const char* name)
 
         if (ref.reference_count == 0 && ref.auto_release)
         {
-            texture* t = &state_ptr->registered_textures[ref.index];
+            texture* t = &state_ptr->registered_textures[ref.slot - 1];
 
-            destroy_texture(t);
+            destroy_texture(t, ref.slot - 1);
 
-            ref.index = INVALID_ID;
+            ref.slot = 0;
             ref.auto_release = FALSE;
             
             HTRACE("Released texture '%s'. Texture unloaded because reference count = 0 and auto_release = true", name_copy);
@@ -216,47 +229,64 @@ void create_texture(texture* t)
     hzero_memory(t, sizeof(texture));
 }
 
-b8 load_texture(const char* texture_name, texture* t)
+static void on_image_loaded(b8 success, resource* loaded, void* user_data)
 {
-    resource img_resource;
-    if (!resource_system_load(texture_name, RESOURCE_TYPE_IMAGE, &img_resource))
+    u32 slot = (u32)(u64)user_data;
+    texture* t = &state_ptr->registered_textures[slot];
+    state_ptr->load_requests[slot] = INVALID_ID;
+
+    if (!success)
     {
-        HERROR("Failed to load image resource for texture '%s'.", texture_name);
-        return FALSE;
+        // Keeps showing the default texture.
+        HERROR("Failed to load image resource for texture '%s'.", t->name);
+        return;
     }
 
-    image_resource_data* resource_data = img_resource.data;
+    image_resource_data* resource_data = loaded->data;
 
     texture temp_texture;
     temp_texture.width = resource_data->width;
     temp_texture.height = resource_data->height;
     temp_texture.channel_count = resource_data->channel_count;
+    temp_texture.mip_count = resource_data->mip_count;
 
-    u64 total_size = temp_texture.width * temp_texture.height * temp_texture.channel_count;
-
-    b32 has_transparency = FALSE;
-    for (u64 i = 0; i < total_size; ++i)
-    {
-        u8 a = resource_data->pixels[i + 3];
-        if (a < 255)
-        {
-            has_transparency = TRUE;
-            break;
-        }
-    }
-
-    string_ncopy(temp_texture.name, texture_name, TEXTURE_NAME_MAX_LENGTH);
+    string_ncopy(temp_texture.name, t->name, TEXTURE_NAME_MAX_LENGTH);
     temp_texture.handle = INVALID_ID;
-    temp_texture.has_transparency = has_transparency;
+    temp_texture.has_transparency = resource_data->has_transparency;
+    temp_texture.generation = t->generation == INVALID_ID ? 0 : t->generation + 1;
 
     renderer_create_texture(resource_data->pixels, &temp_texture);
 
     texture old = *t;
     *t = temp_texture;
 
-    renderer_destroy_texture(&old);
+    // The default texture's handle is only borrowed.
+    if (old.generation != INVALID_ID)
+    {
+        renderer_destroy_texture(&old);
+    }
 
-    resource_system_unload(&img_resource);
+    resource_system_unload(loaded);
+
+    HTRACE("Texture '%s' loaded.", t->name);
+}
+
+// Shows the default texture in the slot until the image has been decoded off the main thread.
+b8 load_texture(const char* texture_name, texture* t, u32 slot)
+{
+    // Cooked textures are uploaded straight from their file, the source image is only decoded when there is none.
+    resource_type type = resource_system_exists(texture_name, RESOURCE_TYPE_COOKED_IMAGE) ? RESOURCE_TYPE_COOKED_IMAGE : RESOURCE_TYPE_IMAGE;
+    u32 request = resource_system_load_async(texture_name, type, on_image_loaded, (void*)(u64)slot);
+    if (request == INVALID_ID)
+    {
+        HERROR("Failed to queue image resource for texture '%s'.", texture_name);
+        return FALSE;
+    }
+
+    *t = state_ptr->default_texture;
+    string_ncopy(t->name, texture_name, TEXTURE_NAME_MAX_LENGTH);
+    t->generation = INVALID_ID;
+    state_ptr->load_requests[slot] = request;
 
     return TRUE;
 }
@@ -302,6 +332,8 @@ b8 create_default_textures(texture_system_state* state)
     state->default_texture.height = tex_dimension;
     state->default_texture.channel_count = 4;
     state->default_texture.has_transparency = FALSE;
+    state->default_texture.mip_count = 1;
+    state->default_texture.generation = 0;
 
     renderer_create_texture(pixels, &state_ptr->default_texture);
 
@@ -312,13 +344,24 @@ void destroy_default_textures(texture_system_state* state)
 {
     if (state)
     {
-        destroy_texture(&state->default_texture);
+        destroy_texture(&state->default_texture, INVALID_ID);
     }
 }
 
-void destroy_texture(texture* t)
+// Slot is the texture's index in registered_textures, INVALID_ID for the default texture.
+void destroy_texture(texture* t, u32 slot)
 {
-    renderer_destroy_texture(t);
+    if (slot != INVALID_ID && state_ptr->load_requests[slot] != INVALID_ID)
+    {
+        resource_system_cancel(state_ptr->load_requests[slot]);
+        state_ptr->load_requests[slot] = INVALID_ID;
+    }
+
+    // A texture still waiting on its load shares the default texture's handle.
+    if (t->generation != INVALID_ID)
+    {
+        renderer_destroy_texture(t);
+    }
 
     hzero_memory(t->name, sizeof(char) * TEXTURE_NAME_MAX_LENGTH);
     hzero_memory(t, sizeof(texture));
@@ -9,6 +9,7 @@ typedef struct texture_system_config
 
 #define DEFAULT_TEXTURE_NAME "default"
 
+// state must be zeroed memory, the texture table starts out empty without being cleared.
 b8 texture_system_initialize(u64* memory_requirement, void* state, texture_system_config config);
 void texture_system_shutdown(void* state);
 
@@ -12,6 +12,11 @@ b8 create_program(program* out_program)
 
     out_program->app_config.name = "Hex Engine Sandbox";
 
+    out_program->app_config.render_thread = TRUE;
+
+    // Uncapped frames would keep a core busy for no visible gain.
+    out_program->app_config.target_frame_rate = 60;
+
     out_program->initialize = program_initialize;
     out_program->update = program_update;
     out_program->render = program_render;
@@ -5,6 +5,9 @@
 #include <core/logger.h>
 #include <core/input.h>
 #include <core/event.h>
+#include <core/frame_stats.h>
+#include <core/task_graph.h>
+#include <core/application.h>
 
 // HACK: this should not be available.
 #include <renderer/renderer_frontend.h>
@@ -39,6 +42,23 @@ void camera_pitch(program_state* state, f32 amount)
     state->camera_view_dirty = TRUE;
 }
 
+// Task resource for the camera's view matrix.
+#define SANDBOX_RESOURCE_CAMERA TASK_RESOURCE_USER
+
+// Runs on a worker after the program render. The view and its dirty flag live in the program state, and
+// the engine's render task only knows TASK_RESOURCE_PROGRAM, so that is what the camera has to write.
+static b8 camera_task(void* data)
+{
+    program_state* state = data;
+
+    recalculate_view_matrix(state);
+
+    // HACK: naughty naughty >;]
+    renderer_set_view(state->view);
+
+    return TRUE;
+}
+
 b8 program_initialize (struct program* program_inst)
 {
 
@@ -52,6 +72,16 @@ b8 program_initialize (struct program* program_inst)
 
     state->camera_view_dirty = TRUE;
 
+    // Warn about frames that would miss a 60Hz display.
+    frame_stats_set_budget(FRAME_PHASE_TOTAL, 1.0 / 60.0);
+
+    task_desc camera = {};
+    camera.name = "camera";
+    camera.entry = camera_task;
+    camera.data = state;
+    camera.writes = TASK_RESOURCE_PROGRAM | SANDBOX_RESOURCE_CAMERA | TASK_RESOURCE_RENDERER;
+    application_add_frame_task(&camera);
+
     return TRUE;
 }
 
@@ -69,12 +99,24 @@ b8 program_update (struct program* program_inst, f32 delta_time)
         HDEBUG("Total allocations: %llu (%llu this frame)", alloc_count, alloc_count - previous_alloc_count);
     }
 
+    if (input_is_key_up('F') && input_was_key_down('F'))
+    {
+        frame_stats_summary summary;
+        if (frame_stats_get_summary(FRAME_PHASE_TOTAL, &summary))
+        {
+            HDEBUG("Frame time avg %.2fms p99 %.2fms max %.2fms, %u of %u frames over budget.",
+                summary.average * 1000.0, summary.p99 * 1000.0, summary.max * 1000.0, summary.over_budget_count, summary.sample_count);
+        }
+
+        task_graph_log_critical_path(application_get_frame_graph());
+    }
+
     // TODO: Temporary
     if (input_is_key_up('T') && input_was_key_down('T'))
     {
         HDEBUG("Swapping textures.");
         event_context context = {};
-        event_post(EVENT_DEBUG0, program_inst, context);
+        event_enqueue(EVENT_DEBUG0, program_inst, context);
     }
     // TODO: End temporary
 
@@ -147,15 +189,10 @@ b8 program_update (struct program* program_inst, f32 delta_time)
         state->camera_view_dirty = TRUE;
     }
 
-    recalculate_view_matrix(state);
-
-    // HACK: naughty naughty >;]
-    renderer_set_view(state->view);
-
     return TRUE;
 }
 
-b8 program_render (struct program* program_inst, f32 delta_time)
+b8 program_render (struct program* program_inst, f32 delta_time, f32 interpolation_alpha)
 {
     return TRUE;
 }
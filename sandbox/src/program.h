@@ -17,6 +17,6 @@ b8 program_initialize (struct program* program_inst);
 
 b8 program_update (struct program* program_inst, f32 delta_time);
 
-b8 program_render (struct program* program_inst, f32 delta_time);
+b8 program_render (struct program* program_inst, f32 delta_time, f32 interpolation_alpha);
 
 void program_on_resize (struct program* program_inst, u32 width, u32 height);
\ No newline at end of file
@@ -53,6 +53,31 @@ u8 hashtable_should_set_and_get_successfully() {
     return TRUE;
 }
 
+u8 hashtable_created_zeroed_should_set_and_get() {
+    hashtable table;
+    u64 element_size = sizeof(u64);
+    u64 element_count = 3;
+    u64 memory[3] = {0};
+
+    hashtable_create_zeroed(element_size, element_count, memory, FALSE, &table);
+
+    expect_should_be(3, table.element_count);
+
+    u64 unset_value = 1;
+    hashtable_get(&table, "unset", &unset_value);
+    expect_should_be(0, unset_value);
+
+    u64 testval1 = 23;
+    hashtable_set(&table, "test1", &testval1);
+    u64 get_testval_1 = 0;
+    hashtable_get(&table, "test1", &get_testval_1);
+    expect_should_be(testval1, get_testval_1);
+
+    hashtable_destroy(&table);
+
+    return TRUE;
+}
+
 typedef struct ht_test_struct {
     b8 b_value;
     f32 f_value;
@@ -321,6 +346,7 @@ u8 hashtable_should_set_get_and_update_ptr_successfully() {
 void hashtable_register_tests() {
     test_manager_register_test(hashtable_should_create_and_destroy, "Hashtable should create and destroy");
     test_manager_register_test(hashtable_should_set_and_get_successfully, "Hashtable should set and get");
+    test_manager_register_test(hashtable_created_zeroed_should_set_and_get, "Hashtable created on zeroed memory should set and get");
     test_manager_register_test(hashtable_should_set_and_get_ptr_successfully, "Hashtable should set and get pointer");
     test_manager_register_test(hashtable_should_set_and_get_nonexistant, "Hashtable should set and get non-existent entry as nothing.");
     test_manager_register_test(hashtable_should_set_and_get_ptr_nonexistant, "Hashtable should set and get non-existent pointer entry as nothing.");
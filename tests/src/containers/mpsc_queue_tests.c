@@ -0,0 +1,108 @@
+#include "mpsc_queue_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <containers/mpsc_queue.h>
+
+typedef struct mpsc_test_element {
+    u32 id;
+    u16 value;
+} mpsc_test_element;
+
+u8 mpsc_queue_should_create_and_destroy() {
+    mpsc_queue queue;
+    u8 memory[1024];
+
+    expect_should_be(4 * (sizeof(u64) + 8), mpsc_queue_memory_requirement(sizeof(mpsc_test_element), 4));
+
+    b8 result = mpsc_queue_create(sizeof(mpsc_test_element), 4, memory, &queue);
+    expect_to_be_true(result);
+    expect_should_be(sizeof(mpsc_test_element), queue.element_size);
+    expect_should_be(3, queue.mask);
+
+    mpsc_queue_destroy(&queue);
+
+    expect_should_be(0, queue.memory);
+    expect_should_be(0, queue.element_size);
+
+    return TRUE;
+}
+
+u8 mpsc_queue_should_reject_non_power_of_two_capacity() {
+    mpsc_queue queue;
+    u8 memory[1024];
+
+    b8 result = mpsc_queue_create(sizeof(mpsc_test_element), 6, memory, &queue);
+    expect_to_be_false(result);
+
+    return TRUE;
+}
+
+u8 mpsc_queue_should_pop_in_push_order() {
+    mpsc_queue queue;
+    u8 memory[1024];
+    mpsc_queue_create(sizeof(mpsc_test_element), 8, memory, &queue);
+
+    for (u32 i = 0; i < 5; ++i) {
+        mpsc_test_element element = {i, (u16)(i * 10)};
+        b8 pushed = mpsc_queue_push(&queue, &element);
+        expect_to_be_true(pushed);
+    }
+
+    for (u32 i = 0; i < 5; ++i) {
+        mpsc_test_element element = {};
+        b8 popped = mpsc_queue_pop(&queue, &element);
+        expect_to_be_true(popped);
+        expect_should_be(i, element.id);
+        expect_should_be(i * 10, element.value);
+    }
+
+    mpsc_test_element element;
+    b8 popped = mpsc_queue_pop(&queue, &element);
+    expect_to_be_false(popped);
+
+    mpsc_queue_destroy(&queue);
+
+    return TRUE;
+}
+
+u8 mpsc_queue_should_report_full_and_wrap_around() {
+    mpsc_queue queue;
+    u8 memory[1024];
+    mpsc_queue_create(sizeof(mpsc_test_element), 4, memory, &queue);
+
+    u32 next_push = 0;
+    u32 next_pop = 0;
+
+    // Several laps around the ring, filling it completely each time.
+    for (u32 lap = 0; lap < 3; ++lap) {
+        for (u32 i = 0; i < 4; ++i) {
+            mpsc_test_element element = {next_push++, 0};
+            b8 pushed = mpsc_queue_push(&queue, &element);
+            expect_to_be_true(pushed);
+        }
+
+        mpsc_test_element overflow = {};
+        b8 pushed = mpsc_queue_push(&queue, &overflow);
+        expect_to_be_false(pushed);
+
+        for (u32 i = 0; i < 4; ++i) {
+            mpsc_test_element element = {};
+            b8 popped = mpsc_queue_pop(&queue, &element);
+            expect_to_be_true(popped);
+            expect_should_be(next_pop++, element.id);
+        }
+    }
+
+    mpsc_queue_destroy(&queue);
+
+    return TRUE;
+}
+
+void mpsc_queue_register_tests() {
+    test_manager_register_test(mpsc_queue_should_create_and_destroy, "MPSC queue should create and destroy");
+    test_manager_register_test(mpsc_queue_should_reject_non_power_of_two_capacity, "MPSC queue should reject a capacity that is not a power of two");
+    test_manager_register_test(mpsc_queue_should_pop_in_push_order, "MPSC queue should pop elements in push order");
+    test_manager_register_test(mpsc_queue_should_report_full_and_wrap_around, "MPSC queue should report full and wrap around");
+}
\ No newline at end of file
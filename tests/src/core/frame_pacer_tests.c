@@ -0,0 +1,97 @@
+#include "frame_pacer_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/frame_pacer.h>
+#include <platform/platform.h>
+#include <core/logger.h>
+
+u8 frame_pacer_should_not_wait_when_uncapped() {
+    frame_pacer pacer;
+    frame_pacer_create(0, &pacer);
+
+    f64 start = platform_get_absolute_time();
+    frame_pacer_wait(&pacer);
+    f64 elapsed = platform_get_absolute_time() - start;
+
+    expect_to_be_true(elapsed < 0.001);
+    expect_should_be(0, pacer.frame_count);
+
+    return TRUE;
+}
+
+#define PACER_TEST_FRAMES 200
+#define PACER_TEST_ATTEMPTS 5
+
+// Paces 250 frames per second and reports the wake statistics and the total time taken.
+static void run_paced_frames(frame_pacer_stats* out_stats, f64* out_elapsed)
+{
+    frame_pacer pacer;
+    frame_pacer_create(250, &pacer);
+
+    u64 start = platform_get_ticks_ns();
+    for (u32 i = 0; i < PACER_TEST_FRAMES; ++i) {
+        frame_pacer_wait(&pacer);
+    }
+    *out_elapsed = (platform_get_ticks_ns() - start) * 0.000000001;
+
+    frame_pacer_get_stats(&pacer, out_stats);
+}
+
+// Sleeps to the same deadlines without the pacer and counts the wakes a whole frame late. A bare
+// sleep oversleeps by far less than that, so those are the thread not being scheduled at all.
+static u32 count_stalled_sleeps()
+{
+    u64 frame_ns = 4000000ull;
+    u64 deadline = platform_get_ticks_ns();
+    u32 stalled = 0;
+    for (u32 i = 0; i < PACER_TEST_FRAMES; ++i) {
+        deadline += frame_ns;
+        platform_sleep_until_ns(deadline);
+        u64 now = platform_get_ticks_ns();
+        if (now >= deadline + frame_ns) {
+            stalled++;
+            deadline = now;
+        }
+    }
+    return stalled;
+}
+
+u8 frame_pacer_should_keep_p99_deviation_low() {
+    // A preempted run says nothing about the pacer, so it is retried. A run only counts as preempted
+    // when a bare sleep probe right after it stalls as well, a pacer that is late by itself still fails.
+    frame_pacer_stats stats;
+    f64 elapsed = 0;
+    b8 p99_within_budget = FALSE;
+    b8 every_attempt_stalled = TRUE;
+    for (u32 attempt = 0; attempt < PACER_TEST_ATTEMPTS && !p99_within_budget; ++attempt) {
+        run_paced_frames(&stats, &elapsed);
+        p99_within_budget = stats.p99_jitter < 0.001;
+        if (!p99_within_budget) {
+            // Enough stalls to reach the p99 on their own.
+            every_attempt_stalled = every_attempt_stalled && count_stalled_sleeps() > PACER_TEST_FRAMES / 100;
+        }
+    }
+
+    if (!p99_within_budget && every_attempt_stalled) {
+        HWARN("Plain sleeps stalled for whole frames after every paced run, the machine is too loaded to measure jitter. Skipping.");
+        return BYPASS;
+    }
+
+    expect_should_be(PACER_TEST_FRAMES, stats.frame_count);
+    expect_to_be_true(p99_within_budget);
+
+    // Absolute deadlines never finish early, and drift would add up over the frames. The upper
+    // bound leaves room for a scheduler hiccup without letting drift through.
+    f64 expected = PACER_TEST_FRAMES * 0.004;
+    b8 total_within_budget = elapsed > expected * 0.98 && elapsed < expected * 1.25;
+    expect_to_be_true(total_within_budget);
+
+    return TRUE;
+}
+
+void frame_pacer_register_tests() {
+    test_manager_register_test(frame_pacer_should_not_wait_when_uncapped, "Frame pacer should not wait when uncapped");
+    test_manager_register_test(frame_pacer_should_keep_p99_deviation_low, "Frame pacer should keep p99 wake deviation under 1ms");
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "frame_stats_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/frame_stats.h>
+
+static u64 frame_stats_test_memory[4096];
+
+u8 frame_stats_should_summarize_window() {
+    u64 memory_requirement = 0;
+    frame_stats_initialize(&memory_requirement, 0, 0);
+    b8 fits = memory_requirement <= sizeof(frame_stats_test_memory);
+    expect_to_be_true(fits);
+    frame_stats_initialize(&memory_requirement, frame_stats_test_memory, 0);
+
+    frame_stats_set_budget(FRAME_PHASE_TOTAL, 0.0505);
+
+    // Totals of 1ms to 100ms, with update taking a tenth of each.
+    for (u32 i = 1; i <= 100; ++i) {
+        frame_stats_add_phase_time(FRAME_PHASE_UPDATE, i * 0.0001);
+        frame_stats_end_frame(i * 0.001);
+    }
+
+    frame_stats_summary summary;
+    b8 result = frame_stats_get_summary(FRAME_PHASE_TOTAL, &summary);
+    expect_to_be_true(result);
+    expect_should_be(100, summary.sample_count);
+    expect_float_to_be(0.001, summary.min);
+    expect_float_to_be(0.1, summary.max);
+    expect_float_to_be(0.0505, summary.average);
+    expect_float_to_be(0.05, summary.p50);
+    expect_float_to_be(0.095, summary.p95);
+    expect_should_be(50, summary.over_budget_count);
+
+    // Under 2ms, under 4.167ms, ... the last bucket holds 100ms and up.
+    expect_should_be(1, summary.histogram[0]);
+    expect_should_be(3, summary.histogram[1]);
+    expect_should_be(1, summary.histogram[7]);
+
+    result = frame_stats_get_summary(FRAME_PHASE_UPDATE, &summary);
+    expect_to_be_true(result);
+    expect_float_to_be(0.01, summary.max);
+    expect_should_be(0, summary.over_budget_count);
+
+    frame_stats_shutdown(frame_stats_test_memory);
+
+    return TRUE;
+}
+
+u8 frame_stats_should_summarize_any_samples() {
+    // Unsorted, in whatever unit the caller keeps.
+    f64 samples[10] = {10, 3, 7, 1, 9, 5, 2, 8, 4, 6};
+    frame_stats_summary summary;
+    b8 result = frame_stats_summarize_samples(samples, 10, &summary);
+    expect_to_be_true(result);
+    expect_should_be(10, summary.sample_count);
+    expect_float_to_be(1.0, summary.min);
+    expect_float_to_be(10.0, summary.max);
+    expect_float_to_be(5.5, summary.average);
+    expect_float_to_be(5.0, summary.p50);
+    expect_float_to_be(9.0, summary.p95);
+    expect_float_to_be(9.0, summary.p99);
+    expect_should_be(0, summary.over_budget_count);
+
+    // Sorted in place.
+    expect_float_to_be(1.0, samples[0]);
+    expect_float_to_be(10.0, samples[9]);
+
+    result = frame_stats_summarize_samples(samples, 0, &summary);
+    expect_to_be_false(result);
+    expect_should_be(0, summary.sample_count);
+
+    return TRUE;
+}
+
+void frame_stats_register_tests() {
+    test_manager_register_test(frame_stats_should_summarize_window, "Frame stats should summarize the rolling window");
+    test_manager_register_test(frame_stats_should_summarize_any_samples, "Frame stats should summarize samples kept elsewhere");
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "input_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/input.h>
+#include <memory/hmemory.h>
+
+#define INPUT_TEST_START_NS 1000000000ull
+#define INPUT_TEST_MS_NS 1000000ull
+
+static u64 input_test_memory[2048];
+
+static b8 start_input() {
+    u64 memory_requirement = 0;
+    input_initialize(&memory_requirement, 0);
+    if (memory_requirement > sizeof(input_test_memory)) {
+        return FALSE;
+    }
+    hzero_memory(input_test_memory, sizeof(input_test_memory));
+    return input_initialize(&memory_requirement, input_test_memory);
+}
+
+u8 input_should_list_transitions_in_order() {
+    b8 started = start_input();
+    expect_to_be_true(started);
+
+    input_process_key(KEY_A, TRUE, INPUT_TEST_START_NS + 1);
+    input_process_mouse_move(10, 20, INPUT_TEST_START_NS + 2);
+    input_process_button(BUTTON_LEFT, TRUE, INPUT_TEST_START_NS + 3);
+    input_process_mouse_wheel(-1, INPUT_TEST_START_NS + 4);
+
+    u32 count = input_get_transition_count();
+    expect_should_be(4, count);
+
+    input_transition_type types[] = {INPUT_TRANSITION_KEY, INPUT_TRANSITION_MOUSE_MOVE, INPUT_TRANSITION_BUTTON, INPUT_TRANSITION_MOUSE_WHEEL};
+    for (u32 i = 0; i < count; ++i) {
+        input_transition t;
+        b8 found = input_get_transition(i, &t);
+        expect_to_be_true(found);
+        expect_should_be(types[i], t.type);
+        u64 timestamp = INPUT_TEST_START_NS + 1 + i;
+        expect_should_be(timestamp, t.timestamp);
+    }
+
+    input_transition t;
+    input_get_transition(0, &t);
+    expect_should_be(KEY_A, t.code);
+    input_get_transition(1, &t);
+    expect_should_be(10, t.x);
+    expect_should_be(20, t.y);
+    input_get_transition(3, &t);
+    expect_should_be(-1, t.wheel_delta);
+
+    b8 past_end = input_get_transition(count, &t);
+    expect_to_be_false(past_end);
+
+    // Submitting the frame starts an empty list for the next one.
+    input_frame_submitted(INPUT_TEST_START_NS + 5);
+    count = input_get_transition_count();
+    expect_should_be(0, count);
+
+    input_shutdown(input_test_memory);
+
+    return TRUE;
+}
+
+u8 input_should_keep_press_and_release_in_one_frame() {
+    b8 started = start_input();
+    expect_to_be_true(started);
+
+    input_process_key(KEY_T, TRUE, INPUT_TEST_START_NS);
+    input_process_key(KEY_T, FALSE, INPUT_TEST_START_NS + INPUT_TEST_MS_NS);
+    // Repeats of the current state are not transitions.
+    input_process_key(KEY_T, FALSE, INPUT_TEST_START_NS + 2 * INPUT_TEST_MS_NS);
+    input_update(0.016);
+
+    // The polled state only sees the key up, the transitions still hold both edges.
+    b8 down = input_is_key_down(KEY_T);
+    expect_to_be_false(down);
+
+    u32 count = input_get_transition_count();
+    expect_should_be(2, count);
+
+    input_transition press;
+    input_transition release;
+    input_get_transition(0, &press);
+    input_get_transition(1, &release);
+    expect_should_be(KEY_T, press.code);
+    expect_to_be_true(press.pressed);
+    expect_should_be(KEY_T, release.code);
+    expect_to_be_false(release.pressed);
+
+    input_frame_submitted(INPUT_TEST_START_NS + 3 * INPUT_TEST_MS_NS);
+    input_shutdown(input_test_memory);
+
+    return TRUE;
+}
+
+u8 input_should_keep_the_newest_transitions_on_overflow() {
+    b8 started = start_input();
+    expect_to_be_true(started);
+
+    u32 total = INPUT_TRANSITION_CAPACITY + 10;
+    for (u32 i = 0; i < total; ++i) {
+        input_process_mouse_move((i16)(i + 1), 0, INPUT_TEST_START_NS + i);
+    }
+
+    u32 count = input_get_transition_count();
+    expect_should_be(INPUT_TRANSITION_CAPACITY, count);
+
+    // The oldest ten were overwritten.
+    input_transition first;
+    input_transition last;
+    input_get_transition(0, &first);
+    input_get_transition(count - 1, &last);
+    expect_should_be(11, first.x);
+    expect_should_be(total, last.x);
+
+    // Previous state still catches up with everything, including what was overwritten.
+    input_update(0.016);
+    i32 x = 0;
+    i32 y = 0;
+    input_get_previous_mouse_position(&x, &y);
+    expect_should_be(total, x);
+
+    input_frame_submitted(INPUT_TEST_START_NS + total);
+    count = input_get_transition_count();
+    expect_should_be(0, count);
+
+    input_shutdown(input_test_memory);
+
+    return TRUE;
+}
+
+// One frame of a fixed timestep loop: input arrives, update_count fixed updates run, the frame is submitted.
+// Returns how many of those updates saw T released.
+static u32 run_fixed_frame(i32 key_change, u32 update_count, u64* time_ns) {
+    if (key_change >= 0) {
+        input_process_key(KEY_T, (b8)key_change, *time_ns);
+    }
+
+    u32 releases = 0;
+    for (u32 i = 0; i < update_count; ++i) {
+        if (input_is_key_up(KEY_T) && input_was_key_down(KEY_T)) {
+            releases++;
+        }
+        input_update(0.01);
+    }
+
+    *time_ns += 16 * INPUT_TEST_MS_NS;
+    input_frame_submitted(*time_ns);
+    return releases;
+}
+
+u8 input_should_fire_edges_once_across_frames_without_updates() {
+    b8 started = start_input();
+    expect_to_be_true(started);
+
+    u64 time_ns = INPUT_TEST_START_NS;
+
+    // Pressed in a frame too short for a fixed update, then held.
+    u32 releases = run_fixed_frame(TRUE, 0, &time_ns);
+    releases += run_fixed_frame(-1, 1, &time_ns);
+    b8 was_down = input_was_key_down(KEY_T);
+    expect_to_be_true(was_down);
+
+    // Released in another frame without an update, the next updates see the release exactly once.
+    releases += run_fixed_frame(FALSE, 0, &time_ns);
+    expect_should_be(0, releases);
+    releases += run_fixed_frame(-1, 2, &time_ns);
+    releases += run_fixed_frame(-1, 1, &time_ns);
+    releases += run_fixed_frame(-1, 1, &time_ns);
+    expect_should_be(1, releases);
+
+    b8 was_up = input_was_key_up(KEY_T);
+    expect_to_be_true(was_up);
+
+    input_shutdown(input_test_memory);
+
+    return TRUE;
+}
+
+u8 input_should_measure_latency_to_frame_submission() {
+    b8 started = start_input();
+    expect_to_be_true(started);
+
+    // Two transitions, 40ms and 30ms before the frame is submitted.
+    input_process_key(KEY_W, TRUE, INPUT_TEST_START_NS);
+    input_process_key(KEY_S, TRUE, INPUT_TEST_START_NS + 10 * INPUT_TEST_MS_NS);
+    input_frame_submitted(INPUT_TEST_START_NS + 40 * INPUT_TEST_MS_NS);
+
+    input_latency_stats stats;
+    input_get_latency_stats(&stats);
+    expect_should_be(2, stats.sample_count);
+    expect_float_to_be(0.04, stats.last_frame_latency);
+    expect_float_to_be(0.04, stats.max_latency);
+    expect_float_to_be(0.035, stats.average_latency);
+
+    // A frame without input leaves the stats alone.
+    input_frame_submitted(INPUT_TEST_START_NS + 60 * INPUT_TEST_MS_NS);
+    input_get_latency_stats(&stats);
+    expect_should_be(2, stats.sample_count);
+    expect_float_to_be(0.04, stats.last_frame_latency);
+
+    input_process_key(KEY_W, FALSE, INPUT_TEST_START_NS + 100 * INPUT_TEST_MS_NS);
+    input_frame_submitted(INPUT_TEST_START_NS + 200 * INPUT_TEST_MS_NS);
+    input_get_latency_stats(&stats);
+    expect_should_be(3, stats.sample_count);
+    expect_float_to_be(0.1, stats.last_frame_latency);
+    expect_float_to_be(0.1, stats.max_latency);
+    expect_float_to_be(0.056667, stats.average_latency);
+
+    input_shutdown(input_test_memory);
+
+    return TRUE;
+}
+
+void input_register_tests() {
+    test_manager_register_test(input_should_list_transitions_in_order, "Input transitions should be listed in the order they arrived");
+    test_manager_register_test(input_should_keep_press_and_release_in_one_frame, "Input transitions should keep a press and release within one frame");
+    test_manager_register_test(input_should_keep_the_newest_transitions_on_overflow, "Input transitions should keep the newest on overflow");
+    test_manager_register_test(input_should_fire_edges_once_across_frames_without_updates, "Input edges should fire once when a frame runs no fixed update");
+    test_manager_register_test(input_should_measure_latency_to_frame_submission, "Input latency should be measured to frame submission");
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "profiler_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/logger.h>
+#include <core/profiler.h>
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define PROFILER_TEST_TRACE_PATH "profiler_tests_trace.json"
+
+#define PROFILER_TEST_ZONE_COUNT 20000
+#define PROFILER_TEST_RUNS 9
+
+// Budget for the profiler's own bookkeeping, on top of the two timer reads every zone makes.
+#if _DEBUG
+#define PROFILER_TEST_BUDGET_NS 50.0
+#else
+#define PROFILER_TEST_BUDGET_NS 25.0
+#endif
+
+static u64 profiler_test_memory[1024];
+
+// Keeps the bare timer reads from being optimized out.
+static volatile u64 profiler_test_sink;
+
+static b8 profiler_test_initialize() {
+    u64 memory_requirement = 0;
+    profiler_initialize(&memory_requirement, 0);
+    if (memory_requirement > sizeof(profiler_test_memory)) {
+        return FALSE;
+    }
+    return profiler_initialize(&memory_requirement, profiler_test_memory);
+}
+
+u8 profiler_should_export_nested_zones() {
+    b8 initialized = profiler_test_initialize();
+    expect_to_be_true(initialized);
+
+    u32 outer = profiler_zone_begin("outer");
+    u32 inner = profiler_zone_begin("inner \"quoted\"");
+    profiler_zone_end(inner);
+    profiler_zone_end(outer);
+    profiler_frame_mark();
+
+    b8 exported = profiler_export_chrome_trace(PROFILER_TEST_TRACE_PATH);
+    profiler_shutdown(profiler_test_memory);
+    expect_to_be_true(exported);
+
+    file_handle f;
+    b8 opened = filesystem_open(PROFILER_TEST_TRACE_PATH, FILE_MODE_READ, FALSE, &f);
+    expect_to_be_true(opened);
+
+    char text[4096] = {};
+    u64 read = 0;
+    filesystem_read(&f, sizeof(text) - 1, text, &read);
+    filesystem_close(&f);
+    remove(PROFILER_TEST_TRACE_PATH);
+
+    b8 has_outer = strstr(text, "\"name\":\"outer\"") != 0;
+    b8 has_inner = strstr(text, "\"name\":\"inner \\\"quoted\\\"\"") != 0;
+    b8 has_frame = strstr(text, "\"name\":\"Frame 0\"") != 0;
+    expect_to_be_true(has_outer);
+    expect_to_be_true(has_inner);
+    expect_to_be_true(has_frame);
+
+    return TRUE;
+}
+
+static f64 ns_per_iteration(b8 zones) {
+    u64 start = platform_get_ticks_ns();
+    for (u32 i = 0; i < PROFILER_TEST_ZONE_COUNT; ++i) {
+        if (zones) {
+            u32 zone = profiler_zone_begin("overhead");
+            profiler_zone_end(zone);
+        } else {
+            profiler_test_sink = platform_get_ticks_ns();
+            profiler_test_sink = platform_get_ticks_ns();
+        }
+    }
+    return (f64)(platform_get_ticks_ns() - start) / PROFILER_TEST_ZONE_COUNT;
+}
+
+u8 profiler_zone_overhead_should_be_small() {
+    b8 initialized = profiler_test_initialize();
+    expect_to_be_true(initialized);
+
+    // Interleaved and the fastest run of each kept, so a preempted run does not count against the profiler.
+    f64 per_zone_ns = 0;
+    f64 timer_pair_ns = 0;
+    for (u32 run = 0; run < PROFILER_TEST_RUNS; ++run) {
+        f64 zone_run = ns_per_iteration(TRUE);
+        f64 timer_run = ns_per_iteration(FALSE);
+        if (run == 0 || zone_run < per_zone_ns) per_zone_ns = zone_run;
+        if (run == 0 || timer_run < timer_pair_ns) timer_pair_ns = timer_run;
+    }
+    profiler_shutdown(profiler_test_memory);
+
+    HDEBUG("Profiler zone overhead: %.1fns, %.1fns of it reading the clock.", per_zone_ns, timer_pair_ns);
+
+    // The clock cost belongs to the host, on a vDSO or TSC timer the whole zone lands near 50ns.
+    b8 within_budget = per_zone_ns < timer_pair_ns + PROFILER_TEST_BUDGET_NS;
+    expect_to_be_true(within_budget);
+
+    return TRUE;
+}
+
+void profiler_register_tests() {
+    test_manager_register_test(profiler_should_export_nested_zones, "Profiler should export nested zones as a Chrome trace");
+    test_manager_register_test(profiler_zone_overhead_should_be_small, "Profiler zone overhead should be small");
+}
\ No newline at end of file
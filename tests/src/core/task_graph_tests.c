@@ -0,0 +1,178 @@
+#include "task_graph_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/atomic.h>
+#include <core/task_graph.h>
+#include <memory/hmemory.h>
+#include <platform/platform.h>
+#include <systems/job_system.h>
+
+#define RESOURCE_A TASK_RESOURCE_USER
+#define RESOURCE_B (TASK_RESOURCE_USER << 1)
+
+typedef struct test_task
+{
+    volatile u32* sequence;
+    u32 order;
+    u32 sleep_ms;
+    b8 result;
+    b8 ran_on_main;
+} test_task;
+
+static HTHREADLOCAL b8 is_test_main_thread;
+
+static b8 record_task(void* data)
+{
+    test_task* task = data;
+    if (task->sleep_ms)
+    {
+        platform_sleep(task->sleep_ms);
+    }
+    task->order = atomic_fetch_add_u32(task->sequence, 1);
+    task->ran_on_main = is_test_main_thread;
+    return task->result;
+}
+
+static u32 add_task(task_graph* graph, const char* name, test_task* task, u64 reads, u64 writes, b8 main_thread)
+{
+    task_desc desc = {};
+    desc.name = name;
+    desc.entry = record_task;
+    desc.data = task;
+    desc.reads = reads;
+    desc.writes = writes;
+    desc.main_thread = main_thread;
+    return task_graph_add(graph, &desc);
+}
+
+static void* start_job_system(u64* out_size)
+{
+    job_system_config config;
+    config.worker_count = 2;
+    job_system_initialize(out_size, 0, config);
+    void* state = hallocate(*out_size, MEMORY_TAG_APPLICATION);
+    job_system_initialize(out_size, state, config);
+    return state;
+}
+
+u8 task_graph_should_order_conflicting_tasks() {
+    u64 job_size = 0;
+    void* job_state = start_job_system(&job_size);
+    is_test_main_thread = TRUE;
+
+    task_graph* graph = hallocate(sizeof(task_graph), MEMORY_TAG_APPLICATION);
+    b8 created = task_graph_create(graph);
+    expect_to_be_true(created);
+
+    volatile u32 sequence = 0;
+    test_task tasks[4] = {};
+    for (u32 i = 0; i < 4; ++i)
+    {
+        tasks[i].sequence = &sequence;
+        tasks[i].result = TRUE;
+    }
+
+    // writer -> two readers -> writer, the readers independent of each other.
+    add_task(graph, "write_a", &tasks[0], 0, RESOURCE_A, FALSE);
+    add_task(graph, "read_a_0", &tasks[1], RESOURCE_A, 0, FALSE);
+    add_task(graph, "read_a_1", &tasks[2], RESOURCE_A, RESOURCE_B, TRUE);
+    add_task(graph, "write_a_again", &tasks[3], 0, RESOURCE_A, FALSE);
+
+    b8 result = task_graph_execute(graph);
+    expect_to_be_true(result);
+
+    expect_should_be(4, sequence);
+    expect_to_be_true(tasks[0].order < tasks[1].order);
+    expect_to_be_true(tasks[0].order < tasks[2].order);
+    expect_to_be_true(tasks[1].order < tasks[3].order);
+    expect_to_be_true(tasks[2].order < tasks[3].order);
+    expect_to_be_true(tasks[2].ran_on_main);
+
+    // The readers share no edge, and the first writer only links directly to them.
+    u64 reader_link = graph->tasks[2].predecessors & (1ull << 1);
+    u64 writer_successors = graph->tasks[0].successors;
+    u64 both_readers = (1ull << 1) | (1ull << 2);
+    expect_should_be(0, reader_link);
+    expect_should_be(both_readers, writer_successors);
+
+    task_graph_destroy(graph);
+    hfree(graph, sizeof(task_graph), MEMORY_TAG_APPLICATION);
+    job_system_shutdown(job_state);
+    hfree(job_state, job_size, MEMORY_TAG_APPLICATION);
+    is_test_main_thread = FALSE;
+
+    return TRUE;
+}
+
+u8 task_graph_should_find_critical_path() {
+    u64 job_size = 0;
+    void* job_state = start_job_system(&job_size);
+
+    task_graph* graph = hallocate(sizeof(task_graph), MEMORY_TAG_APPLICATION);
+    task_graph_create(graph);
+
+    volatile u32 sequence = 0;
+    test_task tasks[3] = {};
+    for (u32 i = 0; i < 3; ++i)
+    {
+        tasks[i].sequence = &sequence;
+        tasks[i].result = TRUE;
+    }
+    tasks[0].sleep_ms = 4;
+    tasks[1].sleep_ms = 1;
+    tasks[2].sleep_ms = 4;
+
+    add_task(graph, "long_0", &tasks[0], 0, RESOURCE_A, FALSE);
+    add_task(graph, "short", &tasks[1], 0, RESOURCE_B, FALSE);
+    add_task(graph, "long_1", &tasks[2], RESOURCE_A, 0, FALSE);
+
+    task_graph_execute(graph);
+
+    u32 path[TASK_GRAPH_MAX_TASKS];
+    u32 path_count = 0;
+    u64 path_ns = task_graph_critical_path(graph, path, &path_count);
+
+    expect_should_be(2, path_count);
+    expect_should_be(0, path[0]);
+    expect_should_be(2, path[1]);
+    expect_to_be_true(path_ns >= 8000000);
+
+    task_graph_destroy(graph);
+    hfree(graph, sizeof(task_graph), MEMORY_TAG_APPLICATION);
+    job_system_shutdown(job_state);
+    hfree(job_state, job_size, MEMORY_TAG_APPLICATION);
+
+    return TRUE;
+}
+
+u8 task_graph_should_skip_tasks_after_failure() {
+    task_graph* graph = hallocate(sizeof(task_graph), MEMORY_TAG_APPLICATION);
+    task_graph_create(graph);
+
+    volatile u32 sequence = 0;
+    test_task tasks[2] = {};
+    tasks[0].sequence = &sequence;
+    tasks[1].sequence = &sequence;
+    tasks[1].result = TRUE;
+
+    // Without a job system the worker tasks run inline.
+    add_task(graph, "fails", &tasks[0], 0, RESOURCE_A, FALSE);
+    add_task(graph, "skipped", &tasks[1], RESOURCE_A, 0, FALSE);
+
+    b8 result = task_graph_execute(graph);
+    expect_to_be_false(result);
+    expect_should_be(1, sequence);
+
+    task_graph_destroy(graph);
+    hfree(graph, sizeof(task_graph), MEMORY_TAG_APPLICATION);
+
+    return TRUE;
+}
+
+void task_graph_register_tests() {
+    test_manager_register_test(task_graph_should_order_conflicting_tasks, "Task graph should order conflicting tasks.");
+    test_manager_register_test(task_graph_should_find_critical_path, "Task graph should find the critical path.");
+    test_manager_register_test(task_graph_should_skip_tasks_after_failure, "Task graph should skip tasks after a failure.");
+}
\ No newline at end of file
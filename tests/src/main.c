@@ -2,6 +2,22 @@
 
 #include "memory/linear_allocator_tests.h"
 #include "containers/hashtable_tests.h"
+#include "containers/mpsc_queue_tests.h"
+#include "core/frame_pacer_tests.h"
+#include "core/profiler_tests.h"
+#include "core/frame_stats_tests.h"
+#include "core/input_tests.h"
+#include "core/task_graph_tests.h"
+#include "systems/job_system_tests.h"
+#include "systems/resource_system_tests.h"
+#include "resources/hpak_tests.h"
+#include "resources/htex_tests.h"
+#include "resources/cook_manifest_tests.h"
+#include "resources/material_loader_tests.h"
+#include "platform/filesystem_tests.h"
+#include "platform/async_io_tests.h"
+#include "renderer/render_thread_tests.h"
+#include "renderer/null_backend_tests.h"
 
 #include <core/logger.h>
 
@@ -12,6 +28,22 @@ int main()
     // Register all tests...
     linear_allocator_register_tests();
     hashtable_register_tests();
+    mpsc_queue_register_tests();
+    frame_pacer_register_tests();
+    profiler_register_tests();
+    frame_stats_register_tests();
+    input_register_tests();
+    task_graph_register_tests();
+    job_system_register_tests();
+    resource_system_register_tests();
+    hpak_register_tests();
+    htex_register_tests();
+    cook_manifest_register_tests();
+    material_loader_register_tests();
+    filesystem_register_tests();
+    async_io_register_tests();
+    render_thread_register_tests();
+    null_backend_register_tests();
 
     HDEBUG("Starting tests...");
 
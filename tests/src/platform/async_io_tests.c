@@ -0,0 +1,123 @@
+#include "async_io_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/hstring.h>
+#include <memory/hmemory.h>
+#include <platform/filesystem.h>
+#include <platform/async_io.h>
+
+#include <stdio.h>
+
+#define TEST_FILE_COUNT 40
+#define TEST_QUEUE_DEPTH 8
+
+// Reads more files than the queue holds, one of them missing, and checks every byte.
+static u8 read_files(b8 force_threads)
+{
+    char paths[TEST_FILE_COUNT][32];
+    async_io_read reads[TEST_FILE_COUNT];
+    async_io_read* queue[TEST_FILE_COUNT];
+    u8 buffer[4096];
+    b8 files_written = TRUE;
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        string_format(paths[i], "async_io_test_%u.bin", i);
+        reads[i].path = paths[i];
+        reads[i].user_data = (void*)(u64)i;
+        queue[i] = &reads[i];
+
+        // The last file is never written.
+        if (i == TEST_FILE_COUNT - 1) continue;
+
+        // Sizes from empty up to several pages.
+        u64 size = (i * 1031) % sizeof(buffer);
+        for (u64 b = 0; b < size; ++b)
+        {
+            buffer[b] = (u8)(b + i);
+        }
+
+        file_handle file;
+        u64 written = 0;
+        files_written = files_written && filesystem_open(paths[i], FILE_MODE_WRITE, TRUE, &file);
+        files_written = files_written && (size == 0 || filesystem_write(&file, size, buffer, &written));
+        filesystem_close(&file);
+    }
+
+    async_io_config config = {0};
+    config.queue_depth = TEST_QUEUE_DEPTH;
+    config.force_threads = force_threads;
+    async_io io;
+    b8 created = async_io_create(config, &io);
+    b8 expected_backend = force_threads ? io.backend == ASYNC_IO_BACKEND_THREADS : TRUE;
+
+    u32 submitted = 0;
+    u32 completed = 0;
+    u32 correct = 0;
+    u32 max_in_flight = 0;
+    while (created && completed < TEST_FILE_COUNT)
+    {
+        submitted += async_io_submit(&io, TEST_FILE_COUNT - submitted, queue + submitted);
+        max_in_flight = io.in_flight > max_in_flight ? io.in_flight : max_in_flight;
+
+        async_io_read* done[TEST_QUEUE_DEPTH];
+        u32 count = async_io_poll(&io, TRUE, TEST_QUEUE_DEPTH, done);
+        for (u32 i = 0; i < count; ++i)
+        {
+            u32 index = (u32)(u64)done[i]->user_data;
+            b8 ok;
+            if (index == TEST_FILE_COUNT - 1)
+            {
+                ok = !done[i]->success && done[i]->data == 0;
+            }
+            else
+            {
+                u64 size = (index * 1031) % sizeof(buffer);
+                ok = done[i]->success && done[i]->size == size;
+                for (u64 b = 0; ok && b < size; ++b)
+                {
+                    ok = done[i]->data[b] == (u8)(b + index);
+                }
+            }
+            correct += ok;
+
+            if (done[i]->data)
+            {
+                hfree(done[i]->data, done[i]->size, MEMORY_TAG_ARRAY);
+            }
+        }
+        completed += count;
+    }
+
+    if (created)
+    {
+        async_io_destroy(&io);
+    }
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        remove(paths[i]);
+    }
+
+    expect_to_be_true(files_written);
+    expect_to_be_true(created);
+    expect_to_be_true(expected_backend);
+    expect_should_be(TEST_FILE_COUNT, completed);
+    expect_should_be(TEST_FILE_COUNT, correct);
+    expect_should_be(TEST_QUEUE_DEPTH, max_in_flight);
+
+    return TRUE;
+}
+
+u8 async_io_should_read_every_file() {
+    return read_files(FALSE);
+}
+
+u8 async_io_threads_should_read_every_file() {
+    return read_files(TRUE);
+}
+
+void async_io_register_tests() {
+    test_manager_register_test(async_io_should_read_every_file, "Async I/O should read every file.");
+    test_manager_register_test(async_io_threads_should_read_every_file, "Async I/O threads should read every file.");
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "filesystem_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/hstring.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FILE_NAME "filesystem_map_test.bin"
+#define TEST_EMPTY_FILE_NAME "filesystem_map_empty.bin"
+
+u8 filesystem_map_should_view_file_contents() {
+    u8 contents[8192];
+    for (u32 i = 0; i < sizeof(contents); ++i)
+    {
+        contents[i] = (u8)(i * 7);
+    }
+
+    file_handle file;
+    u64 written = 0;
+    b8 created = filesystem_open(TEST_FILE_NAME, FILE_MODE_WRITE, TRUE, &file);
+    created = created && filesystem_write(&file, sizeof(contents), contents, &written);
+    filesystem_close(&file);
+    b8 empty_created = filesystem_open(TEST_EMPTY_FILE_NAME, FILE_MODE_WRITE, TRUE, &file);
+    filesystem_close(&file);
+
+    file_view view;
+    b8 mapped = filesystem_map(TEST_FILE_NAME, &view);
+    u64 size = view.size;
+    b8 matches = mapped && size == sizeof(contents) && memcmp(view.data, contents, sizeof(contents)) == 0;
+    // Hints on any range, unaligned or past the end, are harmless.
+    filesystem_advise(&view, 100, 1 << 20, FILE_ACCESS_RANDOM | FILE_ACCESS_WILL_NEED);
+    filesystem_unmap(&view);
+    b8 unmapped = view.data == 0 && view.size == 0;
+
+    file_view empty;
+    b8 empty_mapped = filesystem_map(TEST_EMPTY_FILE_NAME, &empty);
+    b8 empty_has_data = empty.data != 0 || empty.size != 0;
+    filesystem_unmap(&empty);
+
+    remove(TEST_FILE_NAME);
+    remove(TEST_EMPTY_FILE_NAME);
+
+    expect_to_be_true(created);
+    expect_to_be_true(empty_created);
+    expect_to_be_true(mapped);
+    expect_should_be(sizeof(contents), size);
+    expect_to_be_true(matches);
+    expect_to_be_true(unmapped);
+    expect_to_be_true(empty_mapped);
+    expect_to_be_false(empty_has_data);
+
+    return TRUE;
+}
+
+void filesystem_register_tests() {
+    test_manager_register_test(filesystem_map_should_view_file_contents, "Filesystem map should view the file contents.");
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "null_backend_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <memory/hmemory.h>
+#include <program_types.h>
+#include <renderer/renderer_frontend.h>
+#include <renderer/null/null_backend.h>
+
+#include <stdio.h>
+
+#define TEST_FRAME_COUNT 3
+#define TEST_DRAWS_PER_FRAME 4
+#define TEST_BENCHMARK_FRAMES 5
+
+u8 null_backend_should_count_draws_and_uploads() {
+    u64 size = 0;
+    renderer_initialize(&size, 0, 0, 0, FALSE);
+    void* state = hallocate(size, MEMORY_TAG_RENDERER);
+    b8 initialized = renderer_initialize(&size, state, "null backend test", RENDERER_BACKEND_NULL, FALSE);
+    expect_to_be_true(initialized);
+
+    // A 4x4 texture with two more mip levels: 64 + 16 + 4 bytes.
+    u8 pixels[84] = {0};
+    texture t = {0};
+    t.width = 4;
+    t.height = 4;
+    t.channel_count = 4;
+    t.mip_count = 3;
+    renderer_create_texture(pixels, &t);
+
+    vertex_3d vertices[3] = {0};
+    u32 indices[3] = {0, 1, 2};
+    geometry g = {0};
+    g.internal_id = INVALID_ID;
+    b8 created = renderer_create_geometry(&g, 3, vertices, 3, indices);
+
+    geometry_render_data draws[TEST_DRAWS_PER_FRAME];
+    for (u32 i = 0; i < TEST_DRAWS_PER_FRAME; ++i)
+    {
+        draws[i].model = mat4_identity();
+        draws[i].geometry = &g;
+    }
+
+    render_packet packet;
+    packet.delta_time = 1.0f / 60.0f;
+    packet.geometry_count = TEST_DRAWS_PER_FRAME;
+    packet.geometries = draws;
+
+    b8 all_drawn = TRUE;
+    for (u32 i = 0; i < TEST_FRAME_COUNT; ++i)
+    {
+        all_drawn = renderer_draw_frame(&packet) && all_drawn;
+    }
+
+    renderer_destroy_texture(&t);
+    renderer_destroy_geometry(&g);
+
+    null_backend_stats stats;
+    null_backend_get_stats(&stats);
+
+    renderer_shutdown(state);
+    hfree(state, size, MEMORY_TAG_RENDERER);
+
+    expect_to_be_true(created);
+    expect_to_be_true(all_drawn);
+    expect_should_be(TEST_FRAME_COUNT, stats.frames);
+    expect_should_be(TEST_FRAME_COUNT * TEST_DRAWS_PER_FRAME, stats.draws);
+    expect_should_be(1, stats.textures_created);
+    expect_should_be(1, stats.textures_destroyed);
+    expect_should_be(1, stats.geometries_created);
+    expect_should_be(1, stats.geometries_destroyed);
+    u64 expected_bytes = 84 + 3 * sizeof(vertex_3d) + 3 * sizeof(u32);
+    expect_should_be(expected_bytes, stats.bytes_uploaded);
+
+    return TRUE;
+}
+
+static b8 benchmark_program_initialize(program* program_inst) {
+    return TRUE;
+}
+
+static b8 benchmark_program_update(program* program_inst, f32 delta_time) {
+    return TRUE;
+}
+
+static b8 benchmark_program_render(program* program_inst, f32 delta_time, f32 interpolation_alpha) {
+    return TRUE;
+}
+
+static void benchmark_program_on_resize(program* program_inst, u32 width, u32 height) {
+}
+
+u8 application_should_stop_after_benchmark_frames() {
+    program program_inst = {};
+    program_inst.app_config.name = "null backend benchmark test";
+    program_inst.app_config.start_width = 640;
+    program_inst.app_config.start_height = 480;
+    program_inst.app_config.headless = TRUE;
+    program_inst.app_config.benchmark_frames = TEST_BENCHMARK_FRAMES;
+    program_inst.initialize = benchmark_program_initialize;
+    program_inst.update = benchmark_program_update;
+    program_inst.render = benchmark_program_render;
+    program_inst.on_resize = benchmark_program_on_resize;
+
+    b8 initialized = application_initialize(&program_inst);
+    expect_to_be_true(initialized);
+    b8 ran = application_run();
+
+    // The backend's counters outlive the renderer until the next one starts.
+    null_backend_stats stats;
+    null_backend_get_stats(&stats);
+    remove("console.log");
+
+    expect_to_be_true(ran);
+    expect_should_be(TEST_BENCHMARK_FRAMES, stats.frames);
+
+    return TRUE;
+}
+
+void null_backend_register_tests() {
+    test_manager_register_test(null_backend_should_count_draws_and_uploads, "Null backend should count draws and uploads.");
+    // Runs the whole engine, so it goes last to leave the other tests a clean process.
+    test_manager_register_test(application_should_stop_after_benchmark_frames, "Headless application should stop after the benchmark frames.");
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "render_thread_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <memory/hmemory.h>
+#include <renderer/renderer_frontend.h>
+#include <renderer/render_commands.h>
+#include <renderer/null/null_backend.h>
+
+#define TEST_FRAME_COUNT 50
+#define TEST_DRAWS_PER_FRAME 100
+
+u8 render_command_buffer_should_replay_in_order() {
+    render_command_buffer buffer;
+    expect_to_be_true(render_command_buffer_create(16, &buffer));
+
+    // Enough commands to grow the buffer a few times.
+    for (u32 i = 0; i < 64; ++i)
+    {
+        render_command_resize* resize = render_command_buffer_push(&buffer, RENDER_COMMAND_RESIZE, sizeof(render_command_resize));
+        resize->width = (u16)i;
+        resize->height = (u16)(i * 2);
+        render_command_globals* globals = render_command_buffer_push(&buffer, RENDER_COMMAND_SET_GLOBALS, sizeof(render_command_globals));
+        globals->view.data[15] = (f32)i;
+    }
+
+    u32 count = 0;
+    b8 in_order = TRUE;
+    u64 offset = 0;
+    const render_command_header* header;
+    while ((header = render_command_buffer_next(&buffer, &offset)))
+    {
+        u32 i = count / 2;
+        if (count % 2 == 0)
+        {
+            const render_command_resize* resize = (const render_command_resize*)(header + 1);
+            in_order = in_order && header->type == RENDER_COMMAND_RESIZE && resize->width == i && resize->height == i * 2;
+        }
+        else
+        {
+            const render_command_globals* globals = (const render_command_globals*)(header + 1);
+            in_order = in_order && header->type == RENDER_COMMAND_SET_GLOBALS && globals->view.data[15] == (f32)i;
+        }
+        count++;
+    }
+
+    expect_to_be_true(in_order);
+    expect_should_be(128, count);
+
+    render_command_buffer_destroy(&buffer);
+
+    return TRUE;
+}
+
+u8 render_thread_should_replay_every_frame() {
+    u64 size = 0;
+    renderer_initialize(&size, 0, 0, 0, FALSE);
+    void* state = hallocate(size, MEMORY_TAG_RENDERER);
+    b8 initialized = renderer_initialize(&size, state, "render thread test", RENDERER_BACKEND_NULL, TRUE);
+    expect_to_be_true(initialized);
+
+    // Created through a round trip to the render thread.
+    vertex_3d vertices[3] = {0};
+    geometry g = {0};
+    g.internal_id = INVALID_ID;
+    b8 created = renderer_create_geometry(&g, 3, vertices, 0, 0);
+    expect_to_be_true(created);
+
+    geometry_render_data draws[TEST_DRAWS_PER_FRAME];
+    for (u32 i = 0; i < TEST_DRAWS_PER_FRAME; ++i)
+    {
+        draws[i].model = mat4_identity();
+        draws[i].geometry = &g;
+    }
+
+    render_packet packet;
+    packet.delta_time = 1.0f / 60.0f;
+    packet.geometry_count = TEST_DRAWS_PER_FRAME;
+    packet.geometries = draws;
+
+    b8 all_drawn = TRUE;
+    for (u32 i = 0; i < TEST_FRAME_COUNT; ++i)
+    {
+        all_drawn = renderer_draw_frame(&packet) && all_drawn;
+    }
+    renderer_flush();
+
+    null_backend_stats stats;
+    null_backend_get_stats(&stats);
+    u64 frames = stats.frames;
+    u64 draw_count = stats.draws;
+
+    renderer_destroy_geometry(&g);
+    renderer_shutdown(state);
+    hfree(state, size, MEMORY_TAG_RENDERER);
+
+    expect_to_be_true(all_drawn);
+    expect_should_be(TEST_FRAME_COUNT, frames);
+    expect_should_be(TEST_FRAME_COUNT * TEST_DRAWS_PER_FRAME, draw_count);
+
+    return TRUE;
+}
+
+void render_thread_register_tests() {
+    test_manager_register_test(render_command_buffer_should_replay_in_order, "Render command buffer should replay in order.");
+    test_manager_register_test(render_thread_should_replay_every_frame, "Render thread should replay every frame.");
+}
\ No newline at end of file
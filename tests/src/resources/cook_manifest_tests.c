@@ -0,0 +1,116 @@
+#include "cook_manifest_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <memory/hmemory.h>
+#include <platform/filesystem.h>
+#include <resources/htex.h>
+#include <resources/cook_manifest.h>
+#include <systems/resource_system.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_CACHE_DIR "cook_manifest_test"
+#define TEST_MANIFEST_PATH TEST_CACHE_DIR "/manifest.hcm"
+#define TEST_COOKED_FILE "00000000000000ab.htex"
+
+u8 cook_manifest_should_resolve_cooked_assets() {
+    // 1 x 1 PPM, decoded by stb_image like a PNG.
+    u8 encoded[11 + 3] = "P6\n1 1\n255\n";
+    encoded[11] = 10;
+    encoded[12] = 20;
+    encoded[13] = 30;
+
+    b8 directory_created = filesystem_create_directory(TEST_CACHE_DIR);
+    htex_cook_settings settings = {FALSE};
+    b8 cooked = htex_cook("brick", encoded, sizeof(encoded), settings, TEST_CACHE_DIR "/" TEST_COOKED_FILE);
+    cook_manifest_source sources[] = {{"textures/brick.htex", TEST_COOKED_FILE, 0xab}, {"textures/other.htex", "00000000000000cd.htex", 0xcd}};
+    b8 written = cook_manifest_write(TEST_MANIFEST_PATH, 2, sources);
+    cook_manifest_source duplicates[] = {{"a.htex", "1.htex", 1}, {"A.HTEX", "2.htex", 2}};
+    b8 duplicate_written = cook_manifest_write(TEST_CACHE_DIR "/duplicate.hcm", 2, duplicates);
+
+    // Found whatever the case and separators, like names in archives.
+    cook_manifest manifest;
+    b8 opened = cook_manifest_open(TEST_MANIFEST_PATH, &manifest);
+    const char* file = 0;
+    b8 found = opened && cook_manifest_find(&manifest, "Textures\\Brick.htex", &file);
+    b8 file_matches = found && strcmp(file, TEST_COOKED_FILE) == 0;
+    const char* missing_file;
+    b8 missing_found = opened && cook_manifest_find(&manifest, "textures/missing.htex", &missing_file);
+    if (opened)
+    {
+        cook_manifest_close(&manifest);
+    }
+
+    // The base path holds only a loose PNG, the cooked texture can only come from the cache.
+    b8 textures_created = filesystem_create_directory(TEST_CACHE_DIR "/textures");
+    FILE* loose = fopen(TEST_CACHE_DIR "/textures/loose.png", "wb");
+    if (loose)
+    {
+        fclose(loose);
+    }
+
+    resource_system_config config;
+    config.asset_base_path = TEST_CACHE_DIR;
+    config.max_loader_count = 8;
+    config.max_async_request_count = 4;
+    config.pack_path = 0;
+    config.io_queue_depth = 0;
+    config.cook_manifest_path = TEST_MANIFEST_PATH;
+    u64 state_size = 0;
+    resource_system_initialize(&state_size, 0, config);
+    void* state = hallocate(state_size, MEMORY_TAG_APPLICATION);
+    b8 started = resource_system_initialize(&state_size, state, config);
+
+    b8 exists = resource_system_exists("brick", RESOURCE_TYPE_COOKED_IMAGE);
+    b8 missing_exists = resource_system_exists("missing", RESOURCE_TYPE_COOKED_IMAGE);
+    // Types that are never cooked are still looked for below the base path.
+    b8 loose_exists = resource_system_exists("loose", RESOURCE_TYPE_IMAGE);
+    b8 loose_cooked_exists = resource_system_exists("loose", RESOURCE_TYPE_COOKED_IMAGE);
+    resource image;
+    b8 loaded = resource_system_load("brick", RESOURCE_TYPE_COOKED_IMAGE, &image);
+    u32 width = 0;
+    u8 red = 0;
+    if (loaded)
+    {
+        image_resource_data* data = image.data;
+        width = data->width;
+        red = data->pixels[0];
+        resource_system_unload(&image);
+    }
+
+    resource_system_shutdown(state);
+    hfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove(TEST_CACHE_DIR "/" TEST_COOKED_FILE);
+    remove(TEST_MANIFEST_PATH);
+    remove(TEST_CACHE_DIR "/duplicate.hcm");
+    remove(TEST_CACHE_DIR "/textures/loose.png");
+    remove(TEST_CACHE_DIR "/textures");
+    remove(TEST_CACHE_DIR);
+
+    expect_to_be_true(directory_created);
+    expect_to_be_true(cooked);
+    expect_to_be_true(written);
+    expect_to_be_false(duplicate_written);
+    expect_to_be_true(opened);
+    expect_to_be_true(found);
+    expect_to_be_true(file_matches);
+    expect_to_be_false(missing_found);
+    expect_to_be_true(started);
+    expect_to_be_true(exists);
+    expect_to_be_false(missing_exists);
+    expect_to_be_true(textures_created);
+    expect_to_be_true(loose_exists);
+    expect_to_be_false(loose_cooked_exists);
+    expect_to_be_true(loaded);
+    expect_should_be(1, width);
+    expect_should_be(10, red);
+
+    return TRUE;
+}
+
+void cook_manifest_register_tests() {
+    test_manager_register_test(cook_manifest_should_resolve_cooked_assets, "Cooked assets should be resolved through the cook manifest.");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void cook_manifest_register_tests();
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "hpak_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/hstring.h>
+#include <memory/hmemory.h>
+#include <platform/filesystem.h>
+#include <resources/hpak.h>
+#include <systems/resource_system.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_PACK_NAME "hpak_test.hpak"
+#define TEST_FILE_COUNT 64
+
+static b8 write_file(const char* path, const char* text)
+{
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &file))
+    {
+        return FALSE;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&file, string_length(text), text, &written);
+    filesystem_close(&file);
+    return result;
+}
+
+u8 hpak_should_find_every_packed_file() {
+    char names[TEST_FILE_COUNT][32];
+    char paths[TEST_FILE_COUNT][32];
+    hpak_source sources[TEST_FILE_COUNT];
+    b8 files_written = TRUE;
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        string_format(names[i], "Dir\\File_%u.txt", i);
+        string_format(paths[i], "hpak_test_%u.txt", i);
+        files_written = files_written && write_file(paths[i], names[i]);
+        sources[i].name = names[i];
+        sources[i].path = paths[i];
+    }
+
+    b8 written = hpak_write(TEST_PACK_NAME, TEST_FILE_COUNT, sources);
+    hpak pak;
+    b8 opened = hpak_open(TEST_PACK_NAME, &pak);
+
+    // Found by the name the loaders would build, whatever the case and separators it was packed with.
+    u32 found = 0;
+    u32 matching = 0;
+    u32 aligned = 0;
+    char lookup[32];
+    for (u32 i = 0; opened && i < TEST_FILE_COUNT; ++i)
+    {
+        const void* data;
+        u64 size;
+        string_format(lookup, "dir/file_%u.TXT", i);
+        if (hpak_find(&pak, lookup, &data, &size))
+        {
+            found++;
+            matching += size == string_length(names[i]) && memcmp(data, names[i], size) == 0;
+            aligned += ((u64)data & (HPAK_ALIGNMENT - 1)) == 0;
+        }
+    }
+
+    const void* missing_data;
+    u64 missing_size;
+    b8 missing_found = opened && hpak_find(&pak, "dir/file_64.txt", &missing_data, &missing_size);
+    b8 duplicate_written = hpak_write("hpak_test_duplicate.hpak", 2, (hpak_source[]){{"a.txt", paths[0]}, {"A.TXT", paths[1]}});
+
+    if (opened)
+    {
+        hpak_close(&pak);
+    }
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        remove(paths[i]);
+    }
+    remove(TEST_PACK_NAME);
+    remove("hpak_test_duplicate.hpak");
+
+    expect_to_be_true(files_written);
+    expect_to_be_true(written);
+    expect_to_be_true(opened);
+    expect_should_be(TEST_FILE_COUNT, found);
+    expect_should_be(TEST_FILE_COUNT, matching);
+    expect_should_be(TEST_FILE_COUNT, aligned);
+    expect_to_be_false(missing_found);
+    expect_to_be_false(duplicate_written);
+
+    return TRUE;
+}
+
+u8 hpak_mounted_files_should_take_precedence() {
+    b8 files_written = write_file("hpak_test_loose.txt", "loose") && write_file("hpak_test_packed.txt", "packed");
+    hpak_source source = {"hpak_test_loose.txt", "hpak_test_packed.txt"};
+    b8 written = hpak_write(TEST_PACK_NAME, 1, &source);
+
+    resource_system_config config;
+    config.asset_base_path = ".";
+    config.max_loader_count = 8;
+    config.max_async_request_count = 4;
+    config.pack_path = TEST_PACK_NAME;
+    config.io_queue_depth = 0;
+    config.cook_manifest_path = 0;
+    u64 state_size = 0;
+    resource_system_initialize(&state_size, 0, config);
+    void* state = hallocate(state_size, MEMORY_TAG_APPLICATION);
+    b8 started = resource_system_initialize(&state_size, state, config);
+
+    resource text;
+    b8 loaded = resource_system_load("hpak_test_loose.txt", RESOURCE_TYPE_TEXT, &text);
+    b8 from_pack = loaded && text.data_size == 6 && memcmp(text.data, "packed", 6) == 0;
+    if (loaded)
+    {
+        resource_system_unload(&text);
+    }
+
+    resource_system_shutdown(state);
+    hfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove("hpak_test_loose.txt");
+    remove("hpak_test_packed.txt");
+    remove(TEST_PACK_NAME);
+
+    expect_to_be_true(files_written);
+    expect_to_be_true(written);
+    expect_to_be_true(started);
+    expect_to_be_true(loaded);
+    expect_to_be_true(from_pack);
+
+    return TRUE;
+}
+
+// Rewrites the archive with its fanout table changed and reports whether it still opens.
+static b8 opens_with_fanout(const u8* archive, u64 size, u32 first_bucket, u32 last_bucket, u32 value)
+{
+    u8* copy = hallocate(size, MEMORY_TAG_ARRAY);
+    hcopy_memory(copy, archive, size);
+    hpak_header* header = (hpak_header*)copy;
+    for (u32 bucket = first_bucket; bucket <= last_bucket; ++bucket)
+    {
+        header->fanout[bucket] = value;
+    }
+
+    file_handle file;
+    u64 written = 0;
+    b8 opened = FALSE;
+    if (filesystem_open("hpak_test_damaged.hpak", FILE_MODE_WRITE, TRUE, &file))
+    {
+        filesystem_write(&file, size, copy, &written);
+        filesystem_close(&file);
+
+        hpak pak;
+        opened = hpak_open("hpak_test_damaged.hpak", &pak);
+        if (opened)
+        {
+            hpak_close(&pak);
+        }
+    }
+
+    remove("hpak_test_damaged.hpak");
+    hfree(copy, size, MEMORY_TAG_ARRAY);
+    return opened;
+}
+
+u8 hpak_should_reject_a_damaged_fanout() {
+    char names[TEST_FILE_COUNT][32];
+    char paths[TEST_FILE_COUNT][32];
+    hpak_source sources[TEST_FILE_COUNT];
+    b8 files_written = TRUE;
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        string_format(names[i], "file_%u.txt", i);
+        string_format(paths[i], "hpak_test_%u.txt", i);
+        files_written = files_written && write_file(paths[i], names[i]);
+        sources[i].name = names[i];
+        sources[i].path = paths[i];
+    }
+    b8 written = hpak_write(TEST_PACK_NAME, TEST_FILE_COUNT, sources);
+
+    file_view view = {0};
+    b8 mapped = filesystem_map(TEST_PACK_NAME, &view);
+    const hpak_header* header = view.data;
+    u32 count = mapped ? header->entry_count : 0;
+
+    b8 intact_opens = mapped && opens_with_fanout(view.data, view.size, 0, 0, header->fanout[0]);
+    // Past the table, a lookup would read beyond the last entry.
+    b8 too_large_opens = mapped && opens_with_fanout(view.data, view.size, 0, 0, count + 1);
+    // Decreasing, a bucket range would run backwards.
+    b8 decreasing_opens = mapped && opens_with_fanout(view.data, view.size, 0, 127, count);
+    // In order and in bounds, but every entry is filed under the last bucket.
+    b8 misfiled_opens = mapped && opens_with_fanout(view.data, view.size, 0, 254, 0);
+
+    if (mapped)
+    {
+        filesystem_unmap(&view);
+    }
+    for (u32 i = 0; i < TEST_FILE_COUNT; ++i)
+    {
+        remove(paths[i]);
+    }
+    remove(TEST_PACK_NAME);
+
+    expect_to_be_true(files_written);
+    expect_to_be_true(written);
+    expect_to_be_true(mapped);
+    expect_to_be_true(intact_opens);
+    expect_to_be_false(too_large_opens);
+    expect_to_be_false(decreasing_opens);
+    expect_to_be_false(misfiled_opens);
+
+    return TRUE;
+}
+
+void hpak_register_tests() {
+    test_manager_register_test(hpak_should_find_every_packed_file, "Archive lookups should find every packed file.");
+    test_manager_register_test(hpak_mounted_files_should_take_precedence, "Mounted archive files should take precedence over loose files.");
+    test_manager_register_test(hpak_should_reject_a_damaged_fanout, "Archives with a damaged fanout table should not open.");
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "htex_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <resources/htex.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_TEXTURE_NAME "htex_test.htex"
+
+u8 htex_cook_should_flip_and_build_mips() {
+    // 3 x 2 PPM, rows top down. stb_image decodes it like a PNG and it needs no encoder.
+    u8 encoded[11 + 18] = "P6\n3 2\n255\n";
+    for (u32 i = 0; i < 18; ++i)
+    {
+        encoded[11 + i] = (u8)((i + 1) * 10);
+    }
+
+    htex_cook_settings settings = {TRUE};
+    b8 cooked = htex_cook("htex_test", encoded, sizeof(encoded), settings, TEST_TEXTURE_NAME);
+
+    file_view view = {0};
+    b8 mapped = cooked && filesystem_map(TEST_TEXTURE_NAME, &view);
+    const htex_header* header = 0;
+    b8 parsed = mapped && htex_parse(view.data, view.size, &header);
+    const htex_header* truncated_header;
+    b8 truncated_parsed = mapped && htex_parse(view.data, view.size - 1, &truncated_header);
+
+    u32 width = parsed ? header->width : 0;
+    u32 height = parsed ? header->height : 0;
+    u32 mip_count = parsed ? header->mip_count : 0;
+    b8 transparent = parsed && (header->flags & HTEX_FLAG_TRANSPARENT);
+    // The bottom row comes first, and the 1 x 1 level averages the 2 x 2 block in the corner.
+    static const u8 expected_first[4] = {100, 110, 120, 255};
+    static const u8 expected_last[4] = {70, 80, 90, 255};
+    b8 flipped = parsed && memcmp((const u8*)view.data + header->mip_offsets[0], expected_first, 4) == 0;
+    b8 averaged = parsed && mip_count == 2 && memcmp((const u8*)view.data + header->mip_offsets[1], expected_last, 4) == 0;
+    u64 expected_size = sizeof(htex_header) + 3 * 2 * 4 + 1 * 1 * 4;
+    u64 file_size = view.size;
+
+    filesystem_unmap(&view);
+    remove(TEST_TEXTURE_NAME);
+
+    expect_to_be_true(cooked);
+    expect_to_be_true(parsed);
+    expect_to_be_false(truncated_parsed);
+    expect_should_be(3, width);
+    expect_should_be(2, height);
+    expect_should_be(2, mip_count);
+    expect_should_be(expected_size, file_size);
+    expect_to_be_false(transparent);
+    expect_to_be_true(flipped);
+    expect_to_be_true(averaged);
+
+    return TRUE;
+}
+
+void htex_register_tests() {
+    test_manager_register_test(htex_cook_should_flip_and_build_mips, "Cooked textures should be flipped and carry their mip chain.");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void htex_register_tests();
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "material_loader_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/hstring.h>
+#include <memory/hmemory.h>
+#include <platform/filesystem.h>
+#include <systems/resource_system.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static b8 write_file(const char* path, const char* text)
+{
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &file))
+    {
+        return FALSE;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&file, string_length(text), text, &written);
+    filesystem_close(&file);
+    return result;
+}
+
+u8 material_loader_should_parse_batches() {
+    // Spacing, case, line endings and a last line without a newline all vary, like hand edited files do.
+    b8 files_written = filesystem_create_directory("materials") &&
+        write_file("materials/material_test_a.hmt", "#material file\r\n\r\nversion=0.1\r\n  NAME = stone wall \r\ndiffuse_color=0.5 0.25 1 1\r\ndiffuse_name=cobblestone\r\n") &&
+        write_file("materials/material_test_b.hmt", "diffuse_Color = -1.5e1\t2 .5 +1\nno separator here\n=orphan\nunknown_key = 3\ndiffuse_name=paving") &&
+        write_file("materials/material_test_c.hmt", "diffuse_color=1 2 three 4\n");
+
+    resource_system_config config;
+    config.asset_base_path = ".";
+    config.max_loader_count = 8;
+    config.max_async_request_count = 4;
+    config.pack_path = 0;
+    config.io_queue_depth = 0;
+    config.cook_manifest_path = 0;
+    u64 state_size = 0;
+    resource_system_initialize(&state_size, 0, config);
+    void* state = hallocate(state_size, MEMORY_TAG_APPLICATION);
+    b8 started = resource_system_initialize(&state_size, state, config);
+
+    const char* names[4] = {"material_test_a", "material_test_b", "material_test_c", "material_test_missing"};
+    resource resources[4];
+    b8 loaded[4];
+    u32 loaded_count = resource_system_load_batch(4, names, RESOURCE_TYPE_MATERIAL, resources, loaded);
+
+    material_resource_data a = {0};
+    material_resource_data b = {0};
+    material_resource_data c = {0};
+    if (loaded[0]) a = *(material_resource_data*)resources[0].data;
+    if (loaded[1]) b = *(material_resource_data*)resources[1].data;
+    if (loaded[2]) c = *(material_resource_data*)resources[2].data;
+    for (u32 i = 0; i < 4; ++i)
+    {
+        if (loaded[i]) resource_system_unload(&resources[i]);
+    }
+
+    resource_system_shutdown(state);
+    hfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove("materials/material_test_a.hmt");
+    remove("materials/material_test_b.hmt");
+    remove("materials/material_test_c.hmt");
+    remove("materials");
+
+    b8 a_parsed = strcmp(a.name, "stone wall") == 0 && strcmp(a.diffuse_name, "cobblestone") == 0 &&
+        a.diffuse_color.x == 0.5f && a.diffuse_color.y == 0.25f && a.diffuse_color.z == 1.0f && a.diffuse_color.w == 1.0f;
+    // The name defaults to the one loaded by.
+    b8 b_parsed = strcmp(b.name, "material_test_b") == 0 && strcmp(b.diffuse_name, "paving") == 0 &&
+        b.diffuse_color.x == -15.0f && b.diffuse_color.y == 2.0f && b.diffuse_color.z == 0.5f && b.diffuse_color.w == 1.0f;
+    // A malformed color leaves the default white.
+    b8 c_parsed = c.diffuse_color.x == 1.0f && c.diffuse_color.y == 1.0f && c.diffuse_color.z == 1.0f && c.diffuse_color.w == 1.0f;
+
+    expect_to_be_true(files_written);
+    expect_to_be_true(started);
+    expect_should_be(3, loaded_count);
+    expect_to_be_false(loaded[3]);
+    expect_to_be_true(a_parsed);
+    expect_to_be_true(b_parsed);
+    expect_to_be_true(c_parsed);
+
+    return TRUE;
+}
+
+void material_loader_register_tests() {
+    test_manager_register_test(material_loader_should_parse_batches, "Material files should parse in place and load in batches.");
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "job_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/atomic.h>
+#include <memory/hmemory.h>
+#include <systems/job_system.h>
+
+#define TEST_ELEMENT_COUNT 100000
+
+typedef struct nested_job_data
+{
+    volatile u32* total;
+    job_counter* counter;
+} nested_job_data;
+
+static void* start_job_system(u32 worker_count, u64* out_size)
+{
+    job_system_config config;
+    config.worker_count = worker_count;
+    job_system_initialize(out_size, 0, config);
+    void* state = hallocate(*out_size, MEMORY_TAG_APPLICATION);
+    if (!job_system_initialize(out_size, state, config))
+    {
+        hfree(state, *out_size, MEMORY_TAG_APPLICATION);
+        return 0;
+    }
+    return state;
+}
+
+static void square_range(void* data, u32 start, u32 end)
+{
+    u64* values = data;
+    for (u32 i = start; i < end; ++i)
+    {
+        values[i] = (u64)i * i;
+    }
+}
+
+static void add_one(void* data)
+{
+    nested_job_data* nested = data;
+    atomic_fetch_add_u32(nested->total, 1);
+}
+
+static void spawn_children(void* data)
+{
+    // Jobs submitted from a worker land on that worker's deque and get stolen from there.
+    nested_job_data* nested = data;
+    for (u32 i = 0; i < 16; ++i)
+    {
+        job_system_submit(add_one, nested, nested->counter);
+    }
+}
+
+u8 job_system_parallel_for_should_cover_every_element() {
+    u64 size = 0;
+    void* state = start_job_system(3, &size);
+    expect_to_be_true(state != 0);
+    expect_should_be(3, job_system_worker_count());
+
+    u64* values = hallocate(sizeof(u64) * TEST_ELEMENT_COUNT, MEMORY_TAG_ARRAY);
+    job_system_parallel_for(TEST_ELEMENT_COUNT, 0, square_range, values);
+
+    b8 all_set = TRUE;
+    for (u32 i = 0; i < TEST_ELEMENT_COUNT; ++i)
+    {
+        if (values[i] != (u64)i * i)
+        {
+            all_set = FALSE;
+            break;
+        }
+    }
+    expect_to_be_true(all_set);
+
+    hfree(values, sizeof(u64) * TEST_ELEMENT_COUNT, MEMORY_TAG_ARRAY);
+    job_system_shutdown(state);
+    hfree(state, size, MEMORY_TAG_APPLICATION);
+
+    return TRUE;
+}
+
+u8 job_system_wait_should_include_nested_jobs() {
+    u64 size = 0;
+    void* state = start_job_system(2, &size);
+    expect_to_be_true(state != 0);
+
+    volatile u32 total = 0;
+    job_counter counter = {0};
+    nested_job_data nested = {&total, &counter};
+
+    for (u32 i = 0; i < 64; ++i)
+    {
+        job_system_submit(spawn_children, &nested, &counter);
+    }
+    job_system_wait(&counter);
+
+    u32 result = atomic_load_u32(&total);
+    expect_should_be(64 * 16, result);
+    expect_should_be(0, counter.pending);
+
+    job_system_shutdown(state);
+    hfree(state, size, MEMORY_TAG_APPLICATION);
+
+    return TRUE;
+}
+
+void job_system_register_tests() {
+    test_manager_register_test(job_system_parallel_for_should_cover_every_element, "Job system parallel_for should cover every element.");
+    test_manager_register_test(job_system_wait_should_include_nested_jobs, "Job system wait should include nested jobs.");
+}
\ No newline at end of file
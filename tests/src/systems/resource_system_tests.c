@@ -0,0 +1,254 @@
+#include "resource_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <memory/hmemory.h>
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+#include <systems/job_system.h>
+#include <systems/resource_system.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FILE_NAME "resource_async_test.txt"
+#define TEST_FILE_TEXT "loaded off the main thread"
+
+typedef struct load_result
+{
+    u32 calls;
+    b8 success;
+    u64 size;
+} load_result;
+
+typedef struct test_systems
+{
+    void* job_state;
+    u64 job_size;
+    void* resource_state;
+    u64 resource_size;
+} test_systems;
+
+static b8 start_systems(u32 worker_count, u32 io_queue_depth, test_systems* out_systems)
+{
+    file_handle file;
+    if (!filesystem_open(TEST_FILE_NAME, FILE_MODE_WRITE, FALSE, &file))
+    {
+        return FALSE;
+    }
+    filesystem_write_line(&file, TEST_FILE_TEXT);
+    filesystem_close(&file);
+
+    job_system_config job_config;
+    job_config.worker_count = worker_count;
+    job_system_initialize(&out_systems->job_size, 0, job_config);
+    out_systems->job_state = hallocate(out_systems->job_size, MEMORY_TAG_APPLICATION);
+    job_system_initialize(&out_systems->job_size, out_systems->job_state, job_config);
+
+    resource_system_config config;
+    config.asset_base_path = ".";
+    config.max_loader_count = 8;
+    config.max_async_request_count = 4;
+    config.pack_path = 0;
+    config.io_queue_depth = io_queue_depth;
+    config.cook_manifest_path = 0;
+    resource_system_initialize(&out_systems->resource_size, 0, config);
+    out_systems->resource_state = hallocate(out_systems->resource_size, MEMORY_TAG_APPLICATION);
+    return resource_system_initialize(&out_systems->resource_size, out_systems->resource_state, config);
+}
+
+static void stop_systems(test_systems* systems)
+{
+    resource_system_cancel_all();
+    job_system_shutdown(systems->job_state);
+    resource_system_shutdown(systems->resource_state);
+    hfree(systems->job_state, systems->job_size, MEMORY_TAG_APPLICATION);
+    hfree(systems->resource_state, systems->resource_size, MEMORY_TAG_APPLICATION);
+    remove(TEST_FILE_NAME);
+}
+
+static void on_loaded(b8 success, resource* loaded, void* user_data)
+{
+    load_result* result = user_data;
+    result->calls++;
+    result->success = success;
+    if (success)
+    {
+        result->size = loaded->data_size;
+        resource_system_unload(loaded);
+    }
+}
+
+u8 resource_system_load_async_should_deliver_on_dispatch() {
+    test_systems systems;
+    b8 started = start_systems(2, 0, &systems);
+    expect_to_be_true(started);
+
+    load_result result = {0};
+    u32 request = resource_system_load_async(TEST_FILE_NAME, RESOURCE_TYPE_TEXT, on_loaded, &result);
+
+    // Only delivered from the dispatch, whichever thread did the loading.
+    u64 deadline_ns = platform_get_ticks_ns() + 5000000000ull;
+    while (!result.calls && platform_get_ticks_ns() < deadline_ns)
+    {
+        resource_system_dispatch_completed();
+        platform_thread_yield();
+    }
+
+    u32 calls = result.calls;
+    b8 success = result.success;
+    b8 has_data = result.size > 0;
+    stop_systems(&systems);
+
+    expect_should_not_be(INVALID_ID, request);
+    expect_should_be(1, calls);
+    expect_to_be_true(success);
+    expect_to_be_true(has_data);
+
+    return TRUE;
+}
+
+u8 resource_system_cancel_should_skip_callback() {
+    // No workers, so the loads only run once dispatched.
+    test_systems systems;
+    b8 started = start_systems(0, 0, &systems);
+    expect_to_be_true(started);
+
+    load_result cancelled = {0};
+    load_result kept = {0};
+    u32 cancelled_request = resource_system_load_async(TEST_FILE_NAME, RESOURCE_TYPE_TEXT, on_loaded, &cancelled);
+    resource_system_load_async(TEST_FILE_NAME, RESOURCE_TYPE_TEXT, on_loaded, &kept);
+    b8 cancel_result = resource_system_cancel(cancelled_request);
+
+    // Runs the loads as well, there are no workers.
+    resource_system_dispatch_completed();
+
+    // The id went stale once the request was dispatched.
+    b8 stale_cancel_result = resource_system_cancel(cancelled_request);
+    u32 cancelled_calls = cancelled.calls;
+    u32 kept_calls = kept.calls;
+    stop_systems(&systems);
+
+    expect_to_be_true(cancel_result);
+    expect_to_be_false(stale_cancel_result);
+    expect_should_be(0, cancelled_calls);
+    expect_should_be(1, kept_calls);
+
+    return TRUE;
+}
+
+typedef struct batch_result
+{
+    u32 calls;
+    u32 matching;
+} batch_result;
+
+// Stands in for a loader that decodes from memory, it only checks what it was handed.
+static b8 memory_loader_load_from_memory(struct resource_loader* self, const char* name, const void* data, u64 size, resource* out_resource)
+{
+    out_resource->name = name;
+    out_resource->full_path = 0;
+    out_resource->data = 0;
+    out_resource->data_size = size;
+    return size == sizeof(TEST_FILE_TEXT) && memcmp(data, TEST_FILE_TEXT "\n", size) == 0;
+}
+
+static b8 memory_loader_load(struct resource_loader* self, const char* name, resource* out_resource)
+{
+    return FALSE;
+}
+
+static void on_batch_loaded(b8 success, resource* loaded, void* user_data)
+{
+    batch_result* result = user_data;
+    result->calls++;
+    result->matching += success;
+}
+
+static b8 register_memory_loader()
+{
+    resource_loader loader = {0};
+    loader.type = RESOURCE_TYPE_STATIC_MESH;
+    loader.type_path = "";
+    loader.extension = "";
+    loader.load = memory_loader_load;
+    loader.load_from_memory = memory_loader_load_from_memory;
+    return resource_system_register_loader(loader);
+}
+
+u8 resource_system_batch_should_read_through_async_io() {
+    test_systems systems;
+    b8 started = start_systems(0, 2, &systems);
+    expect_to_be_true(started);
+
+    b8 registered = register_memory_loader();
+
+    // More loads than the queue depth, the rest wait in the backlog.
+    const char* names[4] = {TEST_FILE_NAME, TEST_FILE_NAME, TEST_FILE_NAME, TEST_FILE_NAME};
+    batch_result result = {0};
+    u32 queued = resource_system_load_batch_async(4, names, RESOURCE_TYPE_STATIC_MESH, on_batch_loaded, &result, 0);
+
+    u64 deadline_ns = platform_get_ticks_ns() + 5000000000ull;
+    while (result.calls < queued && platform_get_ticks_ns() < deadline_ns)
+    {
+        resource_system_dispatch_completed();
+        platform_thread_yield();
+    }
+
+    u32 calls = result.calls;
+    u32 matching = result.matching;
+    stop_systems(&systems);
+
+    expect_to_be_true(registered);
+    expect_should_be(4, queued);
+    expect_should_be(4, calls);
+    expect_should_be(4, matching);
+
+    return TRUE;
+}
+
+u8 resource_system_cancel_all_should_free_every_request() {
+    test_systems systems;
+    b8 started = start_systems(2, 1, &systems);
+    expect_to_be_true(started);
+
+    b8 registered = register_memory_loader();
+
+    // Every slot taken, one read in flight and the rest in the backlog.
+    const char* names[4] = {TEST_FILE_NAME, TEST_FILE_NAME, TEST_FILE_NAME, TEST_FILE_NAME};
+    batch_result cancelled = {0};
+    u32 queued = resource_system_load_batch_async(4, names, RESOURCE_TYPE_STATIC_MESH, on_batch_loaded, &cancelled, 0);
+
+    resource_system_cancel_all();
+    u32 cancelled_calls = cancelled.calls;
+
+    // Only possible once every slot was released.
+    batch_result requeued = {0};
+    u32 requeued_count = resource_system_load_batch_async(4, names, RESOURCE_TYPE_STATIC_MESH, on_batch_loaded, &requeued, 0);
+
+    u64 deadline_ns = platform_get_ticks_ns() + 5000000000ull;
+    while (requeued.calls < requeued_count && platform_get_ticks_ns() < deadline_ns)
+    {
+        resource_system_dispatch_completed();
+        platform_thread_yield();
+    }
+
+    u32 requeued_matching = requeued.matching;
+    stop_systems(&systems);
+
+    expect_to_be_true(registered);
+    expect_should_be(4, queued);
+    expect_should_be(0, cancelled_calls);
+    expect_should_be(4, requeued_count);
+    expect_should_be(4, requeued_matching);
+
+    return TRUE;
+}
+
+void resource_system_register_tests() {
+    test_manager_register_test(resource_system_load_async_should_deliver_on_dispatch, "Resource system async loads should be delivered on dispatch.");
+    test_manager_register_test(resource_system_cancel_should_skip_callback, "Resource system cancel should skip the callback.");
+    test_manager_register_test(resource_system_batch_should_read_through_async_io, "Resource system batches should read through async I/O.");
+    test_manager_register_test(resource_system_cancel_all_should_free_every_request, "Resource system cancel all should free every request.");
+}
\ No newline at end of file
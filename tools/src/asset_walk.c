@@ -0,0 +1,82 @@
+#include "asset_walk.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+
+#include <containers/list.h>
+
+#include <platform/filesystem.h>
+
+typedef struct walk_state
+{
+    const char* root;
+    const char* skip_extension;
+    // Below root, without a leading separator.
+    char relative[ASSET_PATH_MAX];
+    asset_file* files;
+    b8 failed;
+} walk_state;
+
+static b8 ends_with(const char* str, const char* suffix)
+{
+    u64 length = string_length(str);
+    u64 suffix_length = string_length(suffix);
+    return length >= suffix_length && strings_equali(str + length - suffix_length, suffix);
+}
+
+static b8 collect_entry(const char* name, b8 is_directory, void* user_data)
+{
+    walk_state* walk = user_data;
+
+    u64 relative_length = string_length(walk->relative);
+    if (relative_length + string_length(name) + string_length(walk->root) + 2 >= ASSET_PATH_MAX)
+    {
+        HERROR("Path too long below '%s': '%s'.", walk->relative, name);
+        walk->failed = TRUE;
+        return FALSE;
+    }
+
+    asset_file file;
+    if (relative_length)
+    {
+        string_format(file.name, "%s/%s", walk->relative, name);
+    }
+    else
+    {
+        string_ncopy(file.name, name, ASSET_PATH_MAX);
+    }
+    string_format(file.path, "%s/%s", walk->root, file.name);
+
+    if (is_directory)
+    {
+        string_ncopy(walk->relative, file.name, ASSET_PATH_MAX);
+        b8 listed = filesystem_list_directory(file.path, collect_entry, walk);
+        walk->relative[relative_length] = 0;
+        if (!listed) walk->failed = TRUE;
+        return !walk->failed;
+    }
+
+    if (!walk->skip_extension || !ends_with(name, walk->skip_extension))
+    {
+        list_push(walk->files, file);
+    }
+    return TRUE;
+}
+
+b8 asset_walk(const char* root, const char* skip_extension, asset_file** out_files)
+{
+    walk_state walk = {};
+    walk.root = root;
+    walk.skip_extension = skip_extension;
+    walk.files = list_create(asset_file);
+
+    if (!filesystem_list_directory(root, collect_entry, &walk) || walk.failed)
+    {
+        list_destroy(walk.files);
+        *out_files = 0;
+        return FALSE;
+    }
+
+    *out_files = walk.files;
+    return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <defines.h>
+
+#define ASSET_PATH_MAX 512
+
+typedef struct asset_file
+{
+    // Below the walked directory, '/' separated.
+    char name[ASSET_PATH_MAX];
+    // The walked directory joined with the name.
+    char path[ASSET_PATH_MAX];
+} asset_file;
+
+/**
+ * @brief Lists every file below a directory, descending into subdirectories.
+ *
+ * @param skip_extension files ending in it are left out, 0 keeps every file.
+ * @param out_files receives a list of asset_file, destroyed by the caller with list_destroy.
+ */
+b8 asset_walk(const char* root, const char* skip_extension, asset_file** out_files);
\ No newline at end of file
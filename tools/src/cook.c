@@ -0,0 +1,214 @@
+#include "cook.h"
+#include "asset_walk.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+
+#include <containers/list.h>
+
+#include <memory/hmemory.h>
+
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+
+#include <resources/htex.h>
+#include <resources/hpak.h>
+#include <resources/cook_manifest.h>
+
+#define COOK_MANIFEST_NAME "manifest.hcm"
+
+typedef struct cook_options
+{
+    b8 generate_mips;
+} cook_options;
+
+typedef struct cooker
+{
+    // Sources are found below <asset_dir>/<type_path> by their extension.
+    const char* type_path;
+    const char* source_extension;
+    const char* cooked_extension;
+    u32 version;
+    // Writes the settings that change the output into settings, returning their size, so they become part of the key.
+    u32 (*settings)(const cook_options* options, u8* settings);
+    b8 (*cook)(const char* name, const void* source, u64 source_size, const cook_options* options, const char* output_path);
+} cooker;
+
+typedef struct cooked_asset
+{
+    char name[ASSET_PATH_MAX];
+    char file[32];
+    u64 key;
+} cooked_asset;
+
+typedef struct cook_stats
+{
+    u32 cooked;
+    u32 reused;
+    u32 failed;
+    u64 source_bytes;
+} cook_stats;
+
+static u32 texture_settings(const cook_options* options, u8* settings)
+{
+    settings[0] = options->generate_mips;
+    return 1;
+}
+
+static b8 cook_texture(const char* name, const void* source, u64 source_size, const cook_options* options, const char* output_path)
+{
+    htex_cook_settings settings;
+    settings.generate_mips = options->generate_mips;
+    return htex_cook(name, source, source_size, settings, output_path);
+}
+
+static const cooker cookers[] =
+{
+    {"textures", ".png", ".htex", HTEX_COOKER_VERSION, texture_settings, cook_texture}
+};
+
+#define COOKER_COUNT (sizeof(cookers) / sizeof(cooker))
+
+static b8 ends_with(const char* str, const char* suffix)
+{
+    u64 length = string_length(str);
+    u64 suffix_length = string_length(suffix);
+    return length >= suffix_length && strings_equali(str + length - suffix_length, suffix);
+}
+
+// Everything the cooked output depends on. Equal keys mean the cached file can be used as it is.
+static u64 cook_key(const cooker* c, const cook_options* options, const void* source, u64 source_size)
+{
+    u8 settings[64];
+    u32 settings_size = c->settings(options, settings);
+
+    u64 hash = hpak_hash_bytes(HPAK_HASH_SEED, c->cooked_extension, string_length(c->cooked_extension));
+    hash = hpak_hash_bytes(hash, &c->version, sizeof(c->version));
+    hash = hpak_hash_bytes(hash, settings, settings_size);
+    hash = hpak_hash_bytes(hash, &source_size, sizeof(source_size));
+    return hpak_hash_bytes(hash, source, source_size);
+}
+
+static void cook_file(const cooker* c, const cook_options* options, const asset_file* file, const char* cache_dir, cooked_asset** assets, cook_stats* stats)
+{
+    file_view source;
+    if (!filesystem_map(file->path, &source))
+    {
+        stats->failed++;
+        return;
+    }
+
+    // Named as the engine would look it up without the cache, textures/name.htex for textures/name.png.
+    cooked_asset asset;
+    u64 stem_length = string_length(file->name) - string_length(c->source_extension);
+    string_format(asset.name, "%s/%.*s%s", c->type_path, (i32)stem_length, file->name, c->cooked_extension);
+    asset.key = cook_key(c, options, source.data, source.size);
+    string_format(asset.file, "%016llx%s", asset.key, c->cooked_extension);
+
+    char cached_path[ASSET_PATH_MAX];
+    string_format(cached_path, "%s/%s", cache_dir, asset.file);
+    if (filesystem_exists(cached_path))
+    {
+        stats->reused++;
+        list_push(*assets, asset);
+        filesystem_unmap(&source);
+        return;
+    }
+
+    // Cooked aside and renamed into place, so an interrupted cook never leaves a damaged file under a valid key.
+    char temporary_path[ASSET_PATH_MAX];
+    string_format(temporary_path, "%s.tmp", cached_path);
+    if (c->cook(file->name, source.data, source.size, options, temporary_path) && filesystem_rename(temporary_path, cached_path))
+    {
+        stats->cooked++;
+        stats->source_bytes += source.size;
+        list_push(*assets, asset);
+    }
+    else
+    {
+        stats->failed++;
+    }
+    filesystem_unmap(&source);
+}
+
+static b8 write_manifest(const char* cache_dir, cooked_asset* assets)
+{
+    u32 count = (u32)list_count(assets);
+    u64 sources_size = sizeof(cook_manifest_source) * (count ? count : 1);
+    cook_manifest_source* sources = hallocate(sources_size, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < count; ++i)
+    {
+        sources[i].name = assets[i].name;
+        sources[i].file = assets[i].file;
+        sources[i].key = assets[i].key;
+    }
+
+    char manifest_path[ASSET_PATH_MAX];
+    char temporary_path[ASSET_PATH_MAX];
+    string_format(manifest_path, "%s/%s", cache_dir, COOK_MANIFEST_NAME);
+    string_format(temporary_path, "%s.tmp", manifest_path);
+    b8 result = cook_manifest_write(temporary_path, count, sources) && filesystem_rename(temporary_path, manifest_path);
+
+    hfree(sources, sources_size, MEMORY_TAG_ARRAY);
+    return result;
+}
+
+i32 cook_run(i32 argc, char** argv)
+{
+    if (argc < 2)
+    {
+        HERROR("cook requires an asset directory and a cache directory.");
+        return 1;
+    }
+
+    cook_options options;
+    options.generate_mips = !(argc >= 3 && strings_equali(argv[2], "--no-mips"));
+
+    const char* cache_dir = argv[1];
+    if (!filesystem_create_directory(cache_dir))
+    {
+        return 1;
+    }
+
+    u64 start_ns = platform_get_ticks_ns();
+    cook_stats stats = {};
+    cooked_asset* assets = list_create(cooked_asset);
+    for (u32 i = 0; i < COOKER_COUNT; ++i)
+    {
+        const cooker* c = &cookers[i];
+
+        char source_dir[ASSET_PATH_MAX];
+        string_format(source_dir, "%s/%s", argv[0], c->type_path);
+        asset_file* files = 0;
+        if (!asset_walk(source_dir, 0, &files))
+        {
+            stats.failed++;
+            continue;
+        }
+
+        u32 count = (u32)list_count(files);
+        for (u32 f = 0; f < count; ++f)
+        {
+            if (ends_with(files[f].name, c->source_extension))
+            {
+                cook_file(c, &options, &files[f], cache_dir, &assets, &stats);
+            }
+        }
+        list_destroy(files);
+    }
+
+    b8 written = write_manifest(cache_dir, assets);
+    list_destroy(assets);
+    if (!written)
+    {
+        return 1;
+    }
+
+    HINFO("Cooked %u assets from %.1f KiB and reused %u from '%s' in %.2fms.", stats.cooked, stats.source_bytes / 1024.0, stats.reused, cache_dir, (platform_get_ticks_ns() - start_ns) * 0.000001);
+    if (stats.failed)
+    {
+        HERROR("cook: %u assets failed.", stats.failed);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
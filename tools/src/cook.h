@@ -0,0 +1,10 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Cooks the source assets below <asset_dir> into <cache_dir>, skipping those cooked before with the same
+ * bytes, cooker version and settings, and writes <cache_dir>/manifest.hcm for the engine to find them by.
+ * argv: <asset_dir> <cache_dir> [--no-mips]
+ */
+i32 cook_run(i32 argc, char** argv);
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "io_bench.h"
+#include "asset_walk.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+
+#include <containers/list.h>
+
+#include <memory/hmemory.h>
+
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+#include <platform/async_io.h>
+
+#if HPLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define IO_BENCH_DEFAULT_QUEUE_DEPTH 32
+
+typedef struct bench_result
+{
+    u64 bytes;
+    u32 failed;
+} bench_result;
+
+// Drops the cached pages of every file so the next read goes to the device. Only clean pages
+// nobody else maps are dropped, which holds for assets nothing else has open.
+static b8 evict_files(u32 count, const asset_file* files)
+{
+#if HPLATFORM_LINUX
+    for (u32 i = 0; i < count; ++i)
+    {
+        i32 fd = open(files[i].path, O_RDONLY);
+        if (fd < 0) continue;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+static bench_result read_sequential(u32 count, const asset_file* files)
+{
+    bench_result result = {};
+    for (u32 i = 0; i < count; ++i)
+    {
+        file_handle f;
+        u64 size = 0;
+        if (!filesystem_open(files[i].path, FILE_MODE_READ, TRUE, &f))
+        {
+            result.failed++;
+            continue;
+        }
+
+        u64 read = 0;
+        u8* data = 0;
+        b8 ok = filesystem_size(&f, &size);
+        if (ok && size)
+        {
+            data = hallocate(size, MEMORY_TAG_ARRAY);
+            ok = filesystem_read_all_bytes(&f, data, &read) && read == size;
+            hfree(data, size, MEMORY_TAG_ARRAY);
+        }
+        filesystem_close(&f);
+
+        if (ok)
+        {
+            result.bytes += size;
+        }
+        else
+        {
+            result.failed++;
+        }
+    }
+    return result;
+}
+
+static bench_result read_async(async_io* io, u32 count, const asset_file* files, async_io_read* reads, async_io_read** pointers)
+{
+    bench_result result = {};
+    for (u32 i = 0; i < count; ++i)
+    {
+        hzero_memory(&reads[i], sizeof(async_io_read));
+        reads[i].path = files[i].path;
+        pointers[i] = &reads[i];
+    }
+
+    u32 submitted = 0;
+    u32 completed = 0;
+    async_io_read* done[64];
+    while (completed < count)
+    {
+        submitted += async_io_submit(io, count - submitted, pointers + submitted);
+
+        u32 polled = async_io_poll(io, TRUE, 64, done);
+        for (u32 i = 0; i < polled; ++i)
+        {
+            if (done[i]->success)
+            {
+                result.bytes += done[i]->size;
+            }
+            else
+            {
+                result.failed++;
+            }
+            if (done[i]->data)
+            {
+                hfree(done[i]->data, done[i]->size, MEMORY_TAG_ARRAY);
+            }
+        }
+        completed += polled;
+    }
+    return result;
+}
+
+static void report(const char* method, const char* cache, bench_result result, u64 elapsed_ns)
+{
+    f64 ms = elapsed_ns * 0.000001;
+    f64 mib = result.bytes / (1024.0 * 1024.0);
+    HINFO("%-14s  %-5s  %10.2f  %9.2f  %9.1f%s", method, cache, mib, ms, ms > 0 ? mib / (ms * 0.001) : 0.0, result.failed ? "  (failures)" : "");
+}
+
+i32 io_bench_run(i32 argc, char** argv)
+{
+    if (argc < 1)
+    {
+        HERROR("iobench requires an asset directory.");
+        return 1;
+    }
+
+    u32 queue_depth = IO_BENCH_DEFAULT_QUEUE_DEPTH;
+    if (argc >= 2 && (!string_to_u32(argv[1], &queue_depth) || queue_depth == 0))
+    {
+        HERROR("iobench: invalid queue depth '%s'.", argv[1]);
+        return 1;
+    }
+
+    asset_file* files = 0;
+    if (!asset_walk(argv[0], 0, &files))
+    {
+        return 1;
+    }
+    u32 count = (u32)list_count(files);
+    if (count == 0)
+    {
+        HERROR("iobench: no files below '%s'.", argv[0]);
+        list_destroy(files);
+        return 1;
+    }
+
+    async_io_config threads_config = {};
+    threads_config.queue_depth = queue_depth;
+    threads_config.force_threads = TRUE;
+    async_io_config uring_config = {};
+    uring_config.queue_depth = queue_depth;
+
+    async_io ios[2] = {};
+    b8 created[2];
+    created[0] = async_io_create(threads_config, &ios[0]);
+    created[1] = async_io_create(uring_config, &ios[1]);
+    if (created[1] && ios[1].backend != ASYNC_IO_BACKEND_URING)
+    {
+        // Fell back to threads, which are measured already.
+        async_io_destroy(&ios[1]);
+        created[1] = FALSE;
+    }
+
+    u64 reads_size = sizeof(async_io_read) * count;
+    u64 pointers_size = sizeof(async_io_read*) * count;
+    async_io_read* reads = hallocate(reads_size, MEMORY_TAG_ARRAY);
+    async_io_read** pointers = hallocate(pointers_size, MEMORY_TAG_ARRAY);
+
+    b8 can_evict = evict_files(count, files);
+    HINFO("iobench: %u files below '%s', queue depth %u.", count, argv[0], queue_depth);
+    if (!can_evict)
+    {
+        HWARN("iobench: the page cache cannot be dropped on this platform, every run is warm.");
+    }
+    if (!created[1])
+    {
+        HWARN("iobench: io_uring is unavailable, only the thread backend is measured.");
+    }
+    HINFO("method          cache         MiB         ms      MiB/s");
+
+    // Cold first, then again straight away with everything cached.
+    for (u32 pass = 0; pass < 2; ++pass)
+    {
+        const char* cache = pass == 0 ? "cold" : "warm";
+
+        if (pass == 0) evict_files(count, files);
+        u64 start = platform_get_ticks_ns();
+        bench_result result = read_sequential(count, files);
+        report("sequential", cache, result, platform_get_ticks_ns() - start);
+
+        for (u32 b = 0; b < 2; ++b)
+        {
+            if (!created[b]) continue;
+
+            if (pass == 0) evict_files(count, files);
+            start = platform_get_ticks_ns();
+            result = read_async(&ios[b], count, files, reads, pointers);
+            report(async_io_backend_name(ios[b].backend), cache, result, platform_get_ticks_ns() - start);
+        }
+    }
+
+    for (u32 b = 0; b < 2; ++b)
+    {
+        if (created[b]) async_io_destroy(&ios[b]);
+    }
+    hfree(pointers, pointers_size, MEMORY_TAG_ARRAY);
+    hfree(reads, reads_size, MEMORY_TAG_ARRAY);
+    list_destroy(files);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Times reading every file below a directory one after another, through the async_io
+ * thread backend and through io_uring, each with a cold and a warm page cache.
+ * argv: <asset_dir> [queue_depth]
+ */
+i32 io_bench_run(i32 argc, char** argv);
\ No newline at end of file
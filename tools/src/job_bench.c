@@ -0,0 +1,130 @@
+#include "job_bench.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+#include <core/atomic.h>
+
+#include <memory/hmemory.h>
+
+#include <platform/platform.h>
+
+#include <systems/job_system.h>
+
+#include <math/hmath.h>
+
+#define JOB_BENCH_DEFAULT_ELEMENTS (1024 * 1024)
+#define JOB_BENCH_ITERATIONS 8
+#define JOB_BENCH_SMALL_JOBS 65536
+
+typedef struct bench_data
+{
+    f32* values;
+} bench_data;
+
+// Enough arithmetic per element that the run is compute bound rather than memory bound.
+static void bench_range(void* data, u32 start, u32 end)
+{
+    bench_data* bench = data;
+    for (u32 i = start; i < end; ++i)
+    {
+        f32 x = (f32)i * 0.001f;
+        for (u32 k = 0; k < 16; ++k)
+        {
+            x = hsin(x) * 0.5f + hcos(x * 0.25f);
+        }
+        bench->values[i] = x;
+    }
+}
+
+static void bench_small_job(void* data)
+{
+    atomic_fetch_add_u32(data, 1);
+}
+
+i32 job_bench_run(i32 argc, char** argv)
+{
+    u32 max_threads = platform_get_processor_count();
+    u32 element_count = JOB_BENCH_DEFAULT_ELEMENTS;
+    if (argc >= 1 && (!string_to_u32(argv[0], &max_threads) || max_threads == 0))
+    {
+        HERROR("jobbench: invalid thread count '%s'.", argv[0]);
+        return 1;
+    }
+    if (argc >= 2 && (!string_to_u32(argv[1], &element_count) || element_count == 0))
+    {
+        HERROR("jobbench: invalid element count '%s'.", argv[1]);
+        return 1;
+    }
+    if (max_threads > JOB_SYSTEM_MAX_WORKERS + 1)
+    {
+        max_threads = JOB_SYSTEM_MAX_WORKERS + 1;
+    }
+
+    bench_data bench;
+    bench.values = hallocate(sizeof(f32) * element_count, MEMORY_TAG_ARRAY);
+
+    HINFO("jobbench: %u elements, %u iterations, %u processors.", element_count, JOB_BENCH_ITERATIONS, platform_get_processor_count());
+    HINFO("threads  parallel_for ms  speedup  small jobs/s");
+
+    f64 single_thread_ms = 0;
+    for (u32 threads = 1; threads <= max_threads; ++threads)
+    {
+        job_system_config config;
+        // The calling thread is the first participant.
+        config.worker_count = threads - 1;
+
+        u64 size = 0;
+        job_system_initialize(&size, 0, config);
+        void* state = hallocate(size, MEMORY_TAG_APPLICATION);
+        if (config.worker_count == 0)
+        {
+            // 0 means auto in the config, so a single thread runs the ranges directly.
+            hfree(state, size, MEMORY_TAG_APPLICATION);
+            state = 0;
+        }
+        else if (!job_system_initialize(&size, state, config))
+        {
+            hfree(state, size, MEMORY_TAG_APPLICATION);
+            hfree(bench.values, sizeof(f32) * element_count, MEMORY_TAG_ARRAY);
+            return 1;
+        }
+
+        // Warm up caches and wake the workers.
+        job_system_parallel_for(element_count, 0, bench_range, &bench);
+
+        u64 start = platform_get_ticks_ns();
+        for (u32 i = 0; i < JOB_BENCH_ITERATIONS; ++i)
+        {
+            job_system_parallel_for(element_count, 0, bench_range, &bench);
+        }
+        f64 parallel_ms = (platform_get_ticks_ns() - start) * 0.000001 / JOB_BENCH_ITERATIONS;
+
+        // Scheduling overhead with jobs that do almost nothing.
+        volatile u32 small_total = 0;
+        job_counter counter = {0};
+        start = platform_get_ticks_ns();
+        for (u32 i = 0; i < JOB_BENCH_SMALL_JOBS; ++i)
+        {
+            job_system_submit(bench_small_job, (void*)&small_total, &counter);
+        }
+        job_system_wait(&counter);
+        f64 small_seconds = (platform_get_ticks_ns() - start) * 0.000000001;
+
+        if (threads == 1)
+        {
+            single_thread_ms = parallel_ms;
+        }
+
+        HINFO("%7u  %15.3f  %7.2fx  %12.0f", threads, parallel_ms, parallel_ms > 0 ? single_thread_ms / parallel_ms : 0.0, small_seconds > 0 ? JOB_BENCH_SMALL_JOBS / small_seconds : 0.0);
+
+        if (state)
+        {
+            job_system_shutdown(state);
+            hfree(state, size, MEMORY_TAG_APPLICATION);
+        }
+    }
+
+    hfree(bench.values, sizeof(f32) * element_count, MEMORY_TAG_ARRAY);
+
+    return 0;
+}
\ No newline at end of file
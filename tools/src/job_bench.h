@@ -0,0 +1,9 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Times the job system with 1 to N threads and reports the speedup over one thread.
+ * argv: [max_threads] [element_count]
+ */
+i32 job_bench_run(i32 argc, char** argv);
\ No newline at end of file
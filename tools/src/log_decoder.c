@@ -0,0 +1,417 @@
+#include "log_decoder.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+#include <core/binary_log.h>
+
+#include <containers/list.h>
+
+#include <memory/hmemory.h>
+
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DECODED_LINE_MAX_LENGTH 8192
+
+typedef struct decoded_format
+{
+    const char* format;
+    i32 arg_count;
+    u8 arg_kinds[BINARY_LOG_MAX_ARGS];
+} decoded_format;
+
+typedef struct decoded_record
+{
+    u64 timestamp;
+    u64 offset;
+} decoded_record;
+
+typedef struct decoder_state
+{
+    const u8* data;
+    u64 size;
+    decoded_format* formats;
+    u32 format_count;
+    decoded_record* records;
+} decoder_state;
+
+HINLINE u16 read_u16(const u8* p)
+{
+    u16 value;
+    memcpy(&value, p, sizeof(u16));
+    return value;
+}
+
+HINLINE u32 read_u32(const u8* p)
+{
+    u32 value;
+    memcpy(&value, p, sizeof(u32));
+    return value;
+}
+
+HINLINE u64 read_u64(const u8* p)
+{
+    u64 value;
+    memcpy(&value, p, sizeof(u64));
+    return value;
+}
+
+static i32 compare_records(const void* a, const void* b)
+{
+    const decoded_record* ra = a;
+    const decoded_record* rb = b;
+
+    if (ra->timestamp != rb->timestamp) return ra->timestamp < rb->timestamp ? -1 : 1;
+    if (ra->offset != rb->offset) return ra->offset < rb->offset ? -1 : 1;
+    return 0;
+}
+
+// Returns the size of the record at offset, or 0 if it is truncated or unknown.
+static u64 record_size(decoder_state* state, u64 offset)
+{
+    const u8* p = state->data + offset;
+    u64 remaining = state->size - offset;
+
+    switch (p[0])
+    {
+        case BINARY_LOG_RECORD_FORMAT:
+            if (remaining < 7) return 0;
+            return 7 + read_u16(p + 5) <= remaining ? 7 + read_u16(p + 5) : 0;
+        case BINARY_LOG_RECORD_MESSAGE:
+            if (remaining < 16) return 0;
+            return 16 + read_u16(p + 14) <= remaining ? 16 + read_u16(p + 14) : 0;
+        case BINARY_LOG_RECORD_TEXT:
+            if (remaining < 12) return 0;
+            return 12 + read_u16(p + 10) <= remaining ? 12 + read_u16(p + 10) : 0;
+    }
+
+    return 0;
+}
+
+static b8 index_records(decoder_state* state)
+{
+    u32 max_id = 0;
+    b8 has_formats = FALSE;
+
+    u64 offset = sizeof(binary_log_file_header);
+    while (offset < state->size)
+    {
+        u64 size = record_size(state, offset);
+        if (!size)
+        {
+            HWARN("Truncated or unknown record at offset %llu, ignoring the rest of the file.", offset);
+            state->size = offset;
+            break;
+        }
+
+        const u8* p = state->data + offset;
+        if (p[0] == BINARY_LOG_RECORD_FORMAT)
+        {
+            u32 id = read_u32(p + 1);
+            max_id = id > max_id ? id : max_id;
+            has_formats = TRUE;
+        }
+        else
+        {
+            decoded_record record;
+            record.timestamp = read_u64(p + (p[0] == BINARY_LOG_RECORD_MESSAGE ? 6 : 2));
+            record.offset = offset;
+            list_push(state->records, record);
+        }
+
+        offset += size;
+    }
+
+    // Format records may come from another thread's buffer that was flushed later, so collect them first.
+    state->format_count = has_formats ? max_id + 1 : 0;
+    if (state->format_count)
+    {
+        state->formats = hallocate(sizeof(decoded_format) * state->format_count, MEMORY_TAG_ARRAY);
+    }
+
+    offset = sizeof(binary_log_file_header);
+    while (offset < state->size)
+    {
+        const u8* p = state->data + offset;
+        if (p[0] == BINARY_LOG_RECORD_FORMAT)
+        {
+            decoded_format* f = &state->formats[read_u32(p + 1)];
+            f->format = (const char*)(p + 7);
+            f->arg_count = binary_log_parse_format(f->format, f->arg_kinds);
+        }
+
+        offset += record_size(state, offset);
+    }
+
+    qsort(state->records, list_count(state->records), sizeof(decoded_record), compare_records);
+
+    return TRUE;
+}
+
+static u64 render_message(const decoded_format* f, const u8* args, u16 arg_size, char* out, u64 out_size)
+{
+    const u8* arg = args;
+    const u8* args_end = args + arg_size;
+    i32 kind_index = 0;
+
+    char* cursor = out;
+    char* end = out + out_size - 1;
+
+    const char* c = f->format;
+    while (*c && cursor < end)
+    {
+        if (*c != '%')
+        {
+            *cursor++ = *c++;
+            continue;
+        }
+
+        if (c[1] == '%')
+        {
+            *cursor++ = '%';
+            c += 2;
+            continue;
+        }
+
+        // Rebuild the conversion spec, normalizing 64-bit integer lengths to 'll'.
+        char spec[64];
+        u32 spec_length = 0;
+        spec[spec_length++] = *c++;
+
+        i32 stars[2] = {0, 0};
+        u32 star_count = 0;
+        while (*c && spec_length < sizeof(spec) - 4)
+        {
+            char ch = *c;
+            if (ch == '*')
+            {
+                if (star_count < 2 && arg + sizeof(u32) <= args_end)
+                {
+                    stars[star_count++] = (i32)read_u32(arg);
+                    arg += sizeof(u32);
+                    kind_index++;
+                }
+                spec[spec_length++] = ch;
+                c++;
+                continue;
+            }
+
+            if (ch == 'h' || ch == 'l' || ch == 'j' || ch == 'z' || ch == 't' || ch == 'L')
+            {
+                spec[spec_length++] = ch;
+                c++;
+                continue;
+            }
+
+            if ((ch >= '0' && ch <= '9') || ch == '.' || ch == '-' || ch == '+' || ch == ' ' || ch == '#')
+            {
+                spec[spec_length++] = ch;
+                c++;
+                continue;
+            }
+
+            break;
+        }
+
+        char conversion = *c;
+        if (!conversion) break;
+        c++;
+
+        if (kind_index >= f->arg_count) break;
+        u8 kind = f->arg_kinds[kind_index++];
+
+        if (kind == BINARY_LOG_ARG_LONG || kind == BINARY_LOG_ARG_LONG_LONG || kind == BINARY_LOG_ARG_SIZE)
+        {
+            while (spec_length > 1 && (spec[spec_length - 1] == 'l' || spec[spec_length - 1] == 'j' || spec[spec_length - 1] == 'z' || spec[spec_length - 1] == 't'))
+            {
+                spec_length--;
+            }
+            spec[spec_length++] = 'l';
+            spec[spec_length++] = 'l';
+        }
+        spec[spec_length++] = conversion;
+        spec[spec_length] = 0;
+
+        u64 remaining = end - cursor + 1;
+        i32 written = 0;
+
+#define FORMAT_VALUE(value)                                                                         \
+        written = star_count == 0 ? snprintf(cursor, remaining, spec, value) :                      \
+                  star_count == 1 ? snprintf(cursor, remaining, spec, stars[0], value) :            \
+                                    snprintf(cursor, remaining, spec, stars[0], stars[1], value)
+
+        switch (kind)
+        {
+            case BINARY_LOG_ARG_INT:
+                if (arg + sizeof(u32) > args_end) return cursor - out;
+                FORMAT_VALUE((i32)read_u32(arg));
+                arg += sizeof(u32);
+                break;
+            case BINARY_LOG_ARG_LONG:
+            case BINARY_LOG_ARG_LONG_LONG:
+            case BINARY_LOG_ARG_SIZE:
+                if (arg + sizeof(u64) > args_end) return cursor - out;
+                FORMAT_VALUE((long long)read_u64(arg));
+                arg += sizeof(u64);
+                break;
+            case BINARY_LOG_ARG_DOUBLE:
+            {
+                if (arg + sizeof(f64) > args_end) return cursor - out;
+                f64 value;
+                memcpy(&value, arg, sizeof(f64));
+                FORMAT_VALUE(value);
+                arg += sizeof(f64);
+            } break;
+            case BINARY_LOG_ARG_POINTER:
+                if (arg + sizeof(u64) > args_end) return cursor - out;
+                FORMAT_VALUE((void*)read_u64(arg));
+                arg += sizeof(u64);
+                break;
+            case BINARY_LOG_ARG_STRING:
+            {
+                if (arg + sizeof(u16) > args_end) return cursor - out;
+                u16 length = read_u16(arg);
+                arg += sizeof(u16);
+                if (arg + length > args_end) return cursor - out;
+
+                char str[BINARY_LOG_MAX_STRING_LENGTH + 1];
+                memcpy(str, arg, length);
+                str[length] = 0;
+                FORMAT_VALUE(str);
+                arg += length;
+            } break;
+        }
+
+#undef FORMAT_VALUE
+
+        if (written < 0) break;
+        cursor += (u64)written < remaining ? (u64)written : remaining - 1;
+    }
+
+    *cursor = 0;
+    return cursor - out;
+}
+
+static void emit_line(file_handle* out_file, const char* line)
+{
+    if (out_file->is_valid)
+    {
+        u64 written = 0;
+        filesystem_write(out_file, string_length(line), line, &written);
+    }
+    else
+    {
+        fputs(line, stdout);
+    }
+}
+
+i32 log_decoder_run(i32 argc, char** argv)
+{
+    if (argc < 1)
+    {
+        HERROR("logdecode requires an input file.");
+        return 1;
+    }
+
+    file_handle in_file;
+    if (!filesystem_open(argv[0], FILE_MODE_READ, TRUE, &in_file))
+    {
+        return 1;
+    }
+
+    decoder_state state = {};
+    filesystem_size(&in_file, &state.size);
+
+    u8* data = hallocate(state.size ? state.size : 1, MEMORY_TAG_ARRAY);
+    u64 read_size = 0;
+    b8 read_ok = filesystem_read_all_bytes(&in_file, data, &read_size);
+    filesystem_close(&in_file);
+
+    if (!read_ok || state.size < sizeof(binary_log_file_header))
+    {
+        HERROR("Unable to read binary log '%s'.", argv[0]);
+        hfree(data, state.size ? state.size : 1, MEMORY_TAG_ARRAY);
+        return 1;
+    }
+
+    u64 data_size = state.size;
+    state.data = data;
+
+    binary_log_file_header header;
+    hcopy_memory(&header, data, sizeof(binary_log_file_header));
+    if (header.magic != BINARY_LOG_MAGIC || header.version != BINARY_LOG_VERSION)
+    {
+        HERROR("'%s' is not a binary log this decoder understands (magic 0x%08X, version %u).", argv[0], header.magic, header.version);
+        hfree(data, data_size, MEMORY_TAG_ARRAY);
+        return 1;
+    }
+
+    file_handle out_file = {};
+    if (argc >= 2 && !filesystem_open(argv[1], FILE_MODE_WRITE, FALSE, &out_file))
+    {
+        hfree(data, data_size, MEMORY_TAG_ARRAY);
+        return 1;
+    }
+
+    state.records = list_create(decoded_record);
+    index_records(&state);
+
+    u64 record_count = list_count(state.records);
+    u64 first_timestamp = record_count ? state.records[0].timestamp : 0;
+
+    char message[DECODED_LINE_MAX_LENGTH];
+    char line[DECODED_LINE_MAX_LENGTH + 64];
+    for (u64 i = 0; i < record_count; ++i)
+    {
+        const u8* p = state.data + state.records[i].offset;
+        u8 level;
+
+        if (p[0] == BINARY_LOG_RECORD_MESSAGE)
+        {
+            u32 id = read_u32(p + 1);
+            level = p[5];
+
+            if (id >= state.format_count || !state.formats[id].format)
+            {
+                string_format(message, "<missing format %u>", id);
+            }
+            else if (state.formats[id].arg_count < 0)
+            {
+                string_format(message, "<unsupported format '%s'>", state.formats[id].format);
+            }
+            else
+            {
+                render_message(&state.formats[id], p + 16, read_u16(p + 14), message, DECODED_LINE_MAX_LENGTH);
+            }
+        }
+        else
+        {
+            level = p[1];
+            string_ncopy(message, (const char*)(p + 12), DECODED_LINE_MAX_LENGTH - 1);
+            message[DECODED_LINE_MAX_LENGTH - 1] = 0;
+        }
+
+        f64 seconds = (state.records[i].timestamp - first_timestamp) * 0.000000001;
+        snprintf(line, sizeof(line), "[%12.6f] %s %s\n", seconds, logger_level_string((log_level)level), message);
+        emit_line(&out_file, line);
+    }
+
+    HINFO("Decoded %llu records using %u formats.", record_count, state.format_count);
+
+    if (out_file.is_valid)
+    {
+        filesystem_close(&out_file);
+    }
+
+    list_destroy(state.records);
+    if (state.formats)
+    {
+        hfree(state.formats, sizeof(decoded_format) * state.format_count, MEMORY_TAG_ARRAY);
+    }
+    hfree(data, data_size, MEMORY_TAG_ARRAY);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <defines.h>
+
+i32 log_decoder_run(i32 argc, char** argv);
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "log_decoder.h"
+#include "job_bench.h"
+#include "pack.h"
+#include "io_bench.h"
+#include "cook.h"
+
+#include <defines.h>
+
+#include <core/logger.h>
+#include <core/hstring.h>
+
+typedef struct tool_command
+{
+    const char* name;
+    const char* usage;
+    i32 (*run)(i32 argc, char** argv);
+} tool_command;
+
+static const tool_command commands[] =
+{
+    {"logdecode", "logdecode <input.hlog> [output.log]", log_decoder_run},
+    {"jobbench", "jobbench [max_threads] [element_count]", job_bench_run},
+    {"pack", "pack <asset_dir> <output.hpak>", pack_run},
+    {"iobench", "iobench <asset_dir> [queue_depth]", io_bench_run},
+    {"cook", "cook <asset_dir> <cache_dir> [--no-mips]", cook_run}
+};
+
+#define COMMAND_COUNT (sizeof(commands) / sizeof(tool_command))
+
+int main(int argc, char** argv)
+{
+    if (argc >= 2)
+    {
+        for (u32 i = 0; i < COMMAND_COUNT; ++i)
+        {
+            if (strings_equali(argv[1], commands[i].name))
+            {
+                return commands[i].run(argc - 2, argv + 2);
+            }
+        }
+
+        HERROR("Unknown command '%s'.", argv[1]);
+    }
+
+    HINFO("Usage: tools <command> [arguments]");
+    for (u32 i = 0; i < COMMAND_COUNT; ++i)
+    {
+        HINFO("    %s", commands[i].usage);
+    }
+
+    return 1;
+}
\ No newline at end of file
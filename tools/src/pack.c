@@ -0,0 +1,62 @@
+#include "pack.h"
+#include "asset_walk.h"
+
+#include <core/logger.h>
+#include <core/hstring.h>
+
+#include <containers/list.h>
+
+#include <memory/hmemory.h>
+
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+
+#include <resources/hpak.h>
+
+i32 pack_run(i32 argc, char** argv)
+{
+    if (argc < 2)
+    {
+        HERROR("pack requires an asset directory and an output file.");
+        return 1;
+    }
+
+    u64 start_ns = platform_get_ticks_ns();
+
+    // Archives lying among the assets are not packed into each other.
+    asset_file* files = 0;
+    if (!asset_walk(argv[0], ".hpak", &files))
+    {
+        return 1;
+    }
+
+    u32 count = (u32)list_count(files);
+    u64 sources_size = sizeof(hpak_source) * (count ? count : 1);
+    hpak_source* sources = hallocate(sources_size, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < count; ++i)
+    {
+        sources[i].name = files[i].name;
+        sources[i].path = files[i].path;
+    }
+
+    b8 written = hpak_write(argv[1], count, sources);
+
+    hfree(sources, sources_size, MEMORY_TAG_ARRAY);
+    list_destroy(files);
+
+    if (!written)
+    {
+        return 1;
+    }
+
+    file_handle out;
+    u64 size = 0;
+    if (filesystem_open(argv[1], FILE_MODE_READ, TRUE, &out))
+    {
+        filesystem_size(&out, &size);
+        filesystem_close(&out);
+    }
+
+    HINFO("Packed %u files from '%s' into '%s', %.1f KiB in %.2fms.", count, argv[0], argv[1], size / 1024.0, (platform_get_ticks_ns() - start_ns) * 0.000001);
+    return 0;
+}
\ No newline at end of file